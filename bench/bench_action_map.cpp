@@ -0,0 +1,45 @@
+#include <array>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  //A few hundred bindings across contexts, most of which the benchmark events never touch
+  rp::input::ActionMap makeActionMap() {
+    std::string config = "action Jump = Space\naction Save = LeftCtrl+S\naxis MoveX = A -1, D 1\n";
+    for(int context = 0; context < 16; context++) {
+      config += fmt::format("context ctx{}\n", context);
+      for(int key = 0; key < 12; key++) {
+        config += fmt::format("action Ability{}_{} = F{}, Num{}\n", context, key, key + 1, key % 10);
+      }
+    }
+    return rp::input::ActionMap::Parse(config);
+  }
+}
+
+RP_BENCHMARK("input/action_map_events") {
+  using Key = rp::input::Keyboard::Key;
+  auto actions = makeActionMap();
+  const auto jump = actions.getAction("Jump");
+
+  std::array<rp::Event, 6> events;
+  const std::array<std::pair<rp::Event::Type, Key>, 6> inputs = {{
+    {rp::Event::Type::KeyPressed, Key::Space}, {rp::Event::Type::KeyPressed, Key::D},
+    {rp::Event::Type::KeyPressed, Key::F5}, {rp::Event::Type::KeyReleased, Key::F5},
+    {rp::Event::Type::KeyReleased, Key::D}, {rp::Event::Type::KeyReleased, Key::Space},
+  }};
+  for(size_t i = 0; i < events.size(); i++) {
+    events[i].type = inputs[i].first;
+    events[i].key_code = inputs[i].second;
+  }
+
+  state.setItemsPerIteration(events.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(const auto& e : events) {
+      actions.onEvent(e);
+    }
+    rp::bench::doNotOptimize(actions.wasPressed(jump));
+    actions.nextFrame();
+  }
+}
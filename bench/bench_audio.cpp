@@ -0,0 +1,153 @@
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <rapier.hpp>
+#include <audio/adpcm.hpp>
+#include <audio/wav.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using namespace rp::audio;
+
+  constexpr uint32_t sample_rate = 48000;
+  constexpr uint32_t block_frames = 512;
+  constexpr uint32_t adpcm_block_align = 1024;
+
+  std::vector<int16_t> makeTone(uint32_t channels, uint32_t frames, float frequency) {
+    std::vector<int16_t> samples(size_t{channels} * frames);
+    for(uint32_t i = 0; i < frames; i++) {
+      const float value = std::sin(6.2831853f * frequency * static_cast<float>(i) / sample_rate);
+      for(uint32_t c = 0; c < channels; c++) {
+        samples[size_t{i} * channels + c] = static_cast<int16_t>(value * 12000.0f);
+      }
+    }
+    return samples;
+  }
+
+  Sound makeSound(uint32_t channels, uint32_t rate, float frequency) {
+    const auto tone = makeTone(channels, rate, frequency);
+    std::vector<float> samples(tone.size());
+    for(size_t i = 0; i < tone.size(); i++) {
+      samples[i] = static_cast<float>(tone[i]) / 32768.0f;
+    }
+    return Sound::FromSamples(std::move(samples), channels, rate);
+  }
+
+  //Two seconds of IMA ADPCM stereo
+  const std::vector<std::byte>& getAdpcmWav() {
+    static const std::vector<std::byte> wav = [] {
+      const auto tone = makeTone(2, sample_rate * 2, 330.0f);
+      const auto blocks = adpcm::encode(tone, 2, adpcm_block_align);
+      WavInfo info;
+      info.encoding = Encoding::ImaAdpcm;
+      info.sample_rate = sample_rate;
+      info.channels = 2;
+      info.block_align = adpcm_block_align;
+      info.frames_per_block = adpcm::getSamplesPerBlock(adpcm_block_align, 2);
+      info.frame_count = sample_rate * 2;
+      info.data = blocks;
+      return makeWav(info);
+    }();
+    return wav;
+  }
+
+  void play(Mixer& mixer, uint32_t slot, const SoundData* sound, StreamSource* stream, float pitch) {
+    MixCommand command;
+    command.type = MixCommand::Type::Play;
+    command.target = slot;
+    command.sound = sound;
+    command.stream = stream;
+    command.params.loop = true;
+    command.params.pitch = pitch;
+    command.params.pan = static_cast<float>(slot % 9) / 4.0f - 1.0f;
+    mixer.submit(command);
+  }
+
+  //Voices loop, so the voice count holds steady for the whole run. Mixers are built once and
+  //reused across repetitions, so each iteration measures one block and none of the setup.
+  struct Scene {
+    std::vector<Sound> sounds;
+    std::vector<std::unique_ptr<StreamSource>> streams;
+    std::unique_ptr<Mixer> mixer;
+  };
+
+  Scene& getMixScene(uint32_t voices, float pitch, bool lowpass) {
+    static std::map<std::pair<uint32_t, bool>, Scene> scenes;
+    Scene& scene = scenes[{voices, lowpass}];
+    if(scene.mixer) {
+      return scene;
+    }
+
+    scene.sounds = {makeSound(1, 44100, 440.0f), makeSound(2, 44100, 220.0f)};
+    scene.mixer = std::make_unique<Mixer>(sample_rate, block_frames, voices);
+    for(uint32_t i = 0; i < voices; i++) {
+      play(*scene.mixer, i, scene.sounds[i % 2].getData().get(), nullptr, pitch + 0.01f * static_cast<float>(i % 5));
+    }
+    if(lowpass) {
+      MixCommand command;
+      command.type = MixCommand::Type::SetBusLowpass;
+      command.target = static_cast<uint32_t>(Bus::Effects);
+      command.value = 2000.0f;
+      scene.mixer->submit(command);
+    }
+    return scene;
+  }
+
+  Scene& getStreamScene(uint32_t streams) {
+    static std::map<uint32_t, Scene> scenes;
+    Scene& scene = scenes[streams];
+    if(scene.mixer) {
+      return scene;
+    }
+
+    const auto& wav = getAdpcmWav();
+    scene.mixer = std::make_unique<Mixer>(sample_rate, block_frames, streams);
+    for(uint32_t i = 0; i < streams; i++) {
+      scene.streams.push_back(std::make_unique<StreamSource>(nullptr, wav, sample_rate / 4, true));
+      scene.streams.back()->decodeAhead();
+      play(*scene.mixer, i, nullptr, scene.streams.back().get(), 1.0f);
+    }
+    return scene;
+  }
+
+  void benchMix(rp::bench::State& state, Scene& scene) {
+    std::vector<int16_t> out(size_t{block_frames} * 2);
+    state.setItemsPerIteration(block_frames);
+    for(uint64_t i = 0; i < state.iterations(); i++) {
+      //decoding runs on its own thread in the engine, here it is counted as part of each block
+      for(auto& stream : scene.streams) {
+        stream->decodeAhead();
+      }
+      scene.mixer->mix(out);
+    }
+    rp::bench::doNotOptimize(out[0]);
+  }
+}
+
+RP_BENCHMARK("audio/mix_64_voices") {
+  benchMix(state, getMixScene(64, 1.0f, false));
+}
+
+RP_BENCHMARK("audio/mix_256_voices_resampled") {
+  benchMix(state, getMixScene(256, 1.1f, true));
+}
+
+RP_BENCHMARK("audio/mix_32_adpcm_streams") {
+  benchMix(state, getStreamScene(32));
+}
+
+RP_BENCHMARK("audio/adpcm_decode_block") {
+  const auto& wav = getAdpcmWav();
+  const WavInfo info = parseWav(wav);
+  std::vector<int16_t> out(size_t{info.frames_per_block} * info.channels);
+  const size_t block_count = info.data.size() / info.block_align;
+  state.setItemsPerIteration(info.frames_per_block);
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    const auto block = info.data.subspan((i % block_count) * info.block_align, info.block_align);
+    rp::bench::doNotOptimize(adpcm::decodeBlock(block, info.channels, out));
+  }
+  rp::bench::doNotOptimize(out[0]);
+}
@@ -0,0 +1,101 @@
+#include <array>
+
+#include <fmt/format.h>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  //Window without an OS window behind it, so dispatch can be driven directly
+  class BenchWindow : public rp::Window {
+  public:
+    BenchWindow() : Window({"bench", 1, 1}) {}
+
+    bool processMessages() override { return true; }
+
+    void dispatch(const rp::Event& e) {
+      if(mCallback) mCallback(e);
+    }
+  };
+
+  struct BenchScored {
+    static constexpr uint16_t event_id = rp::Event::user_type_base + 900;
+    static constexpr const char* event_name = "BenchScored";
+    int points;
+  };
+
+  std::array<rp::Event, 4> makeEvents() {
+    std::array<rp::Event, 4> events;
+    events[0].type = rp::Event::Type::KeyPressed;
+    events[0].key_code = rp::input::Keyboard::Key::W;
+    events[1].type = rp::Event::Type::MouseMoved;
+    events[1].mouse.position = {100, 200};
+    events[2].type = rp::Event::Type::MouseButtonPressed;
+    events[2].mouse.button = rp::input::Mouse::Left;
+    events[3].type = rp::Event::Type::MouseWheelScrolled;
+    events[3].mouse.scroll = 120;
+    return events;
+  }
+}
+
+RP_BENCHMARK("event/dispatch_callback") {
+  BenchWindow window;
+  uint64_t handled = 0;
+  window.setCallback([&](const rp::Event& e) { handled += static_cast<uint64_t>(e.type); });
+
+  const auto events = makeEvents();
+  state.setItemsPerIteration(events.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(const auto& e : events) {
+      window.dispatch(e);
+    }
+  }
+  rp::bench::doNotOptimize(handled);
+}
+
+RP_BENCHMARK("event/format") {
+  const auto events = makeEvents();
+  fmt::memory_buffer buffer;
+  state.setItemsPerIteration(events.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(const auto& e : events) {
+      buffer.clear();
+      fmt::format_to(std::back_inserter(buffer), "{}", e);
+    }
+    rp::bench::doNotOptimize(buffer);
+  }
+}
+
+RP_REGISTER_EVENT(BenchScored);
+
+RP_BENCHMARK("event/queue_push_drain") {
+  const auto events = makeEvents();
+  rp::EventQueue queue;
+  std::vector<rp::Event> drained;
+  uint64_t handled = 0;
+
+  state.setItemsPerIteration(events.size() + 1);
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(const auto& e : events) {
+      queue.push(e);
+    }
+    queue.post(BenchScored{static_cast<int>(i)});
+
+    queue.drain(drained);
+    for(const auto& e : drained) {
+      handled += static_cast<uint16_t>(e.type);
+    }
+  }
+  rp::bench::doNotOptimize(handled);
+}
+
+RP_BENCHMARK("event/format_user") {
+  const auto event = rp::Event::Make(BenchScored{7});
+  fmt::memory_buffer buffer;
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    buffer.clear();
+    fmt::format_to(std::back_inserter(buffer), "{}", event);
+    rp::bench::doNotOptimize(buffer);
+  }
+}
@@ -0,0 +1,46 @@
+#include <array>
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include <platform/win32_keyboard.hpp>
+
+#include "harness.hpp"
+
+RP_BENCHMARK("keyboard/translate_win32") {
+  constexpr std::array<WPARAM, 16> key_codes = {
+    'W', 'A', 'S', 'D', VK_SPACE, VK_SHIFT, VK_CONTROL, VK_ESCAPE,
+    VK_F1, VK_NUMPAD5, VK_OEM_COMMA, '7', VK_LEFT, VK_RETURN, VK_TAB, 'Q'
+  };
+
+  state.setItemsPerIteration(key_codes.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(auto key_code : key_codes) {
+      auto key = rp::input::translateWin32KeyCode(key_code, 0);
+      rp::bench::doNotOptimize(key);
+    }
+  }
+}
+
+RP_BENCHMARK("keyboard/key_name") {
+  using Key = rp::input::Keyboard::Key;
+  state.setItemsPerIteration(INDEX_CAST(Key::ENUM_SIZE));
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(size_t key = 0; key < INDEX_CAST(Key::ENUM_SIZE); key++) {
+      auto name = rp::input::Keyboard::GetKeyName(static_cast<Key>(key));
+      rp::bench::doNotOptimize(name);
+    }
+  }
+}
+
+RP_BENCHMARK("keyboard/from_name") {
+  using Key = rp::input::Keyboard::Key;
+  state.setItemsPerIteration(INDEX_CAST(Key::ENUM_SIZE));
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    for(size_t key = 0; key < INDEX_CAST(Key::ENUM_SIZE); key++) {
+      auto found = rp::input::Keyboard::FromName(rp::input::Keyboard::GetKeyName(static_cast<Key>(key)));
+      rp::bench::doNotOptimize(found);
+    }
+  }
+}
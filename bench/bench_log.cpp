@@ -0,0 +1,50 @@
+#include <cstdio>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  //Writes to the null device so the benchmark measures formatting, not the console
+  struct NullLogOutput {
+    NullLogOutput() {
+#if defined(_WIN32)
+      file = std::fopen("NUL", "w");
+#else
+      file = std::fopen("/dev/null", "w");
+#endif
+      rp::log::setOutput(file);
+    }
+
+    ~NullLogOutput() {
+      rp::log::setOutput(stdout);
+      std::fclose(file);
+    }
+
+    std::FILE* file;
+  };
+}
+
+RP_BENCHMARK("log/plain") {
+  NullLogOutput null_output;
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    rp::log::info("Frame finished");
+  }
+}
+
+RP_BENCHMARK("log/format_args") {
+  NullLogOutput null_output;
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    rp::log::info("Frame {} took {:.3f} ms ({} draw calls)", i, 16.6667, 1234);
+  }
+}
+
+RP_BENCHMARK("log/format_event") {
+  NullLogOutput null_output;
+  rp::Event event;
+  event.type = rp::Event::Type::MouseMoved;
+  event.mouse.position = {640, 360};
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    rp::log::trace("Event: {}", event);
+  }
+}
@@ -0,0 +1,84 @@
+#include <array>
+#include <cmath>
+#include <map>
+#include <memory>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using namespace rp::physics;
+
+  //A box of mixed circles, boxes and triangles dropped onto each other.
+  //Scenes are built once and stepped a little before measuring, so each benchmark
+  //iteration is one step of a scene that is already in contact.
+  World& getScene(size_t body_count, BroadphaseType broadphase) {
+    static std::map<std::pair<size_t, BroadphaseType>, std::unique_ptr<World>> scenes;
+    auto& scene = scenes[{body_count, broadphase}];
+    if(scene) {
+      return *scene;
+    }
+
+    WorldDef def;
+    def.broadphase = broadphase;
+    def.autoStep = false;
+    scene = std::make_unique<World>(def);
+
+    const auto columns = static_cast<size_t>(std::sqrt(static_cast<double>(body_count) * 2.0));
+    const float half_width = static_cast<float>(columns) * 0.55f + 1.0f;
+    const float height = static_cast<float>(body_count / columns + 1) * 1.1f + 2.0f;
+
+    BodyDef wall;
+    wall.type = BodyType::Static;
+    wall.shape = Shape::Box(half_width + 1.0f, 1.0f);
+    wall.position = {0.0f, -1.0f};
+    scene->createBody(wall);
+    wall.shape = Shape::Box(1.0f, height);
+    wall.position = {-half_width, height};
+    scene->createBody(wall);
+    wall.position = {half_width, height};
+    scene->createBody(wall);
+
+    const std::array<Vec2, 3> triangle{{{-0.45f, -0.4f}, {0.45f, -0.4f}, {0.0f, 0.45f}}};
+    const std::array<Shape, 3> shapes{Shape::Circle(0.45f), Shape::Box(0.4f, 0.4f), Shape::Convex(triangle)};
+    for(size_t i = 0; i < body_count; i++) {
+      BodyDef body;
+      body.shape = shapes[i % shapes.size()];
+      body.position = {-half_width + 1.6f + static_cast<float>(i % columns) * 1.1f + 0.05f * static_cast<float>((i / columns) % 3),
+                       0.6f + static_cast<float>(i / columns) * 1.1f};
+      body.angle = 0.1f * static_cast<float>(i % 7);
+      scene->createBody(body);
+    }
+
+    for(int i = 0; i < 30; i++) {
+      scene->step(1.0f / 60.0f);
+    }
+    return *scene;
+  }
+
+  void benchStep(rp::bench::State& state, size_t body_count, BroadphaseType broadphase) {
+    World& world = getScene(body_count, broadphase);
+    state.setItemsPerIteration(body_count);
+    for(uint64_t i = 0; i < state.iterations(); i++) {
+      world.step(1.0f / 60.0f);
+    }
+    rp::bench::doNotOptimize(world.getStats().contact_count);
+  }
+}
+
+RP_BENCHMARK("physics/step_10k_tree") {
+  benchStep(state, 10'000, BroadphaseType::DynamicTree);
+}
+
+RP_BENCHMARK("physics/step_10k_grid") {
+  benchStep(state, 10'000, BroadphaseType::UniformGrid);
+}
+
+RP_BENCHMARK("physics/step_100k_tree") {
+  benchStep(state, 100'000, BroadphaseType::DynamicTree);
+}
+
+RP_BENCHMARK("physics/step_100k_grid") {
+  benchStep(state, 100'000, BroadphaseType::UniformGrid);
+}
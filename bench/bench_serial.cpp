@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  struct Transform {
+    float x, y, z;
+    float rotation;
+    float scale;
+    uint32_t parent;
+    RP_REFLECT(Transform, x, y, z, rotation, scale, parent)
+  };
+
+  struct Component {
+    std::string type;
+    std::vector<float> values;
+    RP_REFLECT(Component, type, values)
+  };
+
+  struct Chunk {
+    rp::UUID id;
+    std::string name;
+    std::vector<Transform> transforms;
+    std::vector<Component> components;
+    RP_REFLECT(Chunk, id, name, transforms, components)
+  };
+
+  constexpr size_t chunk_count = 256;
+  constexpr size_t transforms_per_chunk = 10'000;  //about 60 MiB of transforms in total
+  constexpr size_t components_per_chunk = 64;
+
+  const std::vector<Chunk>& getChunks() {
+    static const std::vector<Chunk> chunks = [] {
+      std::vector<Chunk> result(chunk_count);
+      for(size_t c = 0; c < chunk_count; c++) {
+        Chunk& chunk = result[c];
+        chunk.id = rp::UUID::FromName("chunk" + std::to_string(c));
+        chunk.name = "chunk " + std::to_string(c);
+        chunk.transforms.resize(transforms_per_chunk);
+        for(size_t i = 0; i < transforms_per_chunk; i++) {
+          chunk.transforms[i] = {static_cast<float>(i), static_cast<float>(c), 0.0f, 0.5f, 1.0f, static_cast<uint32_t>(i / 2)};
+        }
+        for(size_t i = 0; i < components_per_chunk; i++) {
+          chunk.components.push_back({"component" + std::to_string(i % 8), std::vector<float>(16, static_cast<float>(i))});
+        }
+      }
+      return result;
+    }();
+    return chunks;
+  }
+
+  uint64_t getSceneBytes() {
+    return chunk_count * transforms_per_chunk * sizeof(Transform);
+  }
+
+  const std::filesystem::path& getScenePath() {
+    static const std::filesystem::path path = std::filesystem::temp_directory_path() / "rapier_bench.rpscene";
+    return path;
+  }
+
+  void saveScene() {
+    rp::serial::SceneWriter writer(getScenePath());
+    for(const auto& chunk : getChunks()) {
+      writer.add(chunk.id, chunk);
+    }
+    writer.finish();
+  }
+
+  //The load benchmarks share one saved file, written the first time it's needed
+  const std::filesystem::path& getSavedScene() {
+    static bool saved = false;
+    if(!saved) {
+      saveScene();
+      saved = true;
+    }
+    return getScenePath();
+  }
+}
+
+RP_BENCHMARK("serial/save_scene") {
+  state.setItemsPerIteration(getSceneBytes());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    saveScene();
+  }
+}
+
+RP_BENCHMARK("serial/load_scene") {
+  const auto& path = getSavedScene();
+  state.setItemsPerIteration(getSceneBytes());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    rp::serial::SceneReader reader(path);
+    Chunk chunk;
+    for(const auto& object : reader.objects()) {
+      reader.load(object, chunk);
+      rp::bench::doNotOptimize(chunk.transforms.back().parent);
+    }
+  }
+}
+
+RP_BENCHMARK("serial/load_one_object") {
+  rp::serial::SceneReader reader(getSavedScene());
+  const rp::UUID id = getChunks()[chunk_count / 2].id;
+  state.setItemsPerIteration(transforms_per_chunk * sizeof(Transform));
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    auto chunk = reader.load<Chunk>(id);
+    rp::bench::doNotOptimize(chunk.transforms.back().parent);
+  }
+}
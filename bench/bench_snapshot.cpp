@@ -0,0 +1,64 @@
+#include <vector>
+
+#include <rapier.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using namespace rp::snapshot;
+
+  //4 MiB of state where a simulation step touches about 1% of it
+  struct Particle {
+    float x, y, vx, vy;
+  };
+  constexpr size_t particle_count = 256 * 1024;
+  constexpr size_t touched_per_step = particle_count / 100;
+
+  //Every byte step() depends on is registered, so a rollback replays the recorded frames exactly
+  struct Scene {
+    std::vector<Particle> particles = std::vector<Particle>(particle_count);
+    uint64_t cursor = 0;
+
+    void step() {
+      for(size_t i = 0; i < touched_per_step; i++) {
+        Particle& p = particles[(cursor * 7919) % particle_count];
+        p.x += p.vx + 1.0f;
+        p.y += p.vy;
+        cursor++;
+      }
+    }
+  };
+}
+
+RP_BENCHMARK("snapshot/capture_4mb_1pct_changed") {
+  Scene scene;
+  SnapshotBuffer snapshots(8);
+  snapshots.addPool("particles", scene.particles);
+  snapshots.addRegion("cursor", &scene.cursor, sizeof(scene.cursor));
+  snapshots.capture();
+  state.setItemsPerIteration(particle_count * sizeof(Particle));
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    scene.step();
+    snapshots.capture();
+  }
+  rp::bench::doNotOptimize(snapshots.getStats().stored_bytes);
+}
+
+RP_BENCHMARK("snapshot/rollback_7_frames") {
+  Scene scene;
+  SnapshotBuffer snapshots(8);
+  snapshots.addPool("particles", scene.particles);
+  snapshots.addRegion("cursor", &scene.cursor, sizeof(scene.cursor));
+  Rollback rollback(snapshots, [&](uint64_t, std::span<const rp::Event>) { scene.step(); }, false);
+  for(int i = 0; i < 8; i++) {
+    rollback.advance({});
+  }
+
+  //a late event for the oldest frame in the window re-runs every frame after it
+  state.setItemsPerIteration(7);
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    rollback.addEvent(rollback.getFrame() - 7, rp::Event{});
+    rollback.advance({});
+  }
+  rp::bench::doNotOptimize(rollback.getStats().resimulated_frames);
+}
@@ -0,0 +1,63 @@
+#include <array>
+#include <memory>
+#include <string>
+
+#include <text/text_renderer.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using namespace rp::text;
+
+  //A debug HUD's worth of lines, drawn once per iteration like a frame
+  constexpr std::array hud_lines = {
+    "frame time  16.67 ms", "update       2.31 ms", "physics      4.02 ms", "audio        0.48 ms",
+    "bodies        1024", "contacts      3871", "voices          12", "timers pending  418",
+    "position  (12.5, 3.0, -48.25)", "velocity  (0.0, -9.81, 0.0)", "memory    184.3 MB", "draw calls      96",
+  };
+  constexpr uint32_t pixel_size = 16;
+
+  TextRenderer& getRenderer() {
+    static auto renderer = std::make_unique<TextRenderer>();
+    return *renderer;
+  }
+}
+
+RP_BENCHMARK("text/draw_hud_unchanged") {
+  auto& renderer = getRenderer();
+  TextBatch batch;
+  state.setItemsPerIteration(hud_lines.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    renderer.beginFrame();
+    batch.clear();
+    float y = 20.0f;
+    for(const auto* line : hud_lines) {
+      renderer.draw(batch, line, 10.0f, y, pixel_size);
+      y += 20.0f;
+    }
+    rp::bench::doNotOptimize(batch.quads.data());
+  }
+}
+
+//Every line changes every frame, so each one is decoded and laid out again. Its glyphs are
+//already in the atlas, this is the cost the run cache saves.
+RP_BENCHMARK("text/draw_hud_changing") {
+  auto& renderer = getRenderer();
+  TextBatch batch;
+  std::string line;
+  uint64_t frame = 0;
+  state.setItemsPerIteration(hud_lines.size());
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    renderer.beginFrame();
+    batch.clear();
+    frame++;
+    float y = 20.0f;
+    for(const auto* text : hud_lines) {
+      line = text;
+      line += std::to_string(frame);
+      renderer.draw(batch, line, 10.0f, y, pixel_size);
+      y += 20.0f;
+    }
+    rp::bench::doNotOptimize(batch.quads.data());
+  }
+}
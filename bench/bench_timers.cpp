@@ -0,0 +1,93 @@
+#include <memory>
+#include <vector>
+
+#include <timers/timer_wheel.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using namespace rp::timers;
+
+  //A million cooldowns spread over the next minute at 1 ms ticks, each fired timer schedules
+  //a replacement so the wheel stays full. Built once since it is far slower than a frame.
+  constexpr size_t pending_count = 1000000;
+  constexpr uint64_t ticks_per_frame = 16;
+  constexpr uint64_t max_delay = 60000;
+
+  uint64_t nextDelay(uint64_t& seed) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return 1000 + (seed >> 33) % (max_delay - 1000);
+  }
+
+  struct Cooldowns {
+    TimerWheel wheel;
+    uint64_t seed = 1;
+    uint64_t fired = 0;
+
+    Cooldowns() {
+      wheel.reserve(pending_count);
+      for(size_t i = 0; i < pending_count; i++) {
+        scheduleOne();
+      }
+    }
+
+    void scheduleOne() {
+      wheel.schedule(nextDelay(seed), [this]() {
+        fired++;
+        scheduleOne();
+      });
+    }
+  };
+
+  Cooldowns& getCooldowns() {
+    static auto cooldowns = std::make_unique<Cooldowns>();
+    return *cooldowns;
+  }
+
+  //The same cooldowns as a flat list scanned every frame, the way apps tracked them before
+  struct ScannedCooldowns {
+    std::vector<uint64_t> expiry = std::vector<uint64_t>(pending_count);
+    uint64_t tick = 0;
+    uint64_t seed = 1;
+
+    ScannedCooldowns() {
+      for(auto& e : expiry) {
+        e = nextDelay(seed);
+      }
+    }
+  };
+
+  ScannedCooldowns& getScannedCooldowns() {
+    static auto cooldowns = std::make_unique<ScannedCooldowns>();
+    return *cooldowns;
+  }
+}
+
+RP_BENCHMARK("timers/schedule_cancel") {
+  auto& cooldowns = getCooldowns();
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    const auto id = cooldowns.wheel.schedule(500 + i % 5000, []() {});
+    cooldowns.wheel.cancel(id);
+  }
+}
+
+RP_BENCHMARK("timers/advance_frame_1m_pending") {
+  auto& cooldowns = getCooldowns();
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    cooldowns.wheel.advance(cooldowns.wheel.getTick() + ticks_per_frame);
+  }
+  rp::bench::doNotOptimize(cooldowns.fired);
+}
+
+RP_BENCHMARK("timers/scan_frame_1m_pending") {
+  auto& cooldowns = getScannedCooldowns();
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    cooldowns.tick += ticks_per_frame;
+    for(auto& e : cooldowns.expiry) {
+      if(e <= cooldowns.tick) {
+        e = cooldowns.tick + nextDelay(cooldowns.seed);
+      }
+    }
+    rp::bench::doNotOptimize(cooldowns.expiry.data());
+  }
+}
@@ -0,0 +1,18 @@
+#include <util/uuid.hpp>
+
+#include "harness.hpp"
+
+RP_BENCHMARK("uuid/generate") {
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    auto id = rp::UUID::Generate();
+    rp::bench::doNotOptimize(id);
+  }
+}
+
+RP_BENCHMARK("uuid/to_string") {
+  const auto id = rp::UUID::Generate();
+  for(uint64_t i = 0; i < state.iterations(); i++) {
+    auto str = id.to_string();
+    rp::bench::doNotOptimize(str);
+  }
+}
@@ -0,0 +1,8 @@
+#include "harness.hpp"
+
+namespace rp::bench {
+  std::vector<Benchmark>& getRegistry() {
+    static std::vector<Benchmark> registry;
+    return registry;
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//Minimal micro-benchmark harness for rapier_bench
+//
+//Each benchmark body runs state.iterations() iterations of the measured operation.
+//The harness picks an iteration count that makes one repetition last long enough to time
+//reliably, runs warmup repetitions, then reports statistics over the measured repetitions.
+namespace rp::bench {
+  class State {
+  public:
+    explicit State(uint64_t iterations) : mIterations(iterations) {}
+
+    [[nodiscard]] uint64_t iterations() const noexcept { return mIterations; }
+
+    //Items processed per iteration, used to report throughput
+    void setItemsPerIteration(uint64_t items) noexcept { mItemsPerIteration = items; }
+    [[nodiscard]] uint64_t getItemsPerIteration() const noexcept { return mItemsPerIteration; }
+
+  private:
+    uint64_t mIterations;
+    uint64_t mItemsPerIteration = 1;
+  };
+
+  using Function = std::function<void(State& state)>;
+
+  struct Benchmark {
+    std::string name;
+    Function function;
+  };
+
+  std::vector<Benchmark>& getRegistry();
+
+  struct Registrar {
+    Registrar(const char* name, Function function) {
+      getRegistry().push_back({name, std::move(function)});
+    }
+  };
+
+  //Keeps the compiler from optimizing away a value the benchmark computes
+  template<typename T>
+  inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+  }
+}
+
+#define RP_BENCH_CONCAT_IMPL(a, b) a##b
+#define RP_BENCH_CONCAT(a, b) RP_BENCH_CONCAT_IMPL(a, b)
+
+//Registers a benchmark: RP_BENCHMARK("group/name") { for(uint64_t i = 0; i < state.iterations(); i++) {...} }
+#define RP_BENCHMARK(name) \
+  static void RP_BENCH_CONCAT(rp_bench_fn_, __LINE__)(rp::bench::State& state); \
+  static rp::bench::Registrar RP_BENCH_CONCAT(rp_bench_registrar_, __LINE__)(name, RP_BENCH_CONCAT(rp_bench_fn_, __LINE__)); \
+  static void RP_BENCH_CONCAT(rp_bench_fn_, __LINE__)([[maybe_unused]] rp::bench::State& state)
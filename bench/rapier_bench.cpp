@@ -0,0 +1,228 @@
+// rapier_bench.cpp - Runs the registered micro-benchmarks
+//
+// usage: rapier_bench [options]
+//   -f, --filter <text>        only run benchmarks whose name contains text
+//   -r, --repetitions <count>  measured repetitions per benchmark (default 20)
+//   -w, --warmup <count>       unmeasured warmup repetitions (default 3)
+//   -t, --min-time <ms>        minimum duration of one repetition (default 10)
+//   -j, --json <file>          write results as JSON, for regression tracking
+//   -c, --compare <file>       compare medians against a previous JSON result
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <rapier.hpp>
+#include <util/version.hpp>
+
+#include "harness.hpp"
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    std::string filter;
+    uint32_t repetitions = 20;
+    uint32_t warmup = 3;
+    std::chrono::milliseconds min_time{10};
+    std::string json_path;
+    std::string compare_path;
+  };
+
+  struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    uint32_t repetitions = 0;
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double stddev_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    double items_per_second = 0.0;
+  };
+
+  double runRepetition(const rp::bench::Benchmark& benchmark, uint64_t iterations, uint64_t& items_per_iteration) {
+    rp::bench::State state(iterations);
+    const auto start = Clock::now();
+    benchmark.function(state);
+    const auto elapsed = Clock::now() - start;
+    items_per_iteration = state.getItemsPerIteration();
+    return std::chrono::duration<double, std::nano>(elapsed).count();
+  }
+
+  Result runBenchmark(const rp::bench::Benchmark& benchmark, const Options& options) {
+    const double min_ns = std::chrono::duration<double, std::nano>(options.min_time).count();
+    uint64_t items_per_iteration = 1;
+
+    //grow the iteration count until one repetition takes at least min_time
+    uint64_t iterations = 1;
+    while(true) {
+      const double elapsed = runRepetition(benchmark, iterations, items_per_iteration);
+      if(elapsed >= min_ns || iterations >= (uint64_t{1} << 40)) {
+        break;
+      }
+      const double scale = elapsed > 0.0 ? std::clamp(1.5 * min_ns / elapsed, 2.0, 100.0) : 100.0;
+      iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+    }
+
+    for(uint32_t i = 0; i < options.warmup; i++) {
+      runRepetition(benchmark, iterations, items_per_iteration);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for(uint32_t i = 0; i < options.repetitions; i++) {
+      samples.push_back(runRepetition(benchmark, iterations, items_per_iteration) / static_cast<double>(iterations));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result{benchmark.name, iterations, options.repetitions};
+    const double count = static_cast<double>(samples.size());
+    double sum = 0.0;
+    for(double sample : samples) {
+      sum += sample;
+    }
+    result.mean_ns = sum / count;
+
+    double variance = 0.0;
+    for(double sample : samples) {
+      variance += (sample - result.mean_ns) * (sample - result.mean_ns);
+    }
+    result.stddev_ns = samples.size() > 1 ? std::sqrt(variance / (count - 1.0)) : 0.0;
+
+    const size_t middle = samples.size() / 2;
+    result.median_ns = (samples.size() % 2) ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+    result.min_ns = samples.front();
+    result.max_ns = samples.back();
+    result.items_per_second = static_cast<double>(items_per_iteration) * 1e9 / result.median_ns;
+    return result;
+  }
+
+  void writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream file(path);
+    if(!file) {
+      throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+    }
+
+    //one benchmark per line keeps the file diffable and trivially parseable by --compare
+    file << fmt::format("{{\n  \"rapier_version\": \"{}\",\n  \"benchmarks\": [\n", rp::getVersion().toString());
+    for(size_t i = 0; i < results.size(); i++) {
+      const auto& r = results[i];
+      file << fmt::format(
+        "    {{\"name\": \"{}\", \"iterations\": {}, \"repetitions\": {}, \"mean_ns\": {:.3f}, \"median_ns\": {:.3f}, "
+        "\"stddev_ns\": {:.3f}, \"min_ns\": {:.3f}, \"max_ns\": {:.3f}, \"items_per_second\": {:.1f}}}{}\n",
+        r.name, r.iterations, r.repetitions, r.mean_ns, r.median_ns,
+        r.stddev_ns, r.min_ns, r.max_ns, r.items_per_second, (i + 1 < results.size()) ? "," : "");
+    }
+    file << "  ]\n}\n";
+  }
+
+  std::map<std::string, double> readBaselineMedians(const std::string& path) {
+    std::ifstream file(path);
+    if(!file) {
+      throw std::runtime_error(fmt::format("Failed to open baseline {}", path));
+    }
+
+    auto fieldValue = [](std::string_view line, std::string_view key) -> std::string_view {
+      const auto key_pos = line.find(key);
+      if(key_pos == std::string_view::npos) {
+        return {};
+      }
+      auto value = line.substr(key_pos + key.size());
+      const auto end = value.find_first_of(",}\"");
+      return value.substr(0, end);
+    };
+
+    std::map<std::string, double> medians;
+    std::string line;
+    while(std::getline(file, line)) {
+      auto name = fieldValue(line, "\"name\": \"");
+      auto median = fieldValue(line, "\"median_ns\": ");
+      if(!name.empty() && !median.empty()) {
+        medians[std::string(name)] = std::stod(std::string(median));
+      }
+    }
+    return medians;
+  }
+
+  Options parseOptions(int argc, char** argv) {
+    Options options;
+    for(int i = 1; i < argc; i++) {
+      std::string_view arg = argv[i];
+      auto nextValue = [&]() -> std::string {
+        if(i + 1 >= argc) {
+          throw std::runtime_error(fmt::format("{} expects a value", arg));
+        }
+        return argv[++i];
+      };
+
+      if(arg == "-f" || arg == "--filter") {
+        options.filter = nextValue();
+      } else if(arg == "-r" || arg == "--repetitions") {
+        options.repetitions = std::max(1, std::stoi(nextValue()));
+      } else if(arg == "-w" || arg == "--warmup") {
+        options.warmup = std::max(0, std::stoi(nextValue()));
+      } else if(arg == "-t" || arg == "--min-time") {
+        options.min_time = std::chrono::milliseconds(std::max(0, std::stoi(nextValue())));
+      } else if(arg == "-j" || arg == "--json") {
+        options.json_path = nextValue();
+      } else if(arg == "-c" || arg == "--compare") {
+        options.compare_path = nextValue();
+      } else {
+        throw std::runtime_error(fmt::format("Unknown option {}", arg));
+      }
+    }
+    return options;
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    const auto options = parseOptions(argc, argv);
+    const auto baseline = options.compare_path.empty()
+      ? std::map<std::string, double>{}
+      : readBaselineMedians(options.compare_path);
+
+    fmt::print("rapier_bench (rapier v{})\n", rp::getVersion().toString());
+    fmt::print("{:<40} {:>12} {:>12} {:>10} {:>14} {:>10}\n", "benchmark", "median ns", "mean ns", "stddev %", "items/s", "vs base");
+
+    std::vector<Result> results;
+    for(const auto& benchmark : rp::bench::getRegistry()) {
+      if(!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+        continue;
+      }
+
+      const auto result = runBenchmark(benchmark, options);
+      std::string comparison = "-";
+      if(auto it = baseline.find(result.name); it != baseline.end() && it->second > 0.0) {
+        comparison = fmt::format("{:+.1f}%", (result.median_ns / it->second - 1.0) * 100.0);
+      }
+
+      fmt::print("{:<40} {:>12.2f} {:>12.2f} {:>10.2f} {:>14.4g} {:>10}\n",
+        result.name, result.median_ns, result.mean_ns,
+        result.mean_ns > 0.0 ? result.stddev_ns / result.mean_ns * 100.0 : 0.0,
+        result.items_per_second, comparison);
+      std::fflush(stdout);
+      results.push_back(result);
+    }
+
+    if(!options.json_path.empty()) {
+      writeJson(options.json_path, results);
+      fmt::print("Results written to {}\n", options.json_path);
+    }
+  } catch(std::exception& e) {
+    fmt::print(stderr, "rapier_bench: {}\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
@@ -6,6 +6,10 @@
 
 class HelloApp : public rp::App {
 public:
+  void load() {
+    rp::log::info("Hello App Load Method");
+  }
+
   void init() {
     rp::log::info("Hello App Init Method");
   }
@@ -0,0 +1,116 @@
+#include "pch.hpp"
+#include "asset/archive.hpp"
+#include "util/hash.hpp"
+#include "util/lz.hpp"
+
+namespace rp::asset {
+  namespace {
+    template<typename T>
+    std::span<const T> tableAt(std::span<const std::byte> file, uint64_t offset, uint64_t count, const std::filesystem::path& path) {
+      if(offset > file.size() || count > (file.size() - offset) / sizeof(T) || offset % alignof(T) != 0) {
+        throw std::runtime_error(fmt::format("Archive {} is corrupt: table at offset {} out of bounds", path.string(), offset));
+      }
+      return { reinterpret_cast<const T*>(file.data() + offset), static_cast<size_t>(count) };
+    }
+  }
+
+  Archive::Archive(const std::filesystem::path& path) : mPath(path), mFile(path) {
+    auto file = mFile.data();
+    if(file.size() < sizeof(ArchiveHeader)) {
+      throw std::runtime_error(fmt::format("{} is not an asset archive!", path.string()));
+    }
+
+    const auto& header = *reinterpret_cast<const ArchiveHeader*>(file.data());
+    if(header.magic != archive_magic) {
+      throw std::runtime_error(fmt::format("{} is not an asset archive!", path.string()));
+    }
+    if(header.format_version != archive_format_version) {
+      throw std::runtime_error(fmt::format("Archive {} has format version {}, expected {}",
+        path.string(), header.format_version, archive_format_version));
+    }
+
+    mEntries = tableAt<ArchiveEntry>(file, header.toc_offset, header.entry_count, path);
+    mNameIndex = tableAt<ArchiveNameIndex>(file, header.name_index_offset, header.entry_count, path);
+    mStrings = tableAt<char>(file, header.string_table_offset, header.string_table_size, path);
+
+    for(const auto& entry : mEntries) {
+      if(entry.offset > file.size() || entry.stored_size > file.size() - entry.offset || entry.name_offset >= mStrings.size()) {
+        throw std::runtime_error(fmt::format("Archive {} is corrupt: entry out of bounds", path.string()));
+      }
+      //uncompressed entries are copied and viewed as is, so their stored bytes must be the whole asset
+      if(entry.compression == Compression::None && entry.stored_size != entry.size) {
+        throw std::runtime_error(fmt::format("Archive {} is corrupt: uncompressed entry size mismatch", path.string()));
+      }
+    }
+
+    log::rp_info("Mounted archive {} ({} entries)", path.string(), header.entry_count);
+  }
+
+  const ArchiveEntry* Archive::find(const UUID& id) const {
+    auto it = std::lower_bound(mEntries.begin(), mEntries.end(), id.data(),
+      [](const ArchiveEntry& entry, const std::array<uint8_t, 16>& key) { return entry.uuid < key; });
+
+    if(it == mEntries.end() || it->uuid != id.data()) {
+      return nullptr;
+    }
+    return &*it;
+  }
+
+  const ArchiveEntry* Archive::find(std::string_view name) const {
+    const uint64_t name_hash = hashString(name);
+    auto it = std::lower_bound(mNameIndex.begin(), mNameIndex.end(), name_hash,
+      [](const ArchiveNameIndex& index, uint64_t key) { return index.name_hash < key; });
+
+    //different names can share a hash, so confirm against the stored name
+    for(; it != mNameIndex.end() && it->name_hash == name_hash; ++it) {
+      if(it->entry < mEntries.size() && getName(mEntries[it->entry]) == name) {
+        return &mEntries[it->entry];
+      }
+    }
+    return nullptr;
+  }
+
+  std::string_view Archive::getName(const ArchiveEntry& entry) const {
+    const char* name = mStrings.data() + entry.name_offset;
+    const size_t max_length = mStrings.size() - entry.name_offset;
+    return { name, strnlen(name, max_length) };
+  }
+
+  std::span<const std::byte> Archive::storedBytes(const ArchiveEntry& entry) const {
+    return mFile.data().subspan(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.stored_size));
+  }
+
+  std::span<const std::byte> Archive::view(const ArchiveEntry& entry) const {
+    if(entry.compression != Compression::None) {
+      throw std::runtime_error(fmt::format("Can't view compressed entry {} of {} in place", getName(entry), mPath.string()));
+    }
+    return storedBytes(entry);
+  }
+
+  void Archive::read(const ArchiveEntry& entry, std::span<std::byte> dst) const {
+    if(dst.size() != entry.size) {
+      throw std::runtime_error(fmt::format("Read of {} needs a {} byte buffer, got {}", getName(entry), entry.size, dst.size()));
+    }
+
+    auto stored = storedBytes(entry);
+    switch(entry.compression) {
+      case Compression::None:
+        std::copy(stored.begin(), stored.end(), dst.begin());
+        return;
+      case Compression::LZ:
+        if(!lz::decompress(stored, dst)) {
+          throw std::runtime_error(fmt::format("Failed to decompress {} from {}", getName(entry), mPath.string()));
+        }
+        return;
+    }
+
+    throw std::runtime_error(fmt::format("Entry {} of {} has unknown compression {}",
+      getName(entry), mPath.string(), static_cast<uint32_t>(entry.compression)));
+  }
+
+  std::vector<std::byte> Archive::read(const ArchiveEntry& entry) const {
+    std::vector<std::byte> data(static_cast<size_t>(entry.size));
+    read(entry, data);
+    return data;
+  }
+}
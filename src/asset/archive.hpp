@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "asset/archive_format.hpp"
+#include "util/mapped_file.hpp"
+#include "util/uuid.hpp"
+
+namespace rp::asset {
+  //Runtime reader for packed asset archives.
+  //The archive is memory mapped, lookups binary search the mapped tables and
+  //uncompressed payloads are handed out as views into the mapping without copying.
+  class Archive {
+  public:
+    explicit Archive(const std::filesystem::path& path);
+
+    [[nodiscard]] const ArchiveEntry* find(const UUID& id) const;
+    [[nodiscard]] const ArchiveEntry* find(std::string_view name) const;
+
+    [[nodiscard]] std::span<const ArchiveEntry> entries() const noexcept { return mEntries; }
+    [[nodiscard]] std::string_view getName(const ArchiveEntry& entry) const;
+    [[nodiscard]] const std::filesystem::path& getPath() const noexcept { return mPath; }
+
+    //Zero-copy view of an uncompressed entry. Throws for compressed entries.
+    [[nodiscard]] std::span<const std::byte> view(const ArchiveEntry& entry) const;
+
+    //Copies or decompresses an entry into dst, which must be entry.size bytes
+    void read(const ArchiveEntry& entry, std::span<std::byte> dst) const;
+    [[nodiscard]] std::vector<std::byte> read(const ArchiveEntry& entry) const;
+
+  private:
+    [[nodiscard]] std::span<const std::byte> storedBytes(const ArchiveEntry& entry) const;
+
+    std::filesystem::path mPath;
+    MappedFile mFile;
+    std::span<const ArchiveEntry> mEntries;
+    std::span<const ArchiveNameIndex> mNameIndex;
+    std::span<const char> mStrings;
+  };
+}
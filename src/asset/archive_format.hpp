@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+//On-disk layout of a packed asset archive (.rpak)
+//
+//  [ArchiveHeader]
+//  [payloads, each aligned to header.alignment]
+//  [ArchiveEntry x entry_count]       sorted by uuid
+//  [ArchiveNameIndex x entry_count]   sorted by name_hash
+//  [string table]                     entry names, null terminated
+//
+//All values are little endian. Every table is read in place from the mapped file.
+namespace rp::asset {
+  constexpr std::array<char, 4> archive_magic = {'R', 'P', 'A', 'K'};
+  constexpr uint32_t archive_format_version = 1;
+  constexpr uint32_t default_archive_alignment = 64;
+
+  enum class Compression : uint32_t {
+    None,
+    LZ,
+  };
+
+  struct ArchiveHeader {
+    std::array<char, 4> magic;
+    uint32_t format_version;
+    uint32_t entry_count;
+    uint32_t alignment;
+    uint64_t toc_offset;
+    uint64_t name_index_offset;
+    uint64_t string_table_offset;
+    uint64_t string_table_size;
+  };
+
+  struct ArchiveEntry {
+    std::array<uint8_t, 16> uuid;
+    uint64_t name_hash;
+    uint64_t offset;       //payload offset from the start of the archive
+    uint64_t stored_size;  //size of the payload as stored in the archive
+    uint64_t size;         //size of the payload once decompressed
+    uint32_t name_offset;  //offset of the entry name in the string table
+    Compression compression;
+  };
+
+  struct ArchiveNameIndex {
+    uint64_t name_hash;
+    uint32_t entry;
+    uint32_t reserved;
+  };
+
+  static_assert(std::is_trivially_copyable_v<ArchiveHeader> && sizeof(ArchiveHeader) == 48);
+  static_assert(std::is_trivially_copyable_v<ArchiveEntry> && sizeof(ArchiveEntry) == 56);
+  static_assert(std::is_trivially_copyable_v<ArchiveNameIndex> && sizeof(ArchiveNameIndex) == 16);
+}
@@ -0,0 +1,122 @@
+#include "pch.hpp"
+#include "asset/archive_writer.hpp"
+#include "util/hash.hpp"
+#include "util/lz.hpp"
+
+namespace rp::asset {
+  namespace {
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+      return (value + alignment - 1) & ~(alignment - 1);
+    }
+  }
+
+  ArchiveWriter::ArchiveWriter(uint32_t alignment) : mAlignment(alignment) {
+    if(alignment < alignof(ArchiveEntry) || (alignment & (alignment - 1)) != 0) {
+      throw std::invalid_argument(fmt::format("Archive alignment must be a power of two >= {}, got {}", alignof(ArchiveEntry), alignment));
+    }
+  }
+
+  void ArchiveWriter::add(const UUID& id, std::string_view name, std::span<const std::byte> data, Compression compression) {
+    for(const auto& pending : mPending) {
+      if(pending.id == id) {
+        throw std::invalid_argument(fmt::format("Duplicate asset id {} ({} and {})", id.to_string(), pending.name, name));
+      }
+      if(pending.name == name) {
+        throw std::invalid_argument(fmt::format("Duplicate asset name {}", name));
+      }
+    }
+
+    PendingEntry entry{id, std::string(name), Compression::None, data.size(), {}};
+    if(compression == Compression::LZ) {
+      auto compressed = lz::compress(data);
+      if(compressed.size() < data.size()) {
+        entry.compression = Compression::LZ;
+        entry.stored = std::move(compressed);
+      }
+    }
+
+    if(entry.compression == Compression::None) {
+      entry.stored.assign(data.begin(), data.end());
+    }
+
+    mPending.push_back(std::move(entry));
+  }
+
+  void ArchiveWriter::write(const std::filesystem::path& path) const {
+    std::vector<const PendingEntry*> sorted;
+    sorted.reserve(mPending.size());
+    for(const auto& pending : mPending) {
+      sorted.push_back(&pending);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](auto* lhs, auto* rhs) { return lhs->id < rhs->id; });
+
+    std::vector<ArchiveEntry> entries;
+    std::vector<ArchiveNameIndex> name_index;
+    std::string strings;
+    entries.reserve(sorted.size());
+    name_index.reserve(sorted.size());
+
+    uint64_t offset = alignUp(sizeof(ArchiveHeader), mAlignment);
+    for(const auto* pending : sorted) {
+      ArchiveEntry entry = {};
+      entry.uuid = pending->id.data();
+      entry.name_hash = hashString(pending->name);
+      entry.offset = offset;
+      entry.stored_size = pending->stored.size();
+      entry.size = pending->size;
+      entry.name_offset = static_cast<uint32_t>(strings.size());
+      entry.compression = pending->compression;
+
+      name_index.push_back({entry.name_hash, static_cast<uint32_t>(entries.size()), 0});
+      entries.push_back(entry);
+
+      strings += pending->name;
+      strings += '\0';
+      offset = alignUp(offset + entry.stored_size, mAlignment);
+    }
+    std::stable_sort(name_index.begin(), name_index.end(),
+      [](const ArchiveNameIndex& lhs, const ArchiveNameIndex& rhs) { return lhs.name_hash < rhs.name_hash; });
+
+    ArchiveHeader header = {};
+    header.magic = archive_magic;
+    header.format_version = archive_format_version;
+    header.entry_count = static_cast<uint32_t>(entries.size());
+    header.alignment = mAlignment;
+    header.toc_offset = offset;
+    header.name_index_offset = header.toc_offset + entries.size() * sizeof(ArchiveEntry);
+    header.string_table_offset = header.name_index_offset + name_index.size() * sizeof(ArchiveNameIndex);
+    header.string_table_size = strings.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file) {
+      throw std::runtime_error(fmt::format("Failed to open {} for writing", path.string()));
+    }
+
+    auto writeBytes = [&](const void* data, size_t size) {
+      file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    auto padTo = [&](uint64_t target) {
+      static constexpr std::array<char, 256> zeros = {};
+      uint64_t position = static_cast<uint64_t>(file.tellp());
+      while(position < target) {
+        const auto count = std::min<uint64_t>(target - position, zeros.size());
+        writeBytes(zeros.data(), static_cast<size_t>(count));
+        position += count;
+      }
+    };
+
+    writeBytes(&header, sizeof(header));
+    for(size_t i = 0; i < sorted.size(); i++) {
+      padTo(entries[i].offset);
+      writeBytes(sorted[i]->stored.data(), sorted[i]->stored.size());
+    }
+    padTo(header.toc_offset);
+    writeBytes(entries.data(), entries.size() * sizeof(ArchiveEntry));
+    writeBytes(name_index.data(), name_index.size() * sizeof(ArchiveNameIndex));
+    writeBytes(strings.data(), strings.size());
+
+    if(!file) {
+      throw std::runtime_error(fmt::format("Failed to write archive {}", path.string()));
+    }
+  }
+}
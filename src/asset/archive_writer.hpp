@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asset/archive_format.hpp"
+#include "util/uuid.hpp"
+
+namespace rp::asset {
+  //Builds packed asset archives, see archive_format.hpp for the layout
+  class ArchiveWriter {
+  public:
+    explicit ArchiveWriter(uint32_t alignment = default_archive_alignment);
+
+    //Compressed entries are stored uncompressed if compression doesn't make them smaller
+    void add(const UUID& id, std::string_view name, std::span<const std::byte> data, Compression compression = Compression::None);
+
+    void write(const std::filesystem::path& path) const;
+
+    [[nodiscard]] size_t getEntryCount() const noexcept { return mPending.size(); }
+
+  private:
+    struct PendingEntry {
+      UUID id;
+      std::string name;
+      Compression compression;
+      uint64_t size;
+      std::vector<std::byte> stored;
+    };
+
+    uint32_t mAlignment;
+    std::vector<PendingEntry> mPending;
+  };
+}
@@ -0,0 +1,447 @@
+#include "pch.hpp"
+#include "asset/asset_internal.hpp"
+#include "asset/archive.hpp"
+#include "util/file_watcher.hpp"
+#include "util/string_id.hpp"
+
+namespace rp::asset {
+  namespace detail {
+    struct Slot {
+      std::string name;
+      StringId id;  //key in Manager::slots
+      Priority priority = Priority::Normal;
+      std::atomic<State> state = State::Queued;
+      std::atomic<bool> cancel_requested = false;
+
+      //source, resolved on the main thread when the load is requested
+      std::shared_ptr<const Archive> archive;
+      const ArchiveEntry* entry = nullptr;
+      std::filesystem::path file;
+
+      //set when this slot stages new data for a hot reload of another, resident slot
+      std::shared_ptr<Slot> reload_target;
+
+      //result, written by an I/O thread before the slot is handed back to the main thread
+      std::vector<std::byte> owned;
+      std::span<const std::byte> data;
+      std::string error;
+
+      //main thread only
+      std::vector<Callback> callbacks;
+      std::list<Slot*>::iterator lru;
+      bool resident = false;
+    };
+  }
+
+  namespace {
+    using detail::Slot;
+
+    struct Request {
+      Priority priority;
+      uint64_t sequence;
+      std::shared_ptr<Slot> slot;
+
+      //highest priority first, then first come first served
+      bool operator<(const Request& rhs) const {
+        if(priority != rhs.priority) {
+          return priority < rhs.priority;
+        }
+        return sequence > rhs.sequence;
+      }
+    };
+
+    struct Manager {
+      Properties properties;
+      std::vector<std::shared_ptr<const Archive>> archives;
+      std::unordered_map<StringId, std::shared_ptr<Slot>> slots;
+      std::list<Slot*> lru;
+      size_t resident_bytes = 0;
+      uint64_t next_sequence = 0;
+
+      std::mutex queue_mutex;
+      std::condition_variable queue_cv;
+      std::priority_queue<Request> queue;
+      bool stopping = false;
+
+      std::mutex completed_mutex;
+      std::vector<std::shared_ptr<Slot>> completed;
+
+      std::vector<std::thread> io_threads;
+
+      std::unique_ptr<FileWatcher> watcher;
+      std::vector<Callback> reload_listeners;
+
+      ~Manager() {
+        {
+          std::lock_guard lock(queue_mutex);
+          stopping = true;
+        }
+        queue_cv.notify_all();
+        for(auto& thread : io_threads) {
+          thread.join();
+        }
+      }
+    };
+
+    std::unique_ptr<Manager> manager;
+
+    Manager& getManager() {
+      if(!manager) {
+        throw std::runtime_error("Asset system used before rp::run initialized it!");
+      }
+      return *manager;
+    }
+
+    void readSlot(Slot& slot) {
+      try {
+        if(slot.archive) {
+          if(slot.entry->compression == Compression::None) {
+            slot.data = slot.archive->view(*slot.entry);
+          } else {
+            slot.owned = slot.archive->read(*slot.entry);
+            slot.data = slot.owned;
+          }
+          return;
+        }
+
+        std::ifstream file(slot.file, std::ios::binary | std::ios::ate);
+        if(!file) {
+          slot.error = fmt::format("Failed to open {}", slot.file.string());
+          return;
+        }
+        slot.owned.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(slot.owned.data()), static_cast<std::streamsize>(slot.owned.size()));
+        if(!file) {
+          slot.owned.clear();
+          slot.error = fmt::format("Failed to read {}", slot.file.string());
+          return;
+        }
+        slot.data = slot.owned;
+      } catch(std::exception& e) {
+        slot.owned.clear();
+        slot.data = {};
+        slot.error = e.what();
+      }
+    }
+
+    void ioThreadMain(Manager& mgr) {
+      while(true) {
+        std::shared_ptr<Slot> slot;
+        {
+          std::unique_lock lock(mgr.queue_mutex);
+          mgr.queue_cv.wait(lock, [&]() { return mgr.stopping || !mgr.queue.empty(); });
+          if(mgr.stopping) {
+            return;
+          }
+          slot = mgr.queue.top().slot;
+          mgr.queue.pop();
+        }
+
+        //stale entries are left behind by cancellation and priority bumps
+        auto expected = State::Queued;
+        if(!slot->state.compare_exchange_strong(expected, State::Loading)) {
+          continue;
+        }
+
+        if(!slot->cancel_requested) {
+          readSlot(*slot);
+        }
+
+        std::lock_guard lock(mgr.completed_mutex);
+        mgr.completed.push_back(std::move(slot));
+      }
+    }
+
+    void forget(Manager& mgr, Slot& slot) {
+      auto it = mgr.slots.find(slot.id);
+      if(it != mgr.slots.end() && it->second.get() == &slot) {
+        mgr.slots.erase(it);
+      }
+    }
+
+    void enqueue(Manager& mgr, Priority priority, std::shared_ptr<Slot> slot) {
+      {
+        std::lock_guard lock(mgr.queue_mutex);
+        mgr.queue.push({priority, mgr.next_sequence++, std::move(slot)});
+      }
+      mgr.queue_cv.notify_one();
+    }
+
+    //Re-reads resident loose assets whose files changed, the swap happens once the read completes
+    void queueReloads(Manager& mgr) {
+      for(const auto& path : mgr.watcher->collectChanges()) {
+        const auto name = path.lexically_relative(mgr.properties.looseRoot).generic_string();
+        auto it = mgr.slots.find(StringId(name));
+        if(it == mgr.slots.end() || it->second->name != name || it->second->archive || !it->second->resident) {
+          continue;
+        }
+
+        log::rp_info("Reloading asset {}", it->second->name);
+        auto staging = std::make_shared<Slot>();
+        staging->name = it->second->name;
+        staging->id = it->first;
+        staging->file = it->second->file;
+        staging->reload_target = it->second;
+        enqueue(mgr, Priority::High, std::move(staging));
+      }
+    }
+
+    void swapReloaded(Manager& mgr, Slot& staging) {
+      auto target = std::move(staging.reload_target);
+      if(!staging.error.empty()) {
+        log::rp_error("Failed to reload asset {}: {}", staging.name, staging.error);
+        return;
+      }
+
+      //evicted while the reload was in flight, the next load reads the new file anyway
+      if(!target->resident) {
+        return;
+      }
+
+      //the old bytes outlive the listeners, so they can still read spans taken before the swap
+      const auto previous = std::move(target->owned);
+      mgr.resident_bytes -= previous.size();
+      target->owned = std::move(staging.owned);
+      target->data = target->owned;
+      mgr.resident_bytes += target->owned.size();
+
+      Handle handle(target);
+      for(auto& listener : mgr.reload_listeners) {
+        listener(handle);
+      }
+    }
+
+    void evictToBudget(Manager& mgr) {
+      auto it = mgr.lru.end();
+      while(mgr.resident_bytes > mgr.properties.memoryBudget && it != mgr.lru.begin()) {
+        --it;
+        Slot* slot = *it;
+        auto slot_it = mgr.slots.find(slot->id);
+
+        //only the cache references it, no handle can observe the eviction
+        if(slot_it != mgr.slots.end() && slot_it->second.use_count() == 1) {
+          log::rp_trace("Evicting asset {} ({} bytes)", slot->name, slot->owned.size());
+          mgr.resident_bytes -= slot->owned.size();
+          slot->resident = false;
+          it = mgr.lru.erase(it);
+          mgr.slots.erase(slot_it);
+        }
+      }
+    }
+  }
+
+  State Handle::getState() const noexcept {
+    return mSlot ? mSlot->state.load(std::memory_order_acquire) : State::Failed;
+  }
+
+  std::string_view Handle::getName() const noexcept {
+    return mSlot ? std::string_view(mSlot->name) : std::string_view();
+  }
+
+  std::string_view Handle::getError() const noexcept {
+    //the I/O thread may still be writing the error until the Failed state is published
+    return (getState() == State::Failed && mSlot) ? std::string_view(mSlot->error) : std::string_view();
+  }
+
+  std::span<const std::byte> Handle::data() const noexcept {
+    return isLoaded() ? mSlot->data : std::span<const std::byte>();
+  }
+
+  void Handle::cancel() {
+    if(!mSlot || !manager) {
+      return;
+    }
+
+    //Loaded is only set on the main thread, so a finished load can't slip in after this check
+    const auto state = mSlot->state.load(std::memory_order_acquire);
+    if(state != State::Queued && state != State::Loading) {
+      return;
+    }
+
+    mSlot->cancel_requested = true;
+    auto expected = State::Queued;
+    if(mSlot->state.compare_exchange_strong(expected, State::Cancelled)) {
+      mSlot->callbacks.clear();
+      forget(*manager, *mSlot);
+    }
+  }
+
+  void init(const Properties& properties) {
+    manager = std::make_unique<Manager>();
+    manager->properties = properties;
+
+    const uint32_t io_threads = std::max<uint32_t>(properties.ioThreads, 1);
+    for(uint32_t i = 0; i < io_threads; i++) {
+      manager->io_threads.emplace_back(ioThreadMain, std::ref(*manager));
+    }
+
+    log::rp_info("Asset streaming started ({} I/O threads, {} MiB budget)",
+      io_threads, properties.memoryBudget / (1024 * 1024));
+
+    if(properties.hotReload) {
+      manager->watcher = createFileWatcher(properties.looseRoot, properties.hotReloadDebounce);
+    }
+  }
+
+  void shutdown() {
+    manager.reset();
+  }
+
+  void mount(const std::filesystem::path& archive_path) {
+    getManager().archives.push_back(std::make_shared<const Archive>(archive_path));
+  }
+
+  Handle load(std::string_view name, Priority priority, Callback on_complete) {
+    auto& mgr = getManager();
+
+    const auto id = StringId::Intern(name);
+    auto [it, inserted] = mgr.slots.try_emplace(id);
+    //slots are keyed by hash alone, two names sharing one must never share data
+    if(!inserted && it->second->name != name) {
+      throw std::runtime_error(fmt::format("Asset names '{}' and '{}' have the same hash, rename one of them!", it->second->name, name));
+    }
+    if(!inserted && !it->second->cancel_requested) {
+      auto& slot = it->second;
+      switch(slot->state.load()) {
+        case State::Loaded:
+        case State::Failed:
+          if(slot->resident) {
+            mgr.lru.splice(mgr.lru.begin(), mgr.lru, slot->lru);
+          }
+          if(on_complete) {
+            on_complete(Handle(slot));
+          }
+          return Handle(slot);
+        case State::Queued:
+        case State::Loading:
+          if(on_complete) {
+            slot->callbacks.push_back(std::move(on_complete));
+          }
+          if(priority > slot->priority && slot->state == State::Queued) {
+            slot->priority = priority;
+            enqueue(mgr, priority, slot);
+          }
+          return Handle(slot);
+        case State::Cancelled:
+          break;
+      }
+    }
+
+    auto slot = std::make_shared<Slot>();
+    slot->name = name;
+    slot->id = id;
+    slot->priority = priority;
+    if(on_complete) {
+      slot->callbacks.push_back(std::move(on_complete));
+    }
+
+    for(auto archive = mgr.archives.rbegin(); archive != mgr.archives.rend(); ++archive) {
+      if(const auto* entry = (*archive)->find(name)) {
+        slot->archive = *archive;
+        slot->entry = entry;
+        break;
+      }
+    }
+    if(!slot->archive) {
+      slot->file = mgr.properties.looseRoot / name;
+    }
+
+    //the replaced slot lives on in its handles but must leave the cache accounting
+    if(!inserted && it->second->resident) {
+      auto& replaced = *it->second;
+      mgr.resident_bytes -= replaced.owned.size();
+      mgr.lru.erase(replaced.lru);
+      replaced.resident = false;
+    }
+    it->second = slot;
+    enqueue(mgr, priority, slot);
+    return Handle(std::move(slot));
+  }
+
+  Handle load(const UUID& id, Priority priority, Callback on_complete) {
+    auto& mgr = getManager();
+    for(auto archive = mgr.archives.rbegin(); archive != mgr.archives.rend(); ++archive) {
+      if(const auto* entry = (*archive)->find(id)) {
+        return load((*archive)->getName(*entry), priority, std::move(on_complete));
+      }
+    }
+
+    auto slot = std::make_shared<Slot>();
+    slot->name = id.to_string();
+    slot->state = State::Failed;
+    slot->error = fmt::format("No mounted archive contains asset {}", slot->name);
+    if(on_complete) {
+      on_complete(Handle(slot));
+    }
+    return Handle(std::move(slot));
+  }
+
+  void dispatchCompletions() {
+    if(!manager) {
+      return;
+    }
+    auto& mgr = *manager;
+
+    if(mgr.watcher) {
+      queueReloads(mgr);
+    }
+
+    std::vector<std::shared_ptr<Slot>> completed;
+    {
+      std::lock_guard lock(mgr.completed_mutex);
+      completed.swap(mgr.completed);
+    }
+
+    for(auto& slot : completed) {
+      if(slot->reload_target) {
+        swapReloaded(mgr, *slot);
+        continue;
+      }
+
+      if(slot->cancel_requested) {
+        slot->state = State::Cancelled;
+        slot->owned = {};
+        slot->data = {};
+        slot->callbacks.clear();
+        forget(mgr, *slot);
+        continue;
+      }
+
+      if(slot->error.empty()) {
+        mgr.resident_bytes += slot->owned.size();
+        mgr.lru.push_front(slot.get());
+        slot->lru = mgr.lru.begin();
+        slot->resident = true;
+        slot->state.store(State::Loaded, std::memory_order_release);
+      } else {
+        log::rp_error("Failed to load asset {}: {}", slot->name, slot->error);
+        slot->state.store(State::Failed, std::memory_order_release);
+        forget(mgr, *slot);
+      }
+
+      auto callbacks = std::move(slot->callbacks);
+      slot->callbacks.clear();
+      Handle handle(slot);
+      for(auto& callback : callbacks) {
+        callback(handle);
+      }
+    }
+
+    evictToBudget(mgr);
+  }
+
+  void addReloadListener(Callback on_reload) {
+    getManager().reload_listeners.push_back(std::move(on_reload));
+  }
+
+  size_t getResidentBytes() {
+    return getManager().resident_bytes;
+  }
+
+  size_t getQueueDepth() {
+    auto& mgr = getManager();
+    std::lock_guard lock(mgr.queue_mutex);
+    return mgr.queue.size();
+  }
+}
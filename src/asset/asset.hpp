@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "util/uuid.hpp"
+
+//Asynchronous asset streaming
+//
+//Assets are resolved against mounted archives (newest mount first), then against the
+//loose file root. Reads happen on dedicated I/O threads and completion callbacks are
+//delivered on the main thread from inside rp::run's loop. With hot reload enabled, changed
+//loose files are re-read in the background and swapped in at the start of a frame.
+//All functions here must be called from the main thread.
+namespace rp::asset {
+  enum class Priority : uint8_t {
+    Low,
+    Normal,
+    High,
+    Critical,
+  };
+
+  enum class State : uint8_t {
+    Queued,
+    Loading,
+    Loaded,
+    Failed,
+    Cancelled,
+  };
+
+  struct Properties {
+    uint32_t ioThreads = 2;
+    size_t memoryBudget = size_t{512} * 1024 * 1024;
+    std::filesystem::path looseRoot = ".";
+
+    //Watch looseRoot and reload resident assets whose source files change
+    bool hotReload = false;
+    std::chrono::milliseconds hotReloadDebounce{100};
+  };
+
+  namespace detail {
+    struct Slot;
+  }
+
+  //Reference counted handle to an asset. Assets stay resident while any handle to them
+  //is alive; once the last handle is dropped they become candidates for LRU eviction.
+  class Handle {
+  public:
+    Handle() = default;
+    explicit Handle(std::shared_ptr<detail::Slot> slot) : mSlot(std::move(slot)) {}
+
+    [[nodiscard]] bool isValid() const noexcept { return mSlot != nullptr; }
+    [[nodiscard]] State getState() const noexcept;
+    [[nodiscard]] bool isLoaded() const noexcept { return getState() == State::Loaded; }
+    [[nodiscard]] std::string_view getName() const noexcept;
+    //Empty unless the load failed
+    [[nodiscard]] std::string_view getError() const noexcept;
+
+    //Only valid once the asset is loaded. A hot reload replaces the bytes, so spans taken
+    //before it dangle once the reload listeners return and must be fetched again.
+    [[nodiscard]] std::span<const std::byte> data() const noexcept;
+
+    //Stops a queued or in-flight load. Completion callbacks for it won't be called. No effect once it has completed.
+    void cancel();
+
+    explicit operator bool() const noexcept { return isLoaded(); }
+
+  private:
+    std::shared_ptr<detail::Slot> mSlot;
+  };
+
+  using Callback = std::function<void(const Handle& handle)>;
+
+  void mount(const std::filesystem::path& archive_path);
+
+  //Requests an asset by name. Requesting an asset that is already queued raises its priority,
+  //requesting one that is already loaded calls on_complete immediately. Throws if the name's
+  //hash collides with a different name the cache already holds.
+  Handle load(std::string_view name, Priority priority = Priority::Normal, Callback on_complete = {});
+  Handle load(const UUID& id, Priority priority = Priority::Normal, Callback on_complete = {});
+
+  //Called on the main thread after a hot reloaded asset's data has been swapped in. The previous
+  //bytes stay alive until every listener has returned, after that only handle.data() is valid.
+  void addReloadListener(Callback on_reload);
+
+  [[nodiscard]] size_t getResidentBytes();
+  [[nodiscard]] size_t getQueueDepth();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "asset/asset.hpp"
+
+namespace rp::asset {
+  void init(const Properties& properties);
+
+  //Delivers completion callbacks and enforces the memory budget, called once per frame
+  void dispatchCompletions();
+
+  void shutdown();
+}
@@ -0,0 +1,134 @@
+#include "pch.hpp"
+#include "audio/adpcm.hpp"
+
+namespace rp::audio::adpcm {
+  namespace {
+    constexpr std::array<int8_t, 16> index_table{-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+    constexpr std::array<int16_t, 89> step_table{
+      7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+      50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+      337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+      2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+      15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+    struct ChannelState {
+      int32_t predictor = 0;
+      int32_t index = 0;
+
+      int16_t decode(uint8_t nibble) {
+        const int32_t step = step_table[index];
+        int32_t diff = step >> 3;
+        if(nibble & 1) diff += step >> 2;
+        if(nibble & 2) diff += step >> 1;
+        if(nibble & 4) diff += step;
+        predictor = std::clamp(predictor + ((nibble & 8) ? -diff : diff), -32768, 32767);
+        index = std::clamp(index + index_table[nibble], 0, 88);
+        return static_cast<int16_t>(predictor);
+      }
+
+      uint8_t encode(int16_t sample) {
+        int32_t diff = sample - predictor;
+        uint8_t nibble = 0;
+        if(diff < 0) {
+          nibble = 8;
+          diff = -diff;
+        }
+        int32_t step = step_table[index];
+        for(uint8_t bit = 4; bit > 0; bit >>= 1) {
+          if(diff >= step) {
+            nibble |= bit;
+            diff -= step;
+          }
+          step >>= 1;
+        }
+        //keep the encoder's predictor in step with what the decoder will reconstruct
+        decode(nibble);
+        return nibble;
+      }
+    };
+
+    void writeInt16(std::byte* dst, int16_t value) {
+      dst[0] = static_cast<std::byte>(value & 0xFF);
+      dst[1] = static_cast<std::byte>((value >> 8) & 0xFF);
+    }
+  }
+
+  bool decodeBlock(std::span<const std::byte> block, uint32_t channels, std::span<int16_t> out) {
+    if(channels == 0 || channels > 2 || block.size() <= 4 * channels) {
+      return false;
+    }
+    const uint32_t samples_per_block = getSamplesPerBlock(static_cast<uint32_t>(block.size()), channels);
+    if(out.size() < size_t{samples_per_block} * channels) {
+      return false;
+    }
+
+    //per channel header: first sample and step index
+    std::array<ChannelState, 2> states;
+    for(uint32_t c = 0; c < channels; c++) {
+      const std::byte* header = block.data() + 4 * c;
+      states[c].predictor = static_cast<int16_t>(std::to_integer<uint16_t>(header[0]) | (std::to_integer<uint16_t>(header[1]) << 8));
+      states[c].index = std::clamp(std::to_integer<int32_t>(header[2]), 0, 88);
+      out[c] = static_cast<int16_t>(states[c].predictor);
+    }
+
+    //then 4 bytes (8 samples) per channel in turn, low nibble first
+    const std::byte* data = block.data() + 4 * channels;
+    const uint32_t groups = (samples_per_block - 1) / 8;
+    for(uint32_t group = 0; group < groups; group++) {
+      for(uint32_t c = 0; c < channels; c++) {
+        int16_t* dst = out.data() + (1 + group * 8) * channels + c;
+        for(uint32_t i = 0; i < 4; i++) {
+          const uint8_t byte = std::to_integer<uint8_t>(*data++);
+          dst[(i * 2) * channels] = states[c].decode(byte & 0x0F);
+          dst[(i * 2 + 1) * channels] = states[c].decode(byte >> 4);
+        }
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::byte> encode(std::span<const int16_t> samples, uint32_t channels, uint32_t block_align) {
+    if(channels == 0 || channels > 2) {
+      throw std::invalid_argument(fmt::format("IMA ADPCM supports 1 or 2 channels, got {}", channels));
+    }
+    if(block_align <= 4 * channels || (block_align - 4 * channels) % (4 * channels) != 0) {
+      throw std::invalid_argument(fmt::format("Invalid IMA ADPCM block size {} for {} channels", block_align, channels));
+    }
+
+    const uint32_t samples_per_block = getSamplesPerBlock(block_align, channels);
+    const size_t frames = samples.size() / channels;
+    const size_t block_count = (frames + samples_per_block - 1) / samples_per_block;
+    std::vector<std::byte> encoded(block_count * block_align);
+
+    //step indices carry across blocks so each block starts well adapted
+    std::array<ChannelState, 2> states;
+    auto sampleAt = [&](size_t frame, uint32_t c) -> int16_t {
+      return (frame < frames) ? samples[frame * channels + c] : int16_t{0};
+    };
+
+    for(size_t block = 0; block < block_count; block++) {
+      std::byte* dst = encoded.data() + block * block_align;
+      const size_t first_frame = block * samples_per_block;
+      for(uint32_t c = 0; c < channels; c++) {
+        states[c].predictor = sampleAt(first_frame, c);
+        writeInt16(dst + 4 * c, sampleAt(first_frame, c));
+        dst[4 * c + 2] = static_cast<std::byte>(states[c].index);
+        dst[4 * c + 3] = std::byte{0};
+      }
+
+      std::byte* data = dst + 4 * channels;
+      for(uint32_t group = 0; group < (samples_per_block - 1) / 8; group++) {
+        for(uint32_t c = 0; c < channels; c++) {
+          const size_t frame = first_frame + 1 + group * 8;
+          for(uint32_t i = 0; i < 4; i++) {
+            const uint8_t low = states[c].encode(sampleAt(frame + i * 2, c));
+            const uint8_t high = states[c].encode(sampleAt(frame + i * 2 + 1, c));
+            *data++ = static_cast<std::byte>(low | (high << 4));
+          }
+        }
+      }
+    }
+    return encoded;
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//IMA ADPCM as stored in WAV files (format tag 0x11).
+//4 bits per sample in fixed-size blocks that decode independently, so streams can decode a block at a time.
+namespace rp::audio::adpcm {
+  //Samples per channel in a block of block_align bytes
+  constexpr uint32_t getSamplesPerBlock(uint32_t block_align, uint32_t channels) {
+    return (block_align - 4 * channels) * 2 / channels + 1;
+  }
+
+  //Decodes one block into interleaved samples. out must hold getSamplesPerBlock(block.size(), channels) frames.
+  //Returns false if the block is truncated.
+  [[nodiscard]] bool decodeBlock(std::span<const std::byte> block, uint32_t channels, std::span<int16_t> out);
+
+  //Encodes interleaved samples into blocks of block_align bytes, padding the last block with silence
+  [[nodiscard]] std::vector<std::byte> encode(std::span<const int16_t> samples, uint32_t channels, uint32_t block_align);
+}
@@ -0,0 +1,237 @@
+#include "pch.hpp"
+#include "audio/audio_internal.hpp"
+#include "audio/audio_device.hpp"
+#include "audio/stream.hpp"
+
+namespace rp::audio {
+  namespace {
+    struct VoiceSlot {
+      uint32_t generation = 1;
+      bool in_use = false;
+      //held until the mixer reports the voice finished, it reads them without locking
+      std::shared_ptr<const SoundData> sound;
+      //shared with the decoder thread, which may hold the last reference for the rest of a pass
+      std::shared_ptr<StreamSource> stream;
+    };
+
+    struct Manager {
+      Properties properties;
+      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<AudioDevice> device;
+
+      //main thread only
+      std::vector<VoiceSlot> slots;
+      std::vector<uint32_t> free_slots;
+
+      std::atomic<bool> stopping = false;
+      std::thread audio_thread;
+
+      //streams the decoder thread keeps topped up, the lock only guards the list and is never held while decoding
+      std::mutex stream_mutex;
+      std::condition_variable stream_cv;
+      std::vector<std::shared_ptr<StreamSource>> streams;
+      std::thread decoder_thread;
+
+      ~Manager() {
+        {
+          std::lock_guard lock(stream_mutex);
+          stopping = true;
+        }
+        stream_cv.notify_all();
+        if(decoder_thread.joinable()) {
+          decoder_thread.join();
+        }
+        if(audio_thread.joinable()) {
+          audio_thread.join();
+        }
+      }
+    };
+
+    std::unique_ptr<Manager> manager;
+
+    Manager& getManager() {
+      if(!manager) {
+        throw std::runtime_error("Audio system used before rp::run initialized it!");
+      }
+      return *manager;
+    }
+
+    void audioThreadMain(Manager& mgr) {
+      std::vector<int16_t> block(size_t{mgr.mixer->getBlockFrames()} * 2);
+      while(!mgr.stopping) {
+        mgr.mixer->mix(block);
+        mgr.device->write(block);
+      }
+    }
+
+    void decoderThreadMain(Manager& mgr) {
+      const auto interval = std::chrono::microseconds(500'000LL * mgr.properties.blockFrames / mgr.properties.sampleRate);
+
+      //decoding and page faults on the mapped files happen outside the lock, so starting or
+      //retiring a stream on the game thread never waits for them
+      std::vector<std::shared_ptr<StreamSource>> pass;
+      std::unique_lock lock(mgr.stream_mutex);
+      while(!mgr.stopping) {
+        pass.assign(mgr.streams.begin(), mgr.streams.end());
+        lock.unlock();
+        for(const auto& stream : pass) {
+          stream->decodeAhead();
+        }
+        //streams retired during the pass are freed here, off the game thread
+        pass.clear();
+        lock.lock();
+        if(!mgr.stopping) {
+          mgr.stream_cv.wait_for(lock, interval);
+        }
+      }
+    }
+
+    VoiceSlot* findSlot(Manager& mgr, VoiceId voice) {
+      if(voice.index >= mgr.slots.size()) {
+        return nullptr;
+      }
+      VoiceSlot& slot = mgr.slots[voice.index];
+      return (slot.in_use && slot.generation == voice.generation) ? &slot : nullptr;
+    }
+
+    VoiceId startVoice(Manager& mgr, std::shared_ptr<const SoundData> sound, std::shared_ptr<StreamSource> stream, const VoiceParams& params) {
+      if(mgr.free_slots.empty()) {
+        log::rp_warn("All {} voices are busy, sound dropped", mgr.slots.size());
+        return {};
+      }
+
+      const uint32_t index = mgr.free_slots.back();
+      MixCommand command;
+      command.type = MixCommand::Type::Play;
+      command.target = index;
+      command.params = params;
+      command.sound = sound.get();
+      command.stream = stream.get();
+      if(!mgr.mixer->submit(command)) {
+        return {};
+      }
+      mgr.free_slots.pop_back();
+
+      VoiceSlot& slot = mgr.slots[index];
+      slot.in_use = true;
+      slot.sound = std::move(sound);
+      if(stream) {
+        std::lock_guard lock(mgr.stream_mutex);
+        mgr.streams.push_back(stream);
+      }
+      slot.stream = std::move(stream);
+      return {index, slot.generation};
+    }
+
+    void submitCommand(MixCommand::Type type, uint32_t target, float value) {
+      MixCommand command;
+      command.type = type;
+      command.target = target;
+      command.value = value;
+      getManager().mixer->submit(command);
+    }
+
+    void submitVoice(VoiceId voice, MixCommand::Type type, float value) {
+      if(findSlot(getManager(), voice)) {
+        submitCommand(type, voice.index, value);
+      }
+    }
+  }
+
+  void init(const Properties& properties) {
+    manager = std::make_unique<Manager>();
+    manager->properties = properties;
+    manager->mixer = std::make_unique<Mixer>(properties.sampleRate, properties.blockFrames, properties.maxVoices);
+    manager->device = createAudioDevice(properties);
+
+    manager->slots.resize(properties.maxVoices);
+    for(uint32_t i = properties.maxVoices; i > 0; i--) {
+      manager->free_slots.push_back(i - 1);
+    }
+
+    manager->audio_thread = std::thread(audioThreadMain, std::ref(*manager));
+    manager->decoder_thread = std::thread(decoderThreadMain, std::ref(*manager));
+
+    log::rp_info("Audio started ({} output, {} Hz, {} frame blocks, {} voices)",
+      manager->device->getName(), properties.sampleRate, properties.blockFrames, properties.maxVoices);
+  }
+
+  void update() {
+    auto& mgr = getManager();
+    while(auto index = mgr.mixer->popFinished()) {
+      VoiceSlot& slot = mgr.slots[*index];
+      if(slot.stream) {
+        std::lock_guard lock(mgr.stream_mutex);
+        std::erase(mgr.streams, slot.stream);
+      }
+      slot.stream.reset();
+      slot.sound.reset();
+      slot.in_use = false;
+      //skip 0 so a default constructed VoiceId never matches
+      slot.generation = (slot.generation + 1 == 0) ? 1 : slot.generation + 1;
+      mgr.free_slots.push_back(*index);
+    }
+  }
+
+  void shutdown() {
+    if(manager) {
+      const MixStats stats = manager->mixer->getStats();
+      log::rp_info("Audio mixed {} blocks, {:.1f}us average / {:.1f}us max of a {:.1f}us budget, {} stream underruns",
+        stats.blocks, stats.average_mix_us, stats.max_mix_us, stats.block_us, stats.stream_underruns);
+    }
+    manager.reset();
+  }
+
+  VoiceId play(const Sound& sound, const VoiceParams& params) {
+    auto& mgr = getManager();
+    if(!sound.isValid()) {
+      return {};
+    }
+    return startVoice(mgr, sound.getData(), nullptr, params);
+  }
+
+  VoiceId playStream(const std::filesystem::path& path, const VoiceParams& params) {
+    auto& mgr = getManager();
+    const uint32_t buffer_frames = static_cast<uint32_t>(uint64_t{mgr.properties.sampleRate} * mgr.properties.streamBufferMs / 1000);
+    auto stream = StreamSource::Open(path, std::max(buffer_frames, mgr.properties.blockFrames * 2), params.loop);
+    //prime the buffer so the first blocks don't underrun
+    stream->decodeAhead();
+    return startVoice(mgr, nullptr, std::move(stream), params);
+  }
+
+  void stop(VoiceId voice) {
+    submitVoice(voice, MixCommand::Type::Stop, 0.0f);
+  }
+
+  bool isPlaying(VoiceId voice) {
+    return findSlot(getManager(), voice) != nullptr;
+  }
+
+  void setVolume(VoiceId voice, float volume) {
+    submitVoice(voice, MixCommand::Type::SetVolume, volume);
+  }
+
+  void setPan(VoiceId voice, float pan) {
+    submitVoice(voice, MixCommand::Type::SetPan, pan);
+  }
+
+  void setPitch(VoiceId voice, float pitch) {
+    submitVoice(voice, MixCommand::Type::SetPitch, pitch);
+  }
+
+  void setBusVolume(Bus bus, float volume) {
+    submitCommand(MixCommand::Type::SetBusVolume, static_cast<uint32_t>(bus), volume);
+  }
+
+  void setBusLowpass(Bus bus, float cutoff_hz) {
+    submitCommand(MixCommand::Type::SetBusLowpass, static_cast<uint32_t>(bus), cutoff_hz);
+  }
+
+  void setMasterVolume(float volume) {
+    submitCommand(MixCommand::Type::SetMasterVolume, 0, volume);
+  }
+
+  MixStats getStats() {
+    return getManager().mixer->getStats();
+  }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "audio/mixer.hpp"
+#include "audio/sound.hpp"
+
+//Audio playback
+//
+//Voices are mixed on a dedicated audio thread in fixed-size blocks and handed to the output
+//device. Calls here only post commands to the mixer through a lock-free queue, so they never
+//wait on mixing. Streamed voices are decoded ahead of playback on a separate decoder thread.
+//The Wav backend writes the mix to a file instead of a sound card, for headless runs and CI.
+//All functions here must be called from the main thread.
+namespace rp::audio {
+  enum class Backend : uint8_t {
+    Device,  //the platform output device, falls back to None if it can't be opened
+    Wav,
+    None,    //mixes and discards the output
+  };
+
+  struct Properties {
+    Backend backend = Backend::Device;
+    uint32_t sampleRate = 48000;
+    uint32_t blockFrames = 512;
+    uint32_t maxVoices = 128;
+    uint32_t streamBufferMs = 500;
+    std::filesystem::path wavPath = "rapier_audio.wav";
+    bool wavRealtime = true;  //pace Wav and None output at playback speed instead of mixing flat out
+  };
+
+  struct VoiceId {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool isValid() const noexcept { return generation != 0; }
+  };
+
+  //Returns an invalid id if every voice is busy
+  VoiceId play(const Sound& sound, const VoiceParams& params = {});
+  //Streams a WAV file from disk. Throws std::runtime_error if it can't be opened.
+  VoiceId playStream(const std::filesystem::path& path, const VoiceParams& params = {});
+
+  void stop(VoiceId voice);
+  [[nodiscard]] bool isPlaying(VoiceId voice);
+
+  void setVolume(VoiceId voice, float volume);
+  void setPan(VoiceId voice, float pan);
+  void setPitch(VoiceId voice, float pitch);
+
+  void setBusVolume(Bus bus, float volume);
+  //Cutoff in Hz, 0 disables the filter
+  void setBusLowpass(Bus bus, float cutoff_hz);
+  void setMasterVolume(float volume);
+
+  [[nodiscard]] MixStats getStats();
+}
@@ -0,0 +1,82 @@
+#include "pch.hpp"
+
+#include "audio/audio_device.hpp"
+#include "audio/wav.hpp"
+#include "platform/win32_audio_device.hpp"
+
+namespace rp::audio {
+  namespace {
+    //Sleeps so blocks are released no faster than they would play
+    class Pacer {
+    public:
+      Pacer(uint32_t sample_rate, bool enabled) : mSampleRate(sample_rate), mEnabled(enabled) {}
+
+      void wait(size_t frames) {
+        if(!mEnabled) {
+          return;
+        }
+        if(mFrames == 0) {
+          mStart = std::chrono::steady_clock::now();
+        }
+        mFrames += frames;
+        std::this_thread::sleep_until(mStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(static_cast<double>(mFrames) / mSampleRate)));
+      }
+
+    private:
+      uint32_t mSampleRate;
+      bool mEnabled;
+      uint64_t mFrames = 0;
+      std::chrono::steady_clock::time_point mStart;
+    };
+
+    class WavAudioDevice : public AudioDevice {
+    public:
+      WavAudioDevice(const std::filesystem::path& path, uint32_t sample_rate, bool realtime)
+        : mWriter(path, sample_rate, 2), mPacer(sample_rate, realtime) {}
+
+      void write(std::span<const int16_t> samples) override {
+        mWriter.write(samples);
+        mPacer.wait(samples.size() / 2);
+      }
+
+      const char* getName() const override { return "wav"; }
+
+    private:
+      WavWriter mWriter;
+      Pacer mPacer;
+    };
+
+    class NullAudioDevice : public AudioDevice {
+    public:
+      NullAudioDevice(uint32_t sample_rate, bool realtime) : mPacer(sample_rate, realtime) {}
+
+      void write(std::span<const int16_t> samples) override {
+        mPacer.wait(samples.size() / 2);
+      }
+
+      const char* getName() const override { return "none"; }
+
+    private:
+      Pacer mPacer;
+    };
+  }
+
+  std::unique_ptr<AudioDevice> createAudioDevice(const Properties& properties) {
+    switch(properties.backend) {
+      case Backend::Device:
+        try {
+          return std::make_unique<Win32AudioDevice>(properties.sampleRate, properties.blockFrames);
+        } catch(std::exception& e) {
+          log::rp_warn("No audio output, {}", e.what());
+          return std::make_unique<NullAudioDevice>(properties.sampleRate, true);
+        }
+      case Backend::Wav:
+        log::rp_info("Writing audio to {}", properties.wavPath.string());
+        return std::make_unique<WavAudioDevice>(properties.wavPath, properties.sampleRate, properties.wavRealtime);
+      case Backend::None:
+        break;
+    }
+    return std::make_unique<NullAudioDevice>(properties.sampleRate, properties.wavRealtime);
+  }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "audio/audio.hpp"
+
+namespace rp::audio {
+  //Sink for mixed blocks of interleaved 16 bit stereo, written from the audio thread.
+  //write() blocks until the device has room, which is what paces the mixer.
+  class AudioDevice {
+  public:
+    virtual ~AudioDevice() = default;
+
+    virtual void write(std::span<const int16_t> samples) = 0;
+    [[nodiscard]] virtual const char* getName() const = 0;
+  };
+
+  std::unique_ptr<AudioDevice> createAudioDevice(const Properties& properties);
+}
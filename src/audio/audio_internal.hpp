@@ -0,0 +1,12 @@
+#pragma once
+
+#include "audio/audio.hpp"
+
+namespace rp::audio {
+  void init(const Properties& properties);
+
+  //Reclaims the voices the mixer has finished with, called once per frame
+  void update();
+
+  void shutdown();
+}
@@ -0,0 +1,186 @@
+#include "pch.hpp"
+
+#include <cmath>
+
+#include "audio/mix_kernels.hpp"
+#include "util/simd.hpp"
+
+namespace rp::audio::kernels {
+  namespace {
+    constexpr float fraction_scale = 1.0f / 4294967296.0f;
+
+    //x(27 + x^2) / (27 + 9x^2), a tanh approximation reaching exactly +-1 at +-3
+    inline float softClip(float x) {
+      x = std::clamp(x, -3.0f, 3.0f);
+      const float x2 = x * x;
+      return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+  }
+
+  void resampleMix(const float* src, uint32_t channels, uint64_t position, uint64_t step, size_t frames,
+                   float* out_left, float* out_right, Gain start, Gain end) {
+    if(frames == 0) {
+      return;
+    }
+    const float inv_frames = 1.0f / static_cast<float>(frames);
+    const float delta_left = (end.left - start.left) * inv_frames;
+    const float delta_right = (end.right - start.right) * inv_frames;
+    const bool stereo = (channels == 2);
+
+    size_t i = 0;
+#if RP_SSE2
+    const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    __m128 gain_left = _mm_add_ps(_mm_set1_ps(start.left), _mm_mul_ps(lane, _mm_set1_ps(delta_left)));
+    __m128 gain_right = _mm_add_ps(_mm_set1_ps(start.right), _mm_mul_ps(lane, _mm_set1_ps(delta_right)));
+    const __m128 gain_left_step = _mm_set1_ps(delta_left * 4.0f);
+    const __m128 gain_right_step = _mm_set1_ps(delta_right * 4.0f);
+
+    auto mix4 = [&](__m128 left, __m128 right) {
+      _mm_storeu_ps(out_left + i, _mm_add_ps(_mm_loadu_ps(out_left + i), _mm_mul_ps(left, gain_left)));
+      _mm_storeu_ps(out_right + i, _mm_add_ps(_mm_loadu_ps(out_right + i), _mm_mul_ps(right, gain_right)));
+      gain_left = _mm_add_ps(gain_left, gain_left_step);
+      gain_right = _mm_add_ps(gain_right, gain_right_step);
+    };
+
+    if(step == fixed_one && (position & (fixed_one - 1)) == 0) {
+      //playing at the source rate, no interpolation needed
+      const float* base = src + (position >> 32) * channels;
+      for(; i + 4 <= frames; i += 4) {
+        if(stereo) {
+          const __m128 a = _mm_loadu_ps(base + i * 2);
+          const __m128 b = _mm_loadu_ps(base + i * 2 + 4);
+          mix4(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        } else {
+          const __m128 s = _mm_loadu_ps(base + i);
+          mix4(s, s);
+        }
+      }
+    } else {
+      //gather the two neighbouring frames per lane, then interpolate four lanes at once.
+      //Lanes are built in registers, building them in memory stalls on store forwarding.
+      for(; i + 4 <= frames; i += 4) {
+        const uint64_t p0 = position + i * step, p1 = p0 + step, p2 = p1 + step, p3 = p2 + step;
+        const float* s0 = src + static_cast<size_t>(p0 >> 32) * channels;
+        const float* s1 = src + static_cast<size_t>(p1 >> 32) * channels;
+        const float* s2 = src + static_cast<size_t>(p2 >> 32) * channels;
+        const float* s3 = src + static_cast<size_t>(p3 >> 32) * channels;
+        const __m128 f = _mm_mul_ps(_mm_set_ps(static_cast<float>(static_cast<uint32_t>(p3)), static_cast<float>(static_cast<uint32_t>(p2)),
+                                               static_cast<float>(static_cast<uint32_t>(p1)), static_cast<float>(static_cast<uint32_t>(p0))),
+                                    _mm_set1_ps(fraction_scale));
+        const __m128 l0 = _mm_set_ps(s3[0], s2[0], s1[0], s0[0]);
+        const __m128 l1 = _mm_set_ps(s3[channels], s2[channels], s1[channels], s0[channels]);
+        const __m128 left = _mm_add_ps(l0, _mm_mul_ps(_mm_sub_ps(l1, l0), f));
+        if(stereo) {
+          const __m128 r0 = _mm_set_ps(s3[1], s2[1], s1[1], s0[1]);
+          const __m128 r1 = _mm_set_ps(s3[3], s2[3], s1[3], s0[3]);
+          mix4(left, _mm_add_ps(r0, _mm_mul_ps(_mm_sub_ps(r1, r0), f)));
+        } else {
+          mix4(left, left);
+        }
+      }
+    }
+#endif
+
+    for(; i < frames; i++) {
+      const uint64_t p = position + i * step;
+      const size_t index = static_cast<size_t>(p >> 32) * channels;
+      const float f = static_cast<float>(static_cast<uint32_t>(p)) * fraction_scale;
+      const float left = src[index] + (src[index + channels] - src[index]) * f;
+      const float right = src[index + stereo] + (src[index + channels + stereo] - src[index + stereo]) * f;
+      out_left[i] += left * (start.left + static_cast<float>(i) * delta_left);
+      out_right[i] += right * (start.right + static_cast<float>(i) * delta_right);
+    }
+  }
+
+  void applyGain(float* samples, size_t count, float start, float end) {
+    if(count == 0) {
+      return;
+    }
+    const float delta = (end - start) / static_cast<float>(count);
+    size_t i = 0;
+#if RP_SSE2
+    __m128 gain = _mm_add_ps(_mm_set1_ps(start), _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), _mm_set1_ps(delta)));
+    const __m128 gain_step = _mm_set1_ps(delta * 4.0f);
+    for(; i + 4 <= count; i += 4) {
+      _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gain));
+      gain = _mm_add_ps(gain, gain_step);
+    }
+#endif
+    for(; i < count; i++) {
+      samples[i] *= start + static_cast<float>(i) * delta;
+    }
+  }
+
+  void accumulate(float* dst, const float* src, size_t count) {
+    size_t i = 0;
+#if RP_SSE2
+    for(; i + 4 <= count; i += 4) {
+      _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    }
+#endif
+    for(; i < count; i++) {
+      dst[i] += src[i];
+    }
+  }
+
+  void lowpass(float* left, float* right, size_t frames, float coefficient, std::array<float, 2>& state) {
+    //y[n] = y[n-1] + a(x[n] - y[n-1])
+    const float a = coefficient;
+    std::array<float*, 2> channels{left, right};
+    for(size_t c = 0; c < 2; c++) {
+      float* x = channels[c];
+      float y = state[c];
+      size_t i = 0;
+#if RP_SSE2
+      const float b = 1.0f - a;
+      //unrolled four samples ahead: y[n+k] = b^(k+1) y[n-1] + sum over j <= k of a b^(k-j) x[n+j]
+      const __m128 decay = _mm_set_ps(b * b * b * b, b * b * b, b * b, b);
+      const __m128 column0 = _mm_set_ps(a * b * b * b, a * b * b, a * b, a);
+      const __m128 column1 = _mm_set_ps(a * b * b, a * b, a, 0.0f);
+      const __m128 column2 = _mm_set_ps(a * b, a, 0.0f, 0.0f);
+      const __m128 column3 = _mm_set_ps(a, 0.0f, 0.0f, 0.0f);
+      for(; i + 4 <= frames; i += 4) {
+        __m128 out = _mm_mul_ps(decay, _mm_set1_ps(y));
+        out = _mm_add_ps(out, _mm_mul_ps(column0, _mm_set1_ps(x[i])));
+        out = _mm_add_ps(out, _mm_mul_ps(column1, _mm_set1_ps(x[i + 1])));
+        out = _mm_add_ps(out, _mm_mul_ps(column2, _mm_set1_ps(x[i + 2])));
+        out = _mm_add_ps(out, _mm_mul_ps(column3, _mm_set1_ps(x[i + 3])));
+        _mm_storeu_ps(x + i, out);
+        y = x[i + 3];
+      }
+#endif
+      for(; i < frames; i++) {
+        y += a * (x[i] - y);
+        x[i] = y;
+      }
+      state[c] = y;
+    }
+  }
+
+  void softClipToInt16(const float* left, const float* right, size_t frames, int16_t* out) {
+    size_t i = 0;
+#if RP_SSE2
+    const __m128 limit = _mm_set1_ps(3.0f);
+    const __m128 c27 = _mm_set1_ps(27.0f);
+    const __m128 c9 = _mm_set1_ps(9.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    auto clip = [&](__m128 x) {
+      x = _mm_min_ps(_mm_max_ps(x, _mm_sub_ps(_mm_setzero_ps(), limit)), limit);
+      const __m128 x2 = _mm_mul_ps(x, x);
+      const __m128 y = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, x2)), _mm_add_ps(c27, _mm_mul_ps(c9, x2)));
+      return _mm_mul_ps(y, scale);
+    };
+    for(; i + 4 <= frames; i += 4) {
+      const __m128 l = clip(_mm_loadu_ps(left + i));
+      const __m128 r = clip(_mm_loadu_ps(right + i));
+      const __m128i low = _mm_cvtps_epi32(_mm_unpacklo_ps(l, r));
+      const __m128i high = _mm_cvtps_epi32(_mm_unpackhi_ps(l, r));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_packs_epi32(low, high));
+    }
+#endif
+    for(; i < frames; i++) {
+      out[i * 2] = static_cast<int16_t>(std::lrint(softClip(left[i]) * 32767.0f));
+      out[i * 2 + 1] = static_cast<int16_t>(std::lrint(softClip(right[i]) * 32767.0f));
+    }
+  }
+}
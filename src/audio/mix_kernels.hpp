@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//Inner loops of the mixer, vectorized with SSE2 where available.
+//Buffers are planar, one array per channel, except for source samples and the final output.
+namespace rp::audio::kernels {
+  //Source positions are 32.32 fixed point frame offsets
+  constexpr uint64_t fixed_one = uint64_t{1} << 32;
+
+  struct Gain {
+    float left;
+    float right;
+  };
+
+  //Resamples interleaved mono or stereo src with linear interpolation and adds it to out_left/out_right,
+  //ramping the gain from start to end over the block. src must hold every frame the block reads,
+  //including the one after the last position.
+  void resampleMix(const float* src, uint32_t channels, uint64_t position, uint64_t step, size_t frames,
+                   float* out_left, float* out_right, Gain start, Gain end);
+
+  //Multiplies by a gain ramping from start to end
+  void applyGain(float* samples, size_t count, float start, float end);
+
+  //dst += src
+  void accumulate(float* dst, const float* src, size_t count);
+
+  //One pole lowpass over both channels at once, state carries across blocks
+  void lowpass(float* left, float* right, size_t frames, float coefficient, std::array<float, 2>& state);
+
+  //Soft clips to [-1, 1] and interleaves into 16 bit output
+  void softClipToInt16(const float* left, const float* right, size_t frames, int16_t* out);
+}
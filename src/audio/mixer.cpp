@@ -0,0 +1,249 @@
+#include "pch.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#include "audio/mixer.hpp"
+
+namespace rp::audio {
+  namespace {
+    constexpr size_t command_capacity = 1024;
+    constexpr double max_step = 8.0;  //source frames per output frame, bounds the scratch buffer
+    constexpr float pi = 3.14159265f;
+  }
+
+  Mixer::Mixer(uint32_t sample_rate, uint32_t block_frames, uint32_t max_voices)
+    : mSampleRate(sample_rate),
+      mBlockFrames(block_frames),
+      mVoices(max_voices),
+      mBusSamples(size_t{block_frames} * 2 * (bus_count + 1)),
+      mSourceScratch((static_cast<size_t>(block_frames * max_step) + 2) * 2),
+      mCommands(command_capacity),
+      mFinished(size_t{max_voices} * 2) {
+    if(sample_rate == 0 || block_frames == 0 || max_voices == 0) {
+      throw std::invalid_argument("Mixer sample rate, block size and voice count must be positive");
+    }
+  }
+
+  bool Mixer::submit(const MixCommand& command) {
+    if(!mCommands.push(command)) {
+      mDroppedCommands.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  std::optional<uint32_t> Mixer::popFinished() {
+    return mFinished.pop();
+  }
+
+  MixStats Mixer::getStats() const {
+    MixStats stats;
+    stats.blocks = mBlocks.load(std::memory_order_relaxed);
+    stats.active_voices = mActiveVoices.load(std::memory_order_relaxed);
+    stats.peak_voices = mPeakVoices.load(std::memory_order_relaxed);
+    stats.stream_underruns = mUnderruns.load(std::memory_order_relaxed);
+    stats.dropped_commands = mDroppedCommands.load(std::memory_order_relaxed);
+    stats.last_mix_us = static_cast<double>(mLastMixNs.load(std::memory_order_relaxed)) / 1000.0;
+    stats.max_mix_us = static_cast<double>(mMaxMixNs.load(std::memory_order_relaxed)) / 1000.0;
+    stats.average_mix_us = stats.blocks ? static_cast<double>(mTotalMixNs.load(std::memory_order_relaxed)) / 1000.0 / static_cast<double>(stats.blocks) : 0.0;
+    stats.block_us = 1e6 * mBlockFrames / mSampleRate;
+    return stats;
+  }
+
+  void Mixer::apply(const MixCommand& command) {
+    using Type = MixCommand::Type;
+    if(command.type == Type::SetBusVolume || command.type == Type::SetBusLowpass) {
+      if(command.target >= bus_count) {
+        return;
+      }
+      BusState& bus = mBuses[command.target];
+      if(command.type == Type::SetBusVolume) {
+        bus.volume = std::max(command.value, 0.0f);
+      } else {
+        const float nyquist = 0.5f * static_cast<float>(mSampleRate);
+        bus.lowpass_coefficient = (command.value >= nyquist || command.value <= 0.0f)
+          ? 1.0f
+          : 1.0f - std::exp(-2.0f * pi * command.value / static_cast<float>(mSampleRate));
+      }
+      return;
+    }
+    if(command.type == Type::SetMasterVolume) {
+      mMasterVolume = std::max(command.value, 0.0f);
+      return;
+    }
+    if(command.target >= mVoices.size()) {
+      return;
+    }
+
+    Voice& voice = mVoices[command.target];
+    switch(command.type) {
+      case Type::Play: {
+        voice = {};
+        voice.active = true;
+        voice.sound = command.sound;
+        voice.stream = command.stream;
+        voice.params = command.params;
+        voice.gain = computeGain(voice, command.sound ? command.sound->channels : command.stream->getChannels());
+        //nothing to play, report it finished on the next block
+        voice.finish_pending = (command.sound && command.sound->frame_count == 0);
+        break;
+      }
+      case Type::Stop:
+        voice.stopping = voice.active;
+        break;
+      case Type::SetVolume:
+        voice.params.volume = command.value;
+        break;
+      case Type::SetPan:
+        voice.params.pan = command.value;
+        break;
+      case Type::SetPitch:
+        voice.params.pitch = command.value;
+        break;
+      default:
+        break;
+    }
+  }
+
+  kernels::Gain Mixer::computeGain(const Voice& voice, uint32_t channels) const {
+    const float volume = std::max(voice.params.volume, 0.0f);
+    const float pan = std::clamp(voice.params.pan, -1.0f, 1.0f);
+    if(channels == 1) {
+      //constant power pan
+      const float angle = (pan + 1.0f) * (pi / 4.0f);
+      return {volume * std::cos(angle), volume * std::sin(angle)};
+    }
+    //stereo sources pan as a balance control
+    return {volume * std::min(1.0f, 1.0f - pan), volume * std::min(1.0f, 1.0f + pan)};
+  }
+
+  void Mixer::finish(uint32_t slot, Voice& voice) {
+    voice.sound = nullptr;
+    voice.stream = nullptr;
+    voice.finish_pending = !mFinished.push(slot);
+    voice.active = voice.finish_pending;
+  }
+
+  void Mixer::mixVoice(Voice& voice) {
+    const bool streamed = (voice.stream != nullptr);
+    const uint32_t channels = streamed ? voice.stream->getChannels() : voice.sound->channels;
+    const uint32_t source_rate = streamed ? voice.stream->getSampleRate() : voice.sound->sample_rate;
+    const double rate = static_cast<double>(source_rate) / mSampleRate * std::max(voice.params.pitch, 0.0f);
+    const uint64_t step = static_cast<uint64_t>(std::min(rate, max_step) * static_cast<double>(kernels::fixed_one));
+
+    const uint64_t fraction = voice.position & (kernels::fixed_one - 1);
+    const uint64_t first_frame = voice.position >> 32;
+    const size_t needed = static_cast<size_t>((fraction + step * (mBlockFrames - 1)) >> 32) + 2;
+
+    //find or assemble a contiguous run of every source frame this block reads
+    const float* source = mSourceScratch.data();
+    if(streamed) {
+      const size_t available = voice.stream->peek(mSourceScratch, needed);
+      std::fill(mSourceScratch.begin() + available * channels, mSourceScratch.begin() + needed * channels, 0.0f);
+      //the last frame is only read for interpolation, so a stream that is one frame short is not starving
+      if(available + 1 < needed && !voice.stream->isDecodeComplete()) {
+        mUnderruns.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else {
+      const SoundData& sound = *voice.sound;
+      if(first_frame + needed <= sound.frame_count) {
+        source = sound.samples.data() + first_frame * channels;
+      } else {
+        for(size_t i = 0; i < needed; i++) {
+          uint64_t frame = first_frame + i;
+          if(voice.params.loop) {
+            frame %= sound.frame_count;
+          }
+          for(uint32_t c = 0; c < channels; c++) {
+            mSourceScratch[i * channels + c] = (frame < sound.frame_count) ? sound.samples[frame * channels + c] : 0.0f;
+          }
+        }
+      }
+    }
+
+    const kernels::Gain target = voice.stopping ? kernels::Gain{0.0f, 0.0f} : computeGain(voice, channels);
+    float* bus = mBusSamples.data() + static_cast<size_t>(voice.params.bus) * 2 * mBlockFrames;
+    kernels::resampleMix(source, channels, fraction, step, mBlockFrames, bus, bus + mBlockFrames, voice.gain, target);
+    voice.gain = target;
+
+    const uint64_t end = fraction + step * mBlockFrames;
+    if(streamed) {
+      voice.stream->consume(static_cast<size_t>(end >> 32));
+      voice.position = end & (kernels::fixed_one - 1);
+    } else {
+      voice.position += step * mBlockFrames;
+      if(voice.params.loop) {
+        voice.position %= voice.sound->frame_count * kernels::fixed_one;
+      }
+    }
+  }
+
+  void Mixer::mix(std::span<int16_t> out) {
+    const auto start = std::chrono::steady_clock::now();
+    if(out.size() < size_t{mBlockFrames} * 2) {
+      throw std::invalid_argument(fmt::format("Mix output holds {} samples, expected {}", out.size(), mBlockFrames * 2));
+    }
+
+    while(auto command = mCommands.pop()) {
+      apply(*command);
+    }
+
+    std::fill(mBusSamples.begin(), mBusSamples.end(), 0.0f);
+    uint32_t active = 0;
+    for(uint32_t slot = 0; slot < mVoices.size(); slot++) {
+      Voice& voice = mVoices[slot];
+      if(!voice.active) {
+        continue;
+      }
+      if(voice.finish_pending) {
+        finish(slot, voice);
+        continue;
+      }
+
+      active++;
+      mixVoice(voice);
+
+      const bool ended = voice.stream
+        ? voice.stream->isFinished()
+        : (!voice.params.loop && (voice.position >> 32) >= voice.sound->frame_count);
+      if(ended || voice.stopping) {
+        finish(slot, voice);
+      }
+    }
+
+    //buses into the master pair
+    const size_t frames = mBlockFrames;
+    float* master_left = mBusSamples.data() + bus_count * 2 * frames;
+    float* master_right = master_left + frames;
+    for(size_t b = 0; b < bus_count; b++) {
+      BusState& bus = mBuses[b];
+      float* left = mBusSamples.data() + b * 2 * frames;
+      float* right = left + frames;
+      kernels::applyGain(left, frames, bus.applied_volume, bus.volume);
+      kernels::applyGain(right, frames, bus.applied_volume, bus.volume);
+      bus.applied_volume = bus.volume;
+      if(bus.lowpass_coefficient < 1.0f) {
+        kernels::lowpass(left, right, frames, bus.lowpass_coefficient, bus.lowpass_state);
+      }
+      kernels::accumulate(master_left, left, frames);
+      kernels::accumulate(master_right, right, frames);
+    }
+    kernels::applyGain(master_left, frames, mAppliedMasterVolume, mMasterVolume);
+    kernels::applyGain(master_right, frames, mAppliedMasterVolume, mMasterVolume);
+    mAppliedMasterVolume = mMasterVolume;
+    kernels::softClipToInt16(master_left, master_right, frames, out.data());
+
+    const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    mBlocks.fetch_add(1, std::memory_order_relaxed);
+    mActiveVoices.store(active, std::memory_order_relaxed);
+    if(active > mPeakVoices.load(std::memory_order_relaxed)) {
+      mPeakVoices.store(active, std::memory_order_relaxed);
+    }
+    mLastMixNs.store(elapsed, std::memory_order_relaxed);
+    mTotalMixNs.fetch_add(elapsed, std::memory_order_relaxed);
+    if(elapsed > mMaxMixNs.load(std::memory_order_relaxed)) {
+      mMaxMixNs.store(elapsed, std::memory_order_relaxed);
+    }
+  }
+}
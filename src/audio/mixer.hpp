@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "audio/mix_kernels.hpp"
+#include "audio/sound.hpp"
+#include "audio/stream.hpp"
+#include "util/spsc_queue.hpp"
+
+namespace rp::audio {
+  enum class Bus : uint8_t {
+    Music,
+    Effects,
+    Dialogue,
+    Interface,
+  };
+  constexpr size_t bus_count = 4;
+
+  struct VoiceParams {
+    float volume = 1.0f;
+    float pan = 0.0f;    //-1 left to 1 right
+    float pitch = 1.0f;  //playback rate multiplier
+    bool loop = false;
+    Bus bus = Bus::Effects;
+  };
+
+  struct MixStats {
+    uint64_t blocks = 0;
+    uint32_t active_voices = 0;
+    uint32_t peak_voices = 0;
+    uint64_t stream_underruns = 0;
+    uint64_t dropped_commands = 0;
+    double last_mix_us = 0.0;
+    double average_mix_us = 0.0;
+    double max_mix_us = 0.0;
+    double block_us = 0.0;  //real time length of one block, the budget mixing has to stay under
+  };
+
+  struct MixCommand {
+    enum class Type : uint8_t {
+      Play,
+      Stop,
+      SetVolume,
+      SetPan,
+      SetPitch,
+      SetBusVolume,
+      SetBusLowpass,  //value is the cutoff in Hz, at or above Nyquist disables the filter
+      SetMasterVolume,
+    };
+
+    Type type = Type::Play;
+    uint32_t target = 0;  //voice slot, or bus index for bus commands
+    float value = 0.0f;
+    VoiceParams params;
+    const SoundData* sound = nullptr;
+    StreamSource* stream = nullptr;
+  };
+
+  //Mixes voices into fixed-size blocks of interleaved 16 bit stereo.
+  //Commands are submitted from one thread and applied at the start of the next block on the mixing thread.
+  //The caller owns voice slots: a slot is free again once popFinished() returns it, at which point the
+  //mixer no longer references the voice's sound or stream.
+  class Mixer {
+  public:
+    Mixer(uint32_t sample_rate, uint32_t block_frames, uint32_t max_voices);
+
+    //Producer side, returns false and counts a dropped command if the queue is full
+    bool submit(const MixCommand& command);
+    std::optional<uint32_t> popFinished();
+
+    //Mixing thread, out must hold getBlockFrames() stereo frames
+    void mix(std::span<int16_t> out);
+
+    [[nodiscard]] MixStats getStats() const;
+    [[nodiscard]] uint32_t getSampleRate() const noexcept { return mSampleRate; }
+    [[nodiscard]] uint32_t getBlockFrames() const noexcept { return mBlockFrames; }
+    [[nodiscard]] uint32_t getMaxVoices() const noexcept { return static_cast<uint32_t>(mVoices.size()); }
+
+  private:
+    struct Voice {
+      bool active = false;
+      bool stopping = false;         //fading out over one block
+      bool finish_pending = false;   //finished, waiting for room in the finished queue
+      const SoundData* sound = nullptr;
+      StreamSource* stream = nullptr;
+      uint64_t position = 0;         //32.32 fixed point frames
+      VoiceParams params;
+      kernels::Gain gain{0.0f, 0.0f};
+    };
+
+    struct BusState {
+      float volume = 1.0f;
+      float applied_volume = 1.0f;
+      float lowpass_coefficient = 1.0f;
+      std::array<float, 2> lowpass_state{};
+    };
+
+    void apply(const MixCommand& command);
+    void mixVoice(Voice& voice);
+    void finish(uint32_t slot, Voice& voice);
+    [[nodiscard]] kernels::Gain computeGain(const Voice& voice, uint32_t channels) const;
+
+    uint32_t mSampleRate;
+    uint32_t mBlockFrames;
+    std::vector<Voice> mVoices;
+    std::array<BusState, bus_count> mBuses;
+    float mMasterVolume = 1.0f;
+    float mAppliedMasterVolume = 1.0f;
+
+    std::vector<float> mBusSamples;     //planar left/right for each bus, then the master pair
+    std::vector<float> mSourceScratch;  //contiguous source frames for wrapping and streamed voices
+
+    SpscQueue<MixCommand> mCommands;
+    SpscQueue<uint32_t> mFinished;
+
+    std::atomic<uint64_t> mBlocks = 0;
+    std::atomic<uint32_t> mActiveVoices = 0;
+    std::atomic<uint32_t> mPeakVoices = 0;
+    std::atomic<uint64_t> mUnderruns = 0;
+    std::atomic<uint64_t> mDroppedCommands = 0;
+    std::atomic<uint64_t> mLastMixNs = 0;
+    std::atomic<uint64_t> mTotalMixNs = 0;
+    std::atomic<uint64_t> mMaxMixNs = 0;
+  };
+}
@@ -0,0 +1,42 @@
+#include "pch.hpp"
+#include "audio/sound.hpp"
+#include "audio/wav.hpp"
+#include "util/mapped_file.hpp"
+
+namespace rp::audio {
+  Sound Sound::Load(const std::filesystem::path& path) {
+    MappedFile file(path);
+    try {
+      return FromWav(file.data());
+    } catch(const std::runtime_error& e) {
+      throw std::runtime_error(fmt::format("Failed to load sound {}: {}", path.string(), e.what()));
+    }
+  }
+
+  Sound Sound::FromWav(std::span<const std::byte> bytes) {
+    const WavInfo info = parseWav(bytes);
+    auto data = std::make_shared<SoundData>();
+    data->sample_rate = info.sample_rate;
+    data->channels = info.channels;
+    data->frame_count = info.frame_count;
+    data->samples.resize(static_cast<size_t>(info.frame_count) * info.channels);
+    decodeWav(info, 0, info.frame_count, data->samples);
+    return Sound(std::move(data));
+  }
+
+  Sound Sound::FromSamples(std::vector<float> samples, uint32_t channels, uint32_t sample_rate) {
+    if(channels < 1 || channels > 2 || sample_rate == 0) {
+      throw std::invalid_argument(fmt::format("Unsupported sound layout: {} channels at {}Hz", channels, sample_rate));
+    }
+    auto data = std::make_shared<SoundData>();
+    data->sample_rate = sample_rate;
+    data->channels = channels;
+    data->frame_count = samples.size() / channels;
+    data->samples = std::move(samples);
+    return Sound(std::move(data));
+  }
+
+  double Sound::getDuration() const noexcept {
+    return mData ? static_cast<double>(mData->frame_count) / mData->sample_rate : 0.0;
+  }
+}
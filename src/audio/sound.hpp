@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rp::audio {
+  struct SoundData {
+    uint32_t sample_rate = 0;
+    uint32_t channels = 0;
+    uint64_t frame_count = 0;
+    std::vector<float> samples;  //interleaved
+  };
+
+  //Fully decoded clip, cheap to copy and safe to play on many voices at once.
+  //Suited to short effects, long music should be streamed instead.
+  class Sound {
+  public:
+    Sound() = default;
+
+    //Decodes a WAV file (16 bit PCM, 32 bit float or IMA ADPCM). Throws std::runtime_error on failure.
+    [[nodiscard]] static Sound Load(const std::filesystem::path& path);
+    [[nodiscard]] static Sound FromWav(std::span<const std::byte> bytes);
+    [[nodiscard]] static Sound FromSamples(std::vector<float> samples, uint32_t channels, uint32_t sample_rate);
+
+    [[nodiscard]] bool isValid() const noexcept { return mData != nullptr; }
+    [[nodiscard]] uint32_t getSampleRate() const noexcept { return mData ? mData->sample_rate : 0; }
+    [[nodiscard]] uint32_t getChannels() const noexcept { return mData ? mData->channels : 0; }
+    [[nodiscard]] uint64_t getFrameCount() const noexcept { return mData ? mData->frame_count : 0; }
+    [[nodiscard]] double getDuration() const noexcept;
+
+    [[nodiscard]] const std::shared_ptr<const SoundData>& getData() const noexcept { return mData; }
+
+  private:
+    explicit Sound(std::shared_ptr<const SoundData> data) : mData(std::move(data)) {}
+
+    std::shared_ptr<const SoundData> mData;
+  };
+}
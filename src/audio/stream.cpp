@@ -0,0 +1,95 @@
+#include "pch.hpp"
+
+#include <bit>
+
+#include "audio/stream.hpp"
+#include "util/mapped_file.hpp"
+
+namespace rp::audio {
+  namespace {
+    constexpr uint32_t pcm_decode_frames = 1024;
+  }
+
+  StreamSource::StreamSource(std::shared_ptr<const void> owner, std::span<const std::byte> wav_bytes, uint32_t buffer_frames, bool loop)
+    : mOwner(std::move(owner)),
+      mInfo(parseWav(wav_bytes)),
+      mLoop(loop) {
+    if(mInfo.frame_count == 0) {
+      throw std::runtime_error("Cannot stream an empty sound");
+    }
+
+    //room for at least two decode chunks so the decoder always has somewhere to write
+    const uint32_t chunk = (mInfo.encoding == Encoding::ImaAdpcm) ? mInfo.frames_per_block : pcm_decode_frames;
+    mRingFrames = std::bit_ceil(std::max<size_t>(buffer_frames, size_t{chunk} * 2));
+    mRing.resize(mRingFrames * mInfo.channels);
+    mDecoded.resize(size_t{chunk} * mInfo.channels);
+  }
+
+  std::unique_ptr<StreamSource> StreamSource::Open(const std::filesystem::path& path, uint32_t buffer_frames, bool loop) {
+    auto file = std::make_shared<MappedFile>(path);
+    try {
+      return std::make_unique<StreamSource>(file, file->data(), buffer_frames, loop);
+    } catch(const std::runtime_error& e) {
+      throw std::runtime_error(fmt::format("Failed to open stream {}: {}", path.string(), e.what()));
+    }
+  }
+
+  bool StreamSource::decodeAhead() {
+    const uint32_t chunk = static_cast<uint32_t>(mDecoded.size() / mInfo.channels);
+    bool decoded = false;
+    while(!mEndOfSource.load(std::memory_order_relaxed)) {
+      const uint64_t write = mWriteFrame.load(std::memory_order_relaxed);
+      const uint64_t read = mReadFrame.load(std::memory_order_acquire);
+      if(mRingFrames - (write - read) < chunk) {
+        break;
+      }
+
+      const uint64_t frames = std::min<uint64_t>(chunk, mInfo.frame_count - mSourceFrame);
+      decodeWav(mInfo, mSourceFrame, frames, mDecoded);
+
+      //copy in, wrapping around the end of the ring
+      const size_t start = static_cast<size_t>(write & (mRingFrames - 1));
+      const size_t first = std::min<size_t>(static_cast<size_t>(frames), mRingFrames - start);
+      std::copy_n(mDecoded.begin(), first * mInfo.channels, mRing.begin() + start * mInfo.channels);
+      std::copy_n(mDecoded.begin() + first * mInfo.channels, (frames - first) * mInfo.channels, mRing.begin());
+      mWriteFrame.store(write + frames, std::memory_order_release);
+      decoded = true;
+
+      mSourceFrame += frames;
+      if(mSourceFrame == mInfo.frame_count) {
+        if(mLoop) {
+          mSourceFrame = 0;
+        } else {
+          mEndOfSource.store(true, std::memory_order_release);
+        }
+      }
+    }
+    return decoded;
+  }
+
+  size_t StreamSource::peek(std::span<float> dst, size_t frames) const noexcept {
+    const uint64_t read = mReadFrame.load(std::memory_order_relaxed);
+    const uint64_t write = mWriteFrame.load(std::memory_order_acquire);
+    frames = std::min({frames, static_cast<size_t>(write - read), dst.size() / mInfo.channels});
+
+    const size_t start = static_cast<size_t>(read & (mRingFrames - 1));
+    const size_t first = std::min(frames, mRingFrames - start);
+    std::copy_n(mRing.begin() + start * mInfo.channels, first * mInfo.channels, dst.begin());
+    std::copy_n(mRing.begin(), (frames - first) * mInfo.channels, dst.begin() + first * mInfo.channels);
+    return frames;
+  }
+
+  void StreamSource::consume(size_t frames) noexcept {
+    const uint64_t read = mReadFrame.load(std::memory_order_relaxed);
+    const uint64_t write = mWriteFrame.load(std::memory_order_acquire);
+    mReadFrame.store(read + std::min<uint64_t>(frames, write - read), std::memory_order_release);
+  }
+
+  bool StreamSource::isFinished() const noexcept {
+    return mEndOfSource.load(std::memory_order_acquire) && getBufferedFrames() == 0;
+  }
+
+  size_t StreamSource::getBufferedFrames() const noexcept {
+    return static_cast<size_t>(mWriteFrame.load(std::memory_order_acquire) - mReadFrame.load(std::memory_order_acquire));
+  }
+}
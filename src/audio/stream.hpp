@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "audio/wav.hpp"
+
+namespace rp::audio {
+  //Source that decodes ahead of playback into a ring buffer.
+  //One thread calls decodeAhead() to keep the buffer topped up while the mixer thread reads
+  //from the front; the two sides only share atomics, so neither ever waits on the other.
+  class StreamSource {
+  public:
+    //wav_bytes must outlive the stream, owner is held to keep them alive
+    StreamSource(std::shared_ptr<const void> owner, std::span<const std::byte> wav_bytes, uint32_t buffer_frames, bool loop);
+
+    //Streams straight from a memory mapped file
+    [[nodiscard]] static std::unique_ptr<StreamSource> Open(const std::filesystem::path& path, uint32_t buffer_frames, bool loop);
+
+    //Decoder side. Decodes whole blocks while there is room, returns true if anything was decoded.
+    bool decodeAhead();
+
+    //Mixer side. Copies up to frames interleaved frames from the front without consuming them.
+    size_t peek(std::span<float> dst, size_t frames) const noexcept;
+    void consume(size_t frames) noexcept;
+
+    //The whole source has been decoded and played, never true for looping streams
+    [[nodiscard]] bool isFinished() const noexcept;
+    [[nodiscard]] bool isDecodeComplete() const noexcept { return mEndOfSource.load(std::memory_order_acquire); }
+
+    [[nodiscard]] uint32_t getChannels() const noexcept { return mInfo.channels; }
+    [[nodiscard]] uint32_t getSampleRate() const noexcept { return mInfo.sample_rate; }
+    [[nodiscard]] size_t getBufferedFrames() const noexcept;
+
+  private:
+    std::shared_ptr<const void> mOwner;
+    WavInfo mInfo;
+    bool mLoop;
+
+    std::vector<float> mRing;
+    size_t mRingFrames;  //power of two
+    std::atomic<uint64_t> mReadFrame = 0;
+    std::atomic<uint64_t> mWriteFrame = 0;
+    std::atomic<bool> mEndOfSource = false;
+
+    //decoder only
+    uint64_t mSourceFrame = 0;
+    std::vector<float> mDecoded;
+  };
+}
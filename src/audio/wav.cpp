@@ -0,0 +1,251 @@
+#include "pch.hpp"
+#include "audio/wav.hpp"
+#include "audio/adpcm.hpp"
+
+namespace rp::audio {
+  namespace {
+    constexpr uint16_t format_pcm = 0x0001;
+    constexpr uint16_t format_float = 0x0003;
+    constexpr uint16_t format_ima_adpcm = 0x0011;
+    constexpr uint16_t format_extensible = 0xFFFE;
+
+    uint16_t readU16(const std::byte* p) {
+      return static_cast<uint16_t>(std::to_integer<uint16_t>(p[0]) | (std::to_integer<uint16_t>(p[1]) << 8));
+    }
+
+    uint32_t readU32(const std::byte* p) {
+      return uint32_t{readU16(p)} | (uint32_t{readU16(p + 2)} << 16);
+    }
+
+    void appendU16(std::vector<std::byte>& out, uint16_t value) {
+      out.push_back(static_cast<std::byte>(value & 0xFF));
+      out.push_back(static_cast<std::byte>(value >> 8));
+    }
+
+    void appendU32(std::vector<std::byte>& out, uint32_t value) {
+      appendU16(out, static_cast<uint16_t>(value & 0xFFFF));
+      appendU16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    void appendTag(std::vector<std::byte>& out, const char (&tag)[5]) {
+      for(int i = 0; i < 4; i++) {
+        out.push_back(static_cast<std::byte>(tag[i]));
+      }
+    }
+
+    bool tagIs(const std::byte* p, const char (&tag)[5]) {
+      return std::memcmp(p, tag, 4) == 0;
+    }
+  }
+
+  WavInfo parseWav(std::span<const std::byte> bytes) {
+    if(bytes.size() < 12 || !tagIs(bytes.data(), "RIFF") || !tagIs(bytes.data() + 8, "WAVE")) {
+      throw std::runtime_error("Not a RIFF WAVE file");
+    }
+
+    WavInfo info;
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    std::optional<uint32_t> fact_frames;
+    bool has_format = false, has_data = false;
+
+    size_t offset = 12;
+    while(offset + 8 <= bytes.size()) {
+      const std::byte* chunk = bytes.data() + offset;
+      const uint32_t size = readU32(chunk + 4);
+      if(size > bytes.size() - offset - 8) {
+        //some writers leave the data size unpatched, use what is there
+        if(!tagIs(chunk, "data")) {
+          throw std::runtime_error("Truncated WAV chunk");
+        }
+      }
+      const size_t available = std::min<size_t>(size, bytes.size() - offset - 8);
+      const std::byte* body = chunk + 8;
+
+      if(tagIs(chunk, "fmt ")) {
+        if(available < 16) {
+          throw std::runtime_error("WAV format chunk too small");
+        }
+        format = readU16(body);
+        info.channels = readU16(body + 2);
+        info.sample_rate = readU32(body + 4);
+        info.block_align = readU16(body + 12);
+        bits = readU16(body + 14);
+        if(format == format_extensible && available >= 26) {
+          format = readU16(body + 24);
+        }
+        if(format == format_ima_adpcm && available >= 20) {
+          info.frames_per_block = readU16(body + 18);
+        }
+        has_format = true;
+      } else if(tagIs(chunk, "fact") && available >= 4) {
+        fact_frames = readU32(body);
+      } else if(tagIs(chunk, "data")) {
+        info.data = bytes.subspan(offset + 8, available);
+        has_data = true;
+      }
+
+      offset += 8 + size + (size & 1);
+    }
+
+    if(!has_format || !has_data) {
+      throw std::runtime_error("WAV file is missing its fmt or data chunk");
+    }
+    if(info.channels < 1 || info.channels > 2 || info.sample_rate == 0 || info.block_align == 0) {
+      throw std::runtime_error(fmt::format("Unsupported WAV layout: {} channels at {}Hz", info.channels, info.sample_rate));
+    }
+
+    if(format == format_pcm && bits == 16) {
+      info.encoding = Encoding::Pcm16;
+    } else if(format == format_float && bits == 32) {
+      info.encoding = Encoding::Float32;
+    } else if(format == format_ima_adpcm && bits == 4) {
+      info.encoding = Encoding::ImaAdpcm;
+      const uint32_t expected = adpcm::getSamplesPerBlock(info.block_align, info.channels);
+      //the decoder only fills whole 8 frame groups, matching adpcm::encode
+      if(info.block_align <= 4 * info.channels || (info.block_align - 4 * info.channels) % (4 * info.channels) != 0 ||
+         info.frames_per_block != expected) {
+        throw std::runtime_error(fmt::format("Unsupported IMA ADPCM block layout ({} bytes, {} frames)", info.block_align, info.frames_per_block));
+      }
+    } else {
+      throw std::runtime_error(fmt::format("Unsupported WAV format 0x{:04x} with {} bits per sample", format, bits));
+    }
+
+    if(info.encoding == Encoding::ImaAdpcm) {
+      const uint64_t whole_blocks = info.data.size() / info.block_align;
+      const uint64_t max_frames = whole_blocks * info.frames_per_block;
+      info.frame_count = fact_frames ? std::min<uint64_t>(*fact_frames, max_frames) : max_frames;
+    } else {
+      //decoding reads whole frames of packed samples
+      if(info.block_align != info.channels * bits / 8) {
+        throw std::runtime_error(fmt::format("Unsupported WAV block align {} for {} channels of {} bits", info.block_align, info.channels, bits));
+      }
+      info.frames_per_block = 1;
+      info.frame_count = info.data.size() / info.block_align;
+    }
+    return info;
+  }
+
+  void decodeWav(const WavInfo& info, uint64_t first_frame, uint64_t frame_count, std::span<float> out) {
+    if(first_frame + frame_count > info.frame_count || out.size() < frame_count * info.channels) {
+      throw std::out_of_range("WAV decode range out of bounds");
+    }
+
+    const size_t sample_count = static_cast<size_t>(frame_count) * info.channels;
+    switch(info.encoding) {
+      case Encoding::Pcm16: {
+        const std::byte* src = info.data.data() + first_frame * info.block_align;
+        for(size_t i = 0; i < sample_count; i++) {
+          out[i] = static_cast<int16_t>(readU16(src + i * 2)) * (1.0f / 32768.0f);
+        }
+        break;
+      }
+      case Encoding::Float32:
+        std::memcpy(out.data(), info.data.data() + first_frame * info.block_align, sample_count * sizeof(float));
+        break;
+      case Encoding::ImaAdpcm: {
+        if(first_frame % info.frames_per_block != 0) {
+          throw std::invalid_argument("IMA ADPCM decoding must start on a block boundary");
+        }
+        std::vector<int16_t> block(size_t{info.frames_per_block} * info.channels);
+        uint64_t block_index = first_frame / info.frames_per_block;
+        size_t written = 0;
+        while(written < sample_count) {
+          if(!adpcm::decodeBlock(info.data.subspan(block_index * info.block_align, info.block_align), info.channels, block)) {
+            throw std::runtime_error("Corrupt IMA ADPCM block");
+          }
+          const size_t count = std::min(block.size(), sample_count - written);
+          for(size_t i = 0; i < count; i++) {
+            out[written + i] = block[i] * (1.0f / 32768.0f);
+          }
+          written += count;
+          block_index++;
+        }
+        break;
+      }
+    }
+  }
+
+  std::vector<std::byte> makeWav(const WavInfo& info) {
+    const bool adpcm = (info.encoding == Encoding::ImaAdpcm);
+    const uint16_t format = adpcm ? format_ima_adpcm : (info.encoding == Encoding::Float32 ? format_float : format_pcm);
+    const uint16_t bits = adpcm ? 4 : (info.encoding == Encoding::Float32 ? 32 : 16);
+    const uint32_t format_size = adpcm ? 20 : 16;
+    const uint32_t data_size = static_cast<uint32_t>(info.data.size());
+    const uint32_t byte_rate = adpcm
+      ? static_cast<uint32_t>(uint64_t{info.sample_rate} * info.block_align / info.frames_per_block)
+      : info.sample_rate * info.block_align;
+
+    std::vector<std::byte> out;
+    out.reserve(60 + info.data.size());
+    appendTag(out, "RIFF");
+    appendU32(out, 4 + (8 + format_size) + (adpcm ? 12 : 0) + 8 + data_size + (data_size & 1));
+    appendTag(out, "WAVE");
+
+    appendTag(out, "fmt ");
+    appendU32(out, format_size);
+    appendU16(out, format);
+    appendU16(out, static_cast<uint16_t>(info.channels));
+    appendU32(out, info.sample_rate);
+    appendU32(out, byte_rate);
+    appendU16(out, static_cast<uint16_t>(info.block_align));
+    appendU16(out, bits);
+    if(adpcm) {
+      appendU16(out, 2);
+      appendU16(out, static_cast<uint16_t>(info.frames_per_block));
+      appendTag(out, "fact");
+      appendU32(out, 4);
+      appendU32(out, static_cast<uint32_t>(info.frame_count));
+    }
+
+    appendTag(out, "data");
+    appendU32(out, data_size);
+    out.insert(out.end(), info.data.begin(), info.data.end());
+    if(data_size & 1) {
+      out.push_back(std::byte{0});
+    }
+    return out;
+  }
+
+  WavWriter::WavWriter(const std::filesystem::path& path, uint32_t sample_rate, uint32_t channels)
+    : mFile(path, std::ios::binary | std::ios::trunc),
+      mChannels(channels) {
+    if(!mFile) {
+      throw std::runtime_error(fmt::format("Failed to open {} for writing", path.string()));
+    }
+
+    //header with zero sizes, patched by close()
+    WavInfo info;
+    info.sample_rate = sample_rate;
+    info.channels = channels;
+    info.block_align = channels * 2;
+    const auto header = makeWav(info);
+    mFile.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+  }
+
+  WavWriter::~WavWriter() {
+    close();
+  }
+
+  void WavWriter::write(std::span<const int16_t> samples) {
+    //WAV is little endian, as are all of our targets
+    mFile.write(reinterpret_cast<const char*>(samples.data()), static_cast<std::streamsize>(samples.size_bytes()));
+    mFrames += samples.size() / mChannels;
+  }
+
+  void WavWriter::close() {
+    if(!mFile.is_open()) {
+      return;
+    }
+
+    const uint32_t data_size = static_cast<uint32_t>(mFrames * mChannels * 2);
+    std::vector<std::byte> size_bytes;
+    appendU32(size_bytes, 36 + data_size);
+    appendU32(size_bytes, data_size);
+    mFile.seekp(4);
+    mFile.write(reinterpret_cast<const char*>(size_bytes.data()), 4);
+    mFile.seekp(40);
+    mFile.write(reinterpret_cast<const char*>(size_bytes.data() + 4), 4);
+    mFile.close();
+  }
+}
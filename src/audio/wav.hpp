@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+namespace rp::audio {
+  enum class Encoding : uint8_t {
+    Pcm16,
+    Float32,
+    ImaAdpcm,
+  };
+
+  //Format and sample data of a WAV file, pointing into the parsed bytes
+  struct WavInfo {
+    Encoding encoding = Encoding::Pcm16;
+    uint32_t sample_rate = 0;
+    uint32_t channels = 0;
+    uint32_t block_align = 0;        //bytes per frame, or per compressed block
+    uint32_t frames_per_block = 1;
+    uint64_t frame_count = 0;
+    std::span<const std::byte> data;
+  };
+
+  //Throws std::runtime_error for malformed or unsupported files
+  [[nodiscard]] WavInfo parseWav(std::span<const std::byte> bytes);
+
+  //Converts frame_count frames starting at first_frame to interleaved floats. Compressed data must start on a block.
+  void decodeWav(const WavInfo& info, uint64_t first_frame, uint64_t frame_count, std::span<float> out);
+
+  //Builds a complete WAV file in memory
+  [[nodiscard]] std::vector<std::byte> makeWav(const WavInfo& info);
+
+  //Streams 16 bit PCM to disk, patching the header sizes on close
+  class WavWriter {
+  public:
+    WavWriter(const std::filesystem::path& path, uint32_t sample_rate, uint32_t channels);
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    void write(std::span<const int16_t> samples);
+    void close();
+
+    [[nodiscard]] uint64_t getFrameCount() const noexcept { return mFrames; }
+
+  private:
+    std::ofstream mFile;
+    uint32_t mChannels;
+    uint64_t mFrames = 0;
+  };
+}
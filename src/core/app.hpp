@@ -6,6 +6,9 @@ namespace rp {
   class App {
   public:
     virtual ~App() = default;  
+    //Runs on a worker thread while the engine creates the window, before init. Meant for
+    //preparing CPU side data, rp::asset and other main thread only APIs are off limits here
+    virtual void load() {}
     virtual void init() = 0;
     virtual void onEvent(const rp::Event& e) = 0;
     virtual void update() = 0;
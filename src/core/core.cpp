@@ -3,10 +3,70 @@
 #include "core/core.hpp"
 #include "core/app.hpp"
 #include "core/window.hpp"
+#include "core/event_queue.hpp"
+#include "core/startup.hpp"
+#include "asset/asset_internal.hpp"
+#include "metrics/metrics_internal.hpp"
+#include "audio/audio_internal.hpp"
+#include "physics/physics_internal.hpp"
+#include "snapshot/snapshot_internal.hpp"
+#include "timers/timers_internal.hpp"
+#include "util/util.hpp"
 #include "util/version.hpp"
 
 
 namespace rp {
+  namespace {
+    std::vector<StartupPhase> startup_timeline;
+
+    //Engine counters, published to rp::metrics at the end of every frame
+    struct EngineMetrics {
+      metrics::Counter frames = metrics::getCounter("engine.frames");
+      metrics::Gauge frame_ms = metrics::getGauge("engine.frame_ms");
+      metrics::Histogram frame_us = metrics::getHistogram("engine.frame_us");
+      metrics::Counter events = metrics::getCounter("engine.events");
+      metrics::Gauge events_per_frame = metrics::getGauge("engine.events_per_frame");
+      std::array<metrics::Counter, INDEX_CAST(log::Level::ENUM_SIZE)> log_messages = {
+        metrics::getCounter("log.trace"),
+        metrics::getCounter("log.info"),
+        metrics::getCounter("log.warn"),
+        metrics::getCounter("log.error"),
+      };
+      metrics::Gauge asset_queue_depth = metrics::getGauge("asset.queue_depth");
+      metrics::Gauge asset_resident_bytes = metrics::getGauge("asset.resident_bytes");
+      metrics::Gauge audio_voices = metrics::getGauge("audio.active_voices");
+      metrics::Gauge audio_mix_us = metrics::getGauge("audio.mix_us");
+      metrics::Counter audio_underruns = metrics::getCounter("audio.stream_underruns");
+      metrics::Counter audio_dropped_commands = metrics::getCounter("audio.dropped_commands");
+      metrics::Gauge timers_pending = metrics::getGauge("timers.pending");
+
+      void publish(float frame_seconds, size_t event_count) {
+        frames.add();
+        frame_ms.set(frame_seconds * 1000.0);
+        frame_us.record(static_cast<uint64_t>(frame_seconds * 1e6f));
+        events.add(event_count);
+        events_per_frame.set(static_cast<double>(event_count));
+        for(size_t i = 0; i < log_messages.size(); i++) {
+          log_messages[i].set(log::getMessageCount(static_cast<log::Level>(i)));
+        }
+
+        asset_queue_depth.set(static_cast<double>(asset::getQueueDepth()));
+        asset_resident_bytes.set(static_cast<double>(asset::getResidentBytes()));
+        const auto mix = audio::getStats();
+        audio_voices.set(mix.active_voices);
+        audio_mix_us.set(mix.last_mix_us);
+        audio_underruns.set(mix.stream_underruns);
+        audio_dropped_commands.set(mix.dropped_commands);
+        timers_pending.set(static_cast<double>(timers::getPendingCount()));
+        metrics::beat();
+      }
+    };
+  }
+
+  const std::vector<StartupPhase>& getStartupTimeline() {
+    return startup_timeline;
+  }
+
   void run(std::unique_ptr<App> app, StartupProperties startupProperties) {
     try {
       log::rp_info(log::horiz_rule);
@@ -17,10 +77,35 @@ namespace rp {
       log::rp_info("Initializing Rapier!");
       log::rp_info(log::horiz_rule);
 
-      auto window = createWindow(startupProperties.windowProperties);
-      window->setCallback([&](const Event& e) { app->onEvent(e); });
-
-      app->init();
+      //up before the graph so every subsystem can register metrics from its init
+      metrics::init(startupProperties.metricsProperties);
+
+      //Independent steps run on the startup pool, the window is created on the main thread
+      //since it owns the message loop, while the app loads its data on a worker
+      std::unique_ptr<Window> window;
+      SubsystemGraph subsystems;
+      subsystems.add({"asset", {}, [&]() { asset::init(startupProperties.assetProperties); }, []() { asset::shutdown(); }});
+      subsystems.add({"audio", {}, [&]() { audio::init(startupProperties.audioProperties); }, []() { audio::shutdown(); }});
+      subsystems.add({"timers", {}, [&]() { timers::init(startupProperties.timersProperties); }, []() { timers::shutdown(); }});
+      subsystems.add({"window", {},
+                      [&]() {
+                        window = createWindow(startupProperties.windowProperties);
+                        window->setCallback([](const Event& e) { postEvent(e); });
+                      },
+                      [&]() { window.reset(); }, true});
+      subsystems.add({"app.load", {}, [&]() { app->load(); }, {}});
+      subsystems.add({"app.init", {"asset", "audio", "timers", "window", "app.load"}, [&]() { app->init(); }, [&]() { app->shutdown(); }, true});
+
+      {
+        //startup is mostly waiting on the OS and disk, so keep a worker even on a single core
+        ThreadPool startup_pool(std::max<size_t>(ThreadPool::GetDefaultWorkerCount(), 1));
+        subsystems.init(startup_pool);
+      }
+      startup_timeline = subsystems.getInitTimeline();
+      logStartupTimeline("Startup", subsystems.getInitTimeline());
+      for(const auto& phase : startup_timeline) {
+        metrics::getGauge(fmt::format("startup.{}_ms", phase.name)).set(std::chrono::duration<double, std::milli>(phase.duration).count());
+      }
 
       log::rp_info(log::horiz_rule);
       log::rp_info("Initialization Complete!");
@@ -29,10 +114,28 @@ namespace rp {
 
 
 
+      EngineMetrics engine_metrics;
+      std::vector<Event> events;
+      auto last_frame = std::chrono::steady_clock::now();
       bool running = true;
       while(running) {
+        const auto frame_start = std::chrono::steady_clock::now();
+        const float frame_seconds = std::chrono::duration<float>(frame_start - last_frame).count();
+        last_frame = frame_start;
+
+        asset::dispatchCompletions();
+        audio::update();
+        timers::update(frame_start);
+        physics::stepWorlds(frame_seconds);
         app->update();
         running = window->processMessages();
+
+        getEventQueue().drain(events);
+        snapshot::advanceRollbacks(events);
+        for(const auto& e : events) {
+          app->onEvent(e);
+        }
+        engine_metrics.publish(frame_seconds, events.size());
       }
 
 
@@ -42,7 +145,9 @@ namespace rp {
       log::rp_info("Shutting Down Rapier!");
       log::rp_info(log::horiz_rule);
 
-      app->shutdown();
+      subsystems.shutdown();
+      logStartupTimeline("Shutdown", subsystems.getShutdownTimeline());
+      metrics::shutdown();
 
       log::rp_info(log::horiz_rule);
       log::rp_info("See you next time!");
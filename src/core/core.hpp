@@ -4,13 +4,25 @@
 
 #include "app.hpp"
 #include "core/window.hpp"
+#include "core/startup.hpp"
+#include "asset/asset.hpp"
+#include "audio/audio.hpp"
+#include "metrics/metrics.hpp"
+#include "timers/timers.hpp"
 
 namespace rp {
 
   struct StartupProperties {
     std::string logClientPrefix;
     Window::Properties windowProperties;
+    asset::Properties assetProperties;
+    audio::Properties audioProperties;
+    timers::Properties timersProperties;
+    metrics::Properties metricsProperties;
   };
 
   void run(std::unique_ptr<App> app, StartupProperties startupProperties);
+
+  //Init phases of the last rp::run, for tracking cold start time
+  const std::vector<StartupPhase>& getStartupTimeline();
 }
\ No newline at end of file
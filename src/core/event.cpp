@@ -1,3 +1,6 @@
+#include <stdexcept>
+#include <string_view>
+
 #include "core/event.hpp"
 
 namespace rp {
@@ -11,4 +14,51 @@ namespace rp {
         "MouseWheelScrolled",
         "MouseMoved"
     };
+
+    namespace {
+        struct UserEventType {
+            const char* name = nullptr;
+            Event::PayloadFormatter formatter = nullptr;
+        };
+
+        //function local so registration from other translation units' static initializers is safe
+        std::array<UserEventType, Event::max_user_types>& getUserEventTypes() {
+            static std::array<UserEventType, Event::max_user_types> user_event_types;
+            return user_event_types;
+        }
+    }
+
+    const char* Event::GetEventName(Event::Type event_type) {
+        const auto id = static_cast<uint16_t>(event_type);
+        if(id < INDEX_CAST(Type::ENUM_SIZE)) {
+            return eventNames[id];
+        }
+        if(id >= user_type_base && static_cast<size_t>(id - user_type_base) < max_user_types) {
+            const auto* name = getUserEventTypes()[id - user_type_base].name;
+            return name ? name : "UnregisteredUserEvent";
+        }
+        return "Invalid";
+    }
+
+    void Event::FormatUserPayload(const Event& e, fmt::memory_buffer& out) {
+        const auto id = static_cast<uint16_t>(e.type);
+        if(id < user_type_base || static_cast<size_t>(id - user_type_base) >= max_user_types) {
+            return;
+        }
+        if(auto formatter = getUserEventTypes()[id - user_type_base].formatter) {
+            formatter(e, out);
+        }
+    }
+
+    bool Event::RegisterUserType(uint16_t id, const char* name, PayloadFormatter formatter) {
+        if(id < user_type_base || static_cast<size_t>(id - user_type_base) >= max_user_types) {
+            return false;
+        }
+        auto& type = getUserEventTypes()[id - user_type_base];
+        if(type.name && std::string_view(type.name) != name) {
+            throw std::logic_error(fmt::format("Event id {} registered by both {} and {}", id, type.name, name));
+        }
+        type = {name, formatter};
+        return true;
+    }
 }
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <fmt/format.h>
 
 #include "util/util.hpp"
@@ -8,8 +12,23 @@
 #include "input/keyboard.hpp"
 
 namespace rp {
+  //Compact tagged event: a 16-bit type id followed by a payload union sized to the
+  //largest built-in payload, so events stay 16 bytes and pack densely in queues.
+  //
+  //Clients can add their own event types. A client event is a trivially copyable struct
+  //that fits in the payload and declares a compile-time id and a name:
+  //
+  //  struct ScoreChanged {
+  //    static constexpr uint16_t event_id = rp::Event::user_type_base + 0;
+  //    static constexpr const char* event_name = "ScoreChanged";
+  //    int score;
+  //  };
+  //  RP_REGISTER_EVENT(ScoreChanged);
+  //
+  //and is created with Event::Make(ScoreChanged{10}) and read back with e.as<ScoreChanged>().
+  //If fmt::formatter<ScoreChanged> exists the payload is included when the event is formatted.
   struct Event {
-    enum class Type {
+    enum class Type : uint16_t {
       Invalid,
       WindowClosed,
       KeyPressed,
@@ -21,25 +40,99 @@ namespace rp {
       ENUM_SIZE,
     };
 
+    static constexpr uint16_t user_type_base = 1024;
+    static constexpr size_t max_user_types = 1024;
+
     struct MouseInfo {
       input::Mouse::Position position;
-      input::Mouse::Button button;
-      int scroll;
+      union {
+        input::Mouse::Button button;
+        int scroll;
+      };
+    };
+
+    static constexpr size_t max_payload_size = sizeof(MouseInfo);
+
+    Type type = Type::Invalid;
+    union {
+      std::array<std::byte, max_payload_size> payload{};
+      input::Keyboard::Key key_code;
+      MouseInfo mouse;
     };
 
-    Type type;
-    input::Keyboard::Key key_code{};
-    MouseInfo mouse{};
+    template<typename T>
+    static constexpr void CheckUserEvent() {
+      static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+        "Event payloads must be trivially copyable and default constructible");
+      static_assert(sizeof(T) <= max_payload_size, "Event payload doesn't fit in rp::Event");
+      static_assert(alignof(T) <= alignof(MouseInfo), "Event payload is over-aligned");
+      static_assert(T::event_id >= user_type_base && T::event_id < user_type_base + max_user_types,
+        "Client event ids must be in [Event::user_type_base, Event::user_type_base + Event::max_user_types)");
+    }
+
+    template<typename T>
+    [[nodiscard]] static Event Make(const T& payload) {
+      CheckUserEvent<T>();
+      Event e;
+      e.type = static_cast<Type>(T::event_id);
+      std::memcpy(e.payload.data(), &payload, sizeof(T));
+      return e;
+    }
+
+    template<typename T>
+    [[nodiscard]] bool is() const {
+      CheckUserEvent<T>();
+      return type == static_cast<Type>(T::event_id);
+    }
+
+    template<typename T>
+    [[nodiscard]] T as() const {
+      CheckUserEvent<T>();
+      T value;
+      std::memcpy(&value, payload.data(), sizeof(T));
+      return value;
+    }
+
+    [[nodiscard]] bool isUserEvent() const {
+      return static_cast<uint16_t>(type) >= user_type_base;
+    }
+
+    static const char* GetEventName(Event::Type event_type);
 
-    static constexpr auto GetEventName(Event::Type event_type) {
-      return eventNames[INDEX_CAST(event_type)];
+    //Appends a client event's payload to out, if its type registered a formatter
+    static void FormatUserPayload(const Event& e, fmt::memory_buffer& out);
+
+    using PayloadFormatter = void (*)(const Event& e, fmt::memory_buffer& out);
+    //Returns false for ids outside [user_type_base, user_type_base + max_user_types)
+    static bool RegisterUserType(uint16_t id, const char* name, PayloadFormatter formatter);
+
+    template<typename T>
+    static bool RegisterUserType() {
+      CheckUserEvent<T>();
+      PayloadFormatter formatter = nullptr;
+      if constexpr(fmt::has_formatter<T, fmt::format_context>::value) {
+        formatter = [](const Event& e, fmt::memory_buffer& out) {
+          fmt::format_to(std::back_inserter(out), "{}", e.as<T>());
+        };
+      }
+      return RegisterUserType(T::event_id, T::event_name, formatter);
     }
 
 private:
     static const std::array<const char*, INDEX_CAST(Event::Type::ENUM_SIZE)> eventNames;
   };
+
+  static_assert(sizeof(Event) == 16, "rp::Event should stay compact");
+  static_assert(std::is_trivially_copyable_v<Event>);
 }
 
+#define RP_EVENT_CONCAT_IMPL(a, b) a##b
+#define RP_EVENT_CONCAT(a, b) RP_EVENT_CONCAT_IMPL(a, b)
+
+//Registers a client event type's name and formatter, place at namespace scope in one source file
+#define RP_REGISTER_EVENT(T) \
+  static const bool RP_EVENT_CONCAT(rp_event_registered_, __LINE__) = rp::Event::RegisterUserType<T>()
+
 template <>
 struct fmt::formatter<rp::Event> {
   constexpr auto parse(fmt::format_parse_context& ctx) {
@@ -51,42 +144,34 @@ struct fmt::formatter<rp::Event> {
 
   template<typename FormatContext>
   auto format(const rp::Event& e, FormatContext& ctx) {
-    std::string_view fmt_string;
+    const auto name = rp::Event::GetEventName(e.type);
+
+    if(e.isUserEvent()) {
+      fmt::memory_buffer payload;
+      rp::Event::FormatUserPayload(e, payload);
+      if(payload.size() == 0)
+        return format_to(ctx.out(), "<{}>", name);
+      return format_to(ctx.out(), "<{} ({})>", name, fmt::to_string(payload));
+    }
+
     switch(e.type) {
       case rp::Event::Type::Invalid:
       case rp::Event::Type::WindowClosed:
-        fmt_string = "<{0}>";
-        break;
+        return format_to(ctx.out(), "<{}>", name);
       case rp::Event::Type::KeyPressed:
       case rp::Event::Type::KeyReleased:
-        fmt_string = "<{0} ({1})>";
-        break;
+        return format_to(ctx.out(), "<{} ({})>", name, rp::input::Keyboard::GetKeyName(e.key_code));
       case rp::Event::Type::MouseButtonPressed:
       case rp::Event::Type::MouseButtonReleased:
-        fmt_string = "<{0} (Button {2})>";
-        break;
+        return format_to(ctx.out(), "<{} (Button {})>", name, e.mouse.button);
       case rp::Event::Type::MouseMoved:
-        fmt_string = "<{0} ({3}, {4})>";
-        break;
+        return format_to(ctx.out(), "<{} ({}, {})>", name, e.mouse.position.x, e.mouse.position.y);
       case rp::Event::Type::MouseWheelScrolled:
-        fmt_string = "<{0} ({5})>";
-        break;
+        return format_to(ctx.out(), "<{} ({})>", name, e.mouse.scroll);
       case rp::Event::Type::ENUM_SIZE:
         throw format_error("Invalid use of ENUM_SIZE as Event Type!");
-        break;
     };
 
-    if(fmt_string.empty())
-      throw format_error("Event::Type not handled!");
-
-    return format_to(
-      ctx.out(),
-      fmt_string,
-      rp::Event::GetEventName(e.type),
-      rp::input::Keyboard::GetKeyName(e.key_code),
-      e.mouse.button,
-      e.mouse.position.x,
-      e.mouse.position.y,
-      e.mouse.scroll);
+    throw format_error("Event::Type not handled!");
   } 
-};
\ No newline at end of file
+};
@@ -0,0 +1,25 @@
+#include "pch.hpp"
+#include "core/event_queue.hpp"
+
+namespace rp {
+  void EventQueue::push(const Event& e) {
+    std::lock_guard lock(mMutex);
+    mPending.push_back(e);
+  }
+
+  void EventQueue::drain(std::vector<Event>& events) {
+    events.clear();
+    std::lock_guard lock(mMutex);
+    std::swap(events, mPending);
+  }
+
+  size_t EventQueue::size() const {
+    std::lock_guard lock(mMutex);
+    return mPending.size();
+  }
+
+  EventQueue& getEventQueue() {
+    static EventQueue queue;
+    return queue;
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "core/event.hpp"
+
+namespace rp {
+  //Events posted from any thread, drained in bulk once per frame.
+  //Events are stored by value in a contiguous buffer that is reused between frames.
+  class EventQueue {
+  public:
+    void push(const Event& e);
+
+    template<typename T>
+    void post(const T& payload) {
+      push(Event::Make(payload));
+    }
+
+    //Moves all pending events into events, replacing its contents
+    void drain(std::vector<Event>& events);
+
+    [[nodiscard]] size_t size() const;
+
+  private:
+    mutable std::mutex mMutex;
+    std::vector<Event> mPending;
+  };
+
+  //The engine's queue, rp::run delivers its events to App::onEvent every frame
+  EventQueue& getEventQueue();
+
+  inline void postEvent(const Event& e) {
+    getEventQueue().push(e);
+  }
+
+  template<typename T>
+  void postEvent(const T& payload) {
+    getEventQueue().post(payload);
+  }
+}
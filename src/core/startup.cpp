@@ -0,0 +1,206 @@
+#include "pch.hpp"
+#include "core/startup.hpp"
+
+#include <condition_variable>
+#include <exception>
+
+namespace rp {
+  namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t timeline_bar_width = 40;
+
+    //Numbers threads in the order they record a phase, so the calling thread is always 0
+    uint32_t getThreadIndex(std::vector<std::thread::id>& threads) {
+      const auto id = std::this_thread::get_id();
+      const auto it = std::find(threads.begin(), threads.end(), id);
+      if(it != threads.end()) {
+        return static_cast<uint32_t>(it - threads.begin());
+      }
+      threads.push_back(id);
+      return static_cast<uint32_t>(threads.size() - 1);
+    }
+
+    double toMilliseconds(std::chrono::nanoseconds duration) {
+      return std::chrono::duration<double, std::milli>(duration).count();
+    }
+  }
+
+  void logStartupTimeline(std::string_view title, const std::vector<StartupPhase>& phases) {
+    std::chrono::nanoseconds wall{0};
+    std::chrono::nanoseconds work{0};
+    size_t name_width = 0;
+    uint32_t thread_count = 0;
+    for(const auto& phase : phases) {
+      wall = std::max(wall, phase.start + phase.duration);
+      work += phase.duration;
+      name_width = std::max(name_width, phase.name.size());
+      thread_count = std::max(thread_count, phase.thread + 1);
+    }
+
+    log::rp_info("{} took {:.2f} ms ({:.2f} ms of work on {} threads)", title, toMilliseconds(wall), toMilliseconds(work), thread_count);
+    const double scale = (wall.count() > 0) ? static_cast<double>(timeline_bar_width) / static_cast<double>(wall.count()) : 0.0;
+    for(const auto& phase : phases) {
+      const auto bar_start = std::min(static_cast<size_t>(static_cast<double>(phase.start.count()) * scale), timeline_bar_width - 1);
+      const auto bar_end = std::clamp(static_cast<size_t>(static_cast<double>((phase.start + phase.duration).count()) * scale), bar_start + 1, timeline_bar_width);
+      std::string bar(timeline_bar_width, ' ');
+      std::fill(bar.begin() + bar_start, bar.begin() + bar_end, '#');
+
+      log::rp_info("  {:<{}} t{} {:8.2f} ms +{:8.2f} ms |{}|", phase.name, name_width, phase.thread,
+                   toMilliseconds(phase.start), toMilliseconds(phase.duration), bar);
+    }
+  }
+
+  void SubsystemGraph::add(Subsystem subsystem) {
+    const auto it = std::find_if(mSubsystems.begin(), mSubsystems.end(), [&](const Subsystem& s) { return s.name == subsystem.name; });
+    if(it != mSubsystems.end()) {
+      throw std::invalid_argument(fmt::format("Subsystem '{}' added twice!", subsystem.name));
+    }
+    mSubsystems.push_back(std::move(subsystem));
+  }
+
+  void SubsystemGraph::init(ThreadPool& pool) {
+    const size_t count = mSubsystems.size();
+
+    //resolve names into edges up front so missing dependencies and cycles fail before anything runs
+    std::vector<std::vector<size_t>> dependents(count);
+    std::vector<size_t> waiting(count, 0);
+    for(size_t i = 0; i < count; i++) {
+      for(const auto& dependency : mSubsystems[i].dependencies) {
+        const auto it = std::find_if(mSubsystems.begin(), mSubsystems.end(), [&](const Subsystem& s) { return s.name == dependency; });
+        if(it == mSubsystems.end()) {
+          throw std::invalid_argument(fmt::format("Subsystem '{}' depends on unknown subsystem '{}'!", mSubsystems[i].name, dependency));
+        }
+        dependents[it - mSubsystems.begin()].push_back(i);
+        waiting[i]++;
+      }
+    }
+
+    {
+      auto remaining = waiting;
+      std::vector<size_t> order;
+      for(size_t i = 0; i < count; i++) {
+        if(remaining[i] == 0) {
+          order.push_back(i);
+        }
+      }
+      for(size_t n = 0; n < order.size(); n++) {
+        for(const auto dependent : dependents[order[n]]) {
+          if(--remaining[dependent] == 0) {
+            order.push_back(dependent);
+          }
+        }
+      }
+      if(order.size() != count) {
+        throw std::invalid_argument("Subsystem dependencies contain a cycle!");
+      }
+    }
+
+    std::mutex mutex;
+    std::condition_variable step_done;
+    std::vector<size_t> ready_main;
+    std::vector<size_t> ready_pool;
+    std::vector<std::thread::id> threads;
+    size_t running = 0;
+    std::exception_ptr failure;
+
+    const auto push_ready = [&](size_t index) {
+      (mSubsystems[index].mainThread ? ready_main : ready_pool).push_back(index);
+    };
+    for(size_t i = 0; i < count; i++) {
+      if(waiting[i] == 0) {
+        push_ready(i);
+      }
+    }
+
+    const auto origin = Clock::now();
+    threads.push_back(std::this_thread::get_id());
+
+    //Steps are handed to the pool by whichever thread releases them, so a chain of pool steps
+    //doesn't wait for the calling thread to finish a main thread step
+    std::function<void(std::unique_lock<std::mutex>&)> submit_ready;
+
+    //called without the lock held, records the phase and releases dependents
+    const auto run_step = [&](size_t index) {
+      const auto& subsystem = mSubsystems[index];
+      std::exception_ptr error;
+      const auto start = Clock::now();
+      try {
+        if(subsystem.init) {
+          subsystem.init();
+        }
+      } catch(...) {
+        error = std::current_exception();
+      }
+      const auto end = Clock::now();
+
+      std::unique_lock lock(mutex);
+      mInitTimeline.push_back({subsystem.name, start - origin, end - start, getThreadIndex(threads)});
+      running--;
+      if(error) {
+        if(!failure) {
+          failure = error;
+        }
+      } else {
+        mInitialized.push_back(index);
+        for(const auto dependent : dependents[index]) {
+          if(--waiting[dependent] == 0) {
+            push_ready(dependent);
+          }
+        }
+      }
+      submit_ready(lock);
+      step_done.notify_all();
+    };
+
+    //after a failure nothing new starts, only the steps in flight are waited on
+    submit_ready = [&](std::unique_lock<std::mutex>& lock) {
+      while(!failure && !ready_pool.empty()) {
+        const auto index = ready_pool.front();
+        ready_pool.erase(ready_pool.begin());
+        running++;
+        lock.unlock();
+        pool.submit([&run_step, index]() { run_step(index); });
+        lock.lock();
+      }
+    };
+
+    std::unique_lock lock(mutex);
+    submit_ready(lock);
+    while(true) {
+      if(!failure && !ready_main.empty()) {
+        const auto index = ready_main.front();
+        ready_main.erase(ready_main.begin());
+        running++;
+        lock.unlock();
+        run_step(index);
+        lock.lock();
+        continue;
+      }
+
+      if(running == 0) {
+        break;
+      }
+      step_done.wait(lock);
+    }
+
+    if(failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+
+  void SubsystemGraph::shutdown() {
+    const auto origin = Clock::now();
+    while(!mInitialized.empty()) {
+      const auto& subsystem = mSubsystems[mInitialized.back()];
+      mInitialized.pop_back();
+
+      if(!subsystem.shutdown) {
+        continue;
+      }
+      const auto start = Clock::now();
+      subsystem.shutdown();
+      mShutdownTimeline.push_back({subsystem.name, start - origin, Clock::now() - start, 0});
+    }
+  }
+}
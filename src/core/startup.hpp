@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/thread_pool.hpp"
+
+namespace rp {
+  //One timed step of startup or shutdown
+  struct StartupPhase {
+    std::string name;
+    std::chrono::nanoseconds start;     //offset from the beginning of init or shutdown
+    std::chrono::nanoseconds duration;
+    uint32_t thread;                    //0 is the calling thread, workers are numbered as they are first seen
+  };
+
+  //Logs phases as a table with a bar per phase showing where it ran in the overall wall time
+  void logStartupTimeline(std::string_view title, const std::vector<StartupPhase>& phases);
+
+  //Engine and app subsystems with declared dependencies. init runs every subsystem after the
+  //ones it depends on, independent subsystems in parallel, and shutdown runs in reverse order
+  class SubsystemGraph {
+  public:
+    using Step = std::function<void()>;
+
+    struct Subsystem {
+      std::string name;
+      std::vector<std::string> dependencies;
+      Step init;
+      Step shutdown;
+      bool mainThread = false;  //run init on the thread calling SubsystemGraph::init instead of the pool
+    };
+
+    void add(Subsystem subsystem);
+
+    //Throws the first failing init step once the steps already running have finished,
+    //subsystems depending on a failed one are never initialized
+    void init(ThreadPool& pool);
+
+    //Shuts down every initialized subsystem on the calling thread, dependents before their dependencies
+    void shutdown();
+
+    [[nodiscard]] const std::vector<StartupPhase>& getInitTimeline() const noexcept { return mInitTimeline; }
+    [[nodiscard]] const std::vector<StartupPhase>& getShutdownTimeline() const noexcept { return mShutdownTimeline; }
+
+  private:
+    std::vector<Subsystem> mSubsystems;
+    std::vector<size_t> mInitialized;  //in order of completion
+    std::vector<StartupPhase> mInitTimeline;
+    std::vector<StartupPhase> mShutdownTimeline;
+  };
+}
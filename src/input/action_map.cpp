@@ -0,0 +1,349 @@
+#include "pch.hpp"
+#include "input/action_map.hpp"
+
+#include <charconv>
+
+namespace rp::input {
+  namespace {
+    std::string_view trim(std::string_view str) {
+      const auto first = str.find_first_not_of(" \t\r");
+      if(first == std::string_view::npos) {
+        return {};
+      }
+      const auto last = str.find_last_not_of(" \t\r");
+      return str.substr(first, last - first + 1);
+    }
+
+    std::vector<std::string_view> split(std::string_view str, char separator) {
+      std::vector<std::string_view> parts;
+      size_t start = 0;
+      while(true) {
+        const auto end = str.find(separator, start);
+        parts.push_back(trim(str.substr(start, end - start)));
+        if(end == std::string_view::npos) {
+          return parts;
+        }
+        start = end + 1;
+      }
+    }
+
+    uint16_t findOrAdd(std::vector<StringId>& names, std::string_view name) {
+      const auto id = StringId::Intern(name);
+      auto it = std::find(names.begin(), names.end(), id);
+      if(it != names.end()) {
+        return static_cast<uint16_t>(it - names.begin());
+      }
+      names.push_back(id);
+      return static_cast<uint16_t>(names.size() - 1);
+    }
+
+    uint16_t find(const std::vector<StringId>& names, StringId name) {
+      auto it = std::find(names.begin(), names.end(), name);
+      return (it != names.end()) ? static_cast<uint16_t>(it - names.begin()) : ActionMap::invalid_id;
+    }
+  }
+
+  ActionMap ActionMap::Load(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if(!file) {
+      throw std::runtime_error(fmt::format("Failed to open action bindings {}", path.string()));
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return Parse(contents.str(), path.string());
+  }
+
+  ActionMap ActionMap::Parse(std::string_view config, std::string_view source_name) {
+    ActionMap map;
+    ContextId context = static_cast<ContextId>(findOrAdd(map.mContextNames, "default"));
+
+    auto parseInput = [&](std::string_view name, size_t line_number) -> size_t {
+      if(name == "MouseLeft") return mouse_button_input + Mouse::Left;
+      if(name == "MouseRight") return mouse_button_input + Mouse::Right;
+      if(name == "MouseMiddle") return mouse_button_input + Mouse::Middle;
+      if(name == "MouseWheel") return mouse_wheel_input;
+      if(name == "MouseX") return mouse_x_input;
+      if(name == "MouseY") return mouse_y_input;
+
+      const auto key = Keyboard::FromName(name);
+      if(key == Keyboard::Key::Invalid) {
+        throw std::runtime_error(fmt::format("{}:{}: unknown input '{}'", source_name, line_number, name));
+      }
+      return INDEX_CAST(key);
+    };
+
+    size_t line_number = 0;
+    for(auto line : split(config, '\n')) {
+      line_number++;
+      line = trim(line.substr(0, line.find('#')));
+      if(line.empty()) {
+        continue;
+      }
+
+      const auto keyword_end = line.find_first_of(" \t");
+      const auto keyword = line.substr(0, keyword_end);
+      const auto rest = (keyword_end == std::string_view::npos) ? std::string_view() : trim(line.substr(keyword_end));
+
+      if(keyword == "context") {
+        if(rest.empty()) {
+          throw std::runtime_error(fmt::format("{}:{}: context needs a name", source_name, line_number));
+        }
+        context = static_cast<ContextId>(findOrAdd(map.mContextNames, rest));
+        if(map.mContextNames.size() > max_contexts) {
+          throw std::runtime_error(fmt::format("{}:{}: more than {} contexts", source_name, line_number, max_contexts));
+        }
+        continue;
+      }
+
+      const bool is_axis = (keyword == "axis");
+      if(!is_axis && keyword != "action") {
+        throw std::runtime_error(fmt::format("{}:{}: unknown keyword '{}'", source_name, line_number, keyword));
+      }
+
+      const auto equals = rest.find('=');
+      const auto name = trim(rest.substr(0, equals));
+      if(equals == std::string_view::npos || name.empty()) {
+        throw std::runtime_error(fmt::format("{}:{}: expected '{} <name> = <bindings>'", source_name, line_number, keyword));
+      }
+
+      const uint16_t target = is_axis ? findOrAdd(map.mAxisNames, name) : findOrAdd(map.mActionNames, name);
+      for(auto binding_text : split(rest.substr(equals + 1), ',')) {
+        Binding binding = {};
+        binding.target = target;
+        binding.context = context;
+        binding.is_axis = is_axis;
+        binding.scale = 1.0f;
+
+        //a trailing number is the axis scale, anything else is part of the chord like 'LeftShift + D'
+        if(is_axis) {
+          const auto scale_start = binding_text.find_last_of(" \t");
+          if(scale_start != std::string_view::npos) {
+            const auto scale_text = binding_text.substr(scale_start + 1);
+            float scale = 1.0f;
+            const auto [end, error] = std::from_chars(scale_text.data(), scale_text.data() + scale_text.size(), scale);
+            if(error == std::errc() && end == scale_text.data() + scale_text.size()) {
+              binding.scale = scale;
+              binding_text = trim(binding_text.substr(0, scale_start));
+            }
+          }
+        }
+
+        for(auto input_name : split(binding_text, '+')) {
+          if(binding.chord_size == max_chord_size) {
+            throw std::runtime_error(fmt::format("{}:{}: chords are limited to {} inputs", source_name, line_number, max_chord_size));
+          }
+          binding.chord[binding.chord_size++] = static_cast<uint16_t>(parseInput(input_name, line_number));
+        }
+
+        const bool analog = binding.chord[0] >= mouse_wheel_input;
+        if(analog && (!is_axis || binding.chord_size != 1)) {
+          throw std::runtime_error(fmt::format("{}:{}: analog inputs can only be bound alone to axes", source_name, line_number));
+        }
+        map.mBindings.push_back(binding);
+      }
+    }
+
+    map.compile();
+    return map;
+  }
+
+  void ActionMap::compile() {
+    //counting sort of binding references by input, every input of a chord can complete it
+    std::array<uint32_t, input_count> counts{};
+    for(const auto& binding : mBindings) {
+      for(size_t i = 0; i < binding.chord_size; i++) {
+        counts[binding.chord[i]]++;
+      }
+    }
+
+    mInputOffsets[0] = 0;
+    for(size_t input = 0; input < input_count; input++) {
+      mInputOffsets[input + 1] = mInputOffsets[input] + counts[input];
+    }
+
+    mBindingRefs.resize(mInputOffsets[input_count]);
+    auto cursor = mInputOffsets;
+    for(uint32_t index = 0; index < mBindings.size(); index++) {
+      const auto& binding = mBindings[index];
+      for(size_t i = 0; i < binding.chord_size; i++) {
+        mBindingRefs[cursor[binding.chord[i]]++] = index;
+      }
+    }
+
+    mBindingActive.assign(mBindings.size(), 0);
+    mActions.assign(mActionNames.size(), ActionState{});
+    mAxes.assign(mAxisNames.size(), AxisState{});
+  }
+
+  ActionMap::ActionId ActionMap::getAction(StringId name) const {
+    return find(mActionNames, name);
+  }
+
+  ActionMap::AxisId ActionMap::getAxis(StringId name) const {
+    return find(mAxisNames, name);
+  }
+
+  ActionMap::ContextId ActionMap::getContext(StringId name) const {
+    const auto context = find(mContextNames, name);
+    if(context == invalid_id) {
+      throw std::invalid_argument(fmt::format("Unknown input context '{}'", name));
+    }
+    return static_cast<ContextId>(context);
+  }
+
+  void ActionMap::checkContext(ContextId context) const {
+    if(context >= mContextNames.size()) {
+      throw std::invalid_argument(fmt::format("Unknown input context id {}", context));
+    }
+  }
+
+  void ActionMap::setContextActive(ContextId context, bool active) {
+    checkContext(context);
+    const uint64_t bit = uint64_t{1} << context;
+    if(isContextActive(context) == active) {
+      return;
+    }
+
+    if(active) {
+      mActiveContexts |= bit;
+      //pick up chords that are already held
+      for(uint32_t index = 0; index < mBindings.size(); index++) {
+        const auto& binding = mBindings[index];
+        if(binding.context == context && binding.chord[0] < mouse_wheel_input &&
+           std::all_of(binding.chord.begin(), binding.chord.begin() + binding.chord_size, [&](uint16_t input) { return mHeld[input]; })) {
+          activate(index);
+        }
+      }
+    } else {
+      for(uint32_t index = 0; index < mBindings.size(); index++) {
+        if(mBindings[index].context == context && mBindingActive[index]) {
+          deactivate(index);
+        }
+      }
+      mActiveContexts &= ~bit;
+    }
+  }
+
+  bool ActionMap::isContextActive(ContextId context) const {
+    checkContext(context);
+    return (mActiveContexts >> context) & 1;
+  }
+
+  void ActionMap::activate(uint32_t index) {
+    const auto& binding = mBindings[index];
+    mBindingActive[index] = 1;
+    if(binding.is_axis) {
+      mAxes[binding.target].held += binding.scale;
+    } else if(mActions[binding.target].active_bindings++ == 0) {
+      mActions[binding.target].pressed = true;
+    }
+  }
+
+  void ActionMap::deactivate(uint32_t index) {
+    const auto& binding = mBindings[index];
+    mBindingActive[index] = 0;
+    if(binding.is_axis) {
+      mAxes[binding.target].held -= binding.scale;
+    } else if(--mActions[binding.target].active_bindings == 0) {
+      mActions[binding.target].released = true;
+    }
+  }
+
+  void ActionMap::pressInput(size_t input) {
+    //keys auto-repeat while held, only the first press counts
+    if(mHeld[input]) {
+      return;
+    }
+    mHeld[input] = true;
+
+    for(uint32_t ref = mInputOffsets[input]; ref < mInputOffsets[input + 1]; ref++) {
+      const uint32_t index = mBindingRefs[ref];
+      const auto& binding = mBindings[index];
+      if(mBindingActive[index] || !isContextActive(binding.context)) {
+        continue;
+      }
+
+      bool chord_held = true;
+      for(size_t i = 0; i < binding.chord_size && chord_held; i++) {
+        chord_held = mHeld[binding.chord[i]];
+      }
+      if(chord_held) {
+        activate(index);
+      }
+    }
+  }
+
+  void ActionMap::releaseInput(size_t input) {
+    mHeld[input] = false;
+    for(uint32_t ref = mInputOffsets[input]; ref < mInputOffsets[input + 1]; ref++) {
+      const uint32_t index = mBindingRefs[ref];
+      if(mBindingActive[index]) {
+        deactivate(index);
+      }
+    }
+  }
+
+  void ActionMap::addAnalog(size_t input, float delta) {
+    for(uint32_t ref = mInputOffsets[input]; ref < mInputOffsets[input + 1]; ref++) {
+      const auto& binding = mBindings[mBindingRefs[ref]];
+      if(isContextActive(binding.context)) {
+        mAxes[binding.target].frame_delta += delta * binding.scale;
+      }
+    }
+  }
+
+  void ActionMap::onEvent(const Event& e) {
+    switch(e.type) {
+      case Event::Type::KeyPressed:
+        pressInput(INDEX_CAST(e.key_code));
+        break;
+      case Event::Type::KeyReleased:
+        releaseInput(INDEX_CAST(e.key_code));
+        break;
+      case Event::Type::MouseButtonPressed:
+        pressInput(mouse_button_input + e.mouse.button);
+        break;
+      case Event::Type::MouseButtonReleased:
+        releaseInput(mouse_button_input + e.mouse.button);
+        break;
+      case Event::Type::MouseWheelScrolled:
+        addAnalog(mouse_wheel_input, static_cast<float>(e.mouse.scroll));
+        break;
+      case Event::Type::MouseMoved:
+        if(mLastMousePosition) {
+          addAnalog(mouse_x_input, static_cast<float>(e.mouse.position.x - mLastMousePosition->x));
+          addAnalog(mouse_y_input, static_cast<float>(e.mouse.position.y - mLastMousePosition->y));
+        }
+        mLastMousePosition = e.mouse.position;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void ActionMap::nextFrame() {
+    for(auto& action : mActions) {
+      action.pressed = false;
+      action.released = false;
+    }
+    for(auto& axis : mAxes) {
+      axis.frame_delta = 0.0f;
+    }
+  }
+
+  bool ActionMap::isDown(ActionId action) const {
+    return action < mActions.size() && mActions[action].active_bindings > 0;
+  }
+
+  bool ActionMap::wasPressed(ActionId action) const {
+    return action < mActions.size() && mActions[action].pressed;
+  }
+
+  bool ActionMap::wasReleased(ActionId action) const {
+    return action < mActions.size() && mActions[action].released;
+  }
+
+  float ActionMap::getAxisValue(AxisId axis) const {
+    return (axis < mAxes.size()) ? mAxes[axis].held + mAxes[axis].frame_delta : 0.0f;
+  }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/event.hpp"
+#include "input/keyboard.hpp"
+#include "input/mouse.hpp"
+#include "util/string_id.hpp"
+
+namespace rp::input {
+  //Maps raw input events to named actions and axes.
+  //
+  //Bindings are loaded from a config file, one per line:
+  //  context <name>                            following bindings belong to this context
+  //  action <name> = <chord> [, <chord>...]    a chord is inputs joined by '+', e.g. LeftCtrl+S
+  //  axis <name> = <chord> [<scale>] [, ...]   held chords add scale (default 1), MouseWheel/MouseX/MouseY add delta * scale
+  //Inputs are Keyboard key names plus MouseLeft, MouseRight, MouseMiddle, MouseWheel, MouseX and MouseY.
+  //Bindings before the first context line belong to the "default" context.
+  //
+  //Bindings are compiled into a table indexed by input, so an event only touches the
+  //bindings of the input it came from, however many bindings and contexts exist.
+  class ActionMap {
+  public:
+    using ActionId = uint16_t;
+    using AxisId = uint16_t;
+    using ContextId = uint8_t;
+
+    static constexpr uint16_t invalid_id = 0xFFFF;
+    static constexpr size_t max_chord_size = 4;
+    static constexpr size_t max_contexts = 64;
+
+    [[nodiscard]] static ActionMap Load(const std::filesystem::path& path);
+    [[nodiscard]] static ActionMap Parse(std::string_view config, std::string_view source_name = "<string>");
+
+    //Names are compared as hashes, so ids of literals can be computed once at compile time
+    [[nodiscard]] ActionId getAction(StringId name) const;
+    [[nodiscard]] AxisId getAxis(StringId name) const;
+    [[nodiscard]] ContextId getContext(StringId name) const;
+
+    //All contexts start active. Ids not returned by getContext throw std::invalid_argument.
+    void setContextActive(ContextId context, bool active);
+    [[nodiscard]] bool isContextActive(ContextId context) const;
+
+    void onEvent(const Event& e);
+
+    //Clears per-frame state (pressed/released edges and analog deltas).
+    //Call once per frame after the frame's actions have been read.
+    void nextFrame();
+
+    [[nodiscard]] bool isDown(ActionId action) const;
+    [[nodiscard]] bool wasPressed(ActionId action) const;
+    [[nodiscard]] bool wasReleased(ActionId action) const;
+    [[nodiscard]] float getAxisValue(AxisId axis) const;
+
+  private:
+    static constexpr size_t key_input_count = INDEX_CAST(Keyboard::Key::ENUM_SIZE);
+    static constexpr size_t mouse_button_input = key_input_count;
+    static constexpr size_t mouse_wheel_input = mouse_button_input + Mouse::ENUM_SIZE;
+    static constexpr size_t mouse_x_input = mouse_wheel_input + 1;
+    static constexpr size_t mouse_y_input = mouse_x_input + 1;
+    static constexpr size_t input_count = mouse_y_input + 1;
+
+    struct Binding {
+      uint16_t target;  //action or axis index
+      ContextId context;
+      bool is_axis;
+      float scale;
+      uint8_t chord_size;
+      std::array<uint16_t, max_chord_size> chord;
+    };
+
+    struct ActionState {
+      uint16_t active_bindings;
+      bool pressed;
+      bool released;
+    };
+
+    struct AxisState {
+      float held;
+      float frame_delta;
+    };
+
+    ActionMap() = default;
+
+    void compile();
+    void pressInput(size_t input);
+    void releaseInput(size_t input);
+    void addAnalog(size_t input, float delta);
+    void checkContext(ContextId context) const;
+    void activate(uint32_t binding);
+    void deactivate(uint32_t binding);
+
+    std::vector<StringId> mActionNames;
+    std::vector<StringId> mAxisNames;
+    std::vector<StringId> mContextNames;
+    std::vector<Binding> mBindings;
+
+    //compiled table: bindings triggered by input i are mBindingRefs[mInputOffsets[i] .. mInputOffsets[i + 1])
+    std::array<uint32_t, input_count + 1> mInputOffsets{};
+    std::vector<uint32_t> mBindingRefs;
+
+    std::array<bool, input_count> mHeld{};
+    std::vector<uint8_t> mBindingActive;
+    std::vector<ActionState> mActions;
+    std::vector<AxisState> mAxes;
+    uint64_t mActiveContexts = ~uint64_t{0};
+    std::optional<Mouse::Position> mLastMousePosition;
+  };
+}
@@ -1,27 +1,96 @@
+#include <algorithm>
+
 #include "input/keyboard.hpp"
+#include "util/hash.hpp"
 
 namespace rp::input {
-    const std::array<const char*, INDEX_CAST(Keyboard::Key::ENUM_SIZE)> Keyboard::keyNames = {
-        "Invalid",
-        "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M",
-        "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z",
+  namespace {
+    //Perfect hash from key name to key, built at compile time with hash-and-displace:
+    //names are split into buckets by their hash, then each bucket is given a displacement
+    //that moves all of its names into free slots. Lookup is one hash, two loads and a compare.
+    constexpr size_t key_count = INDEX_CAST(Keyboard::Key::ENUM_SIZE);
+    constexpr size_t name_slot_count = 256;
+    constexpr size_t name_bucket_bits = 5;
+    constexpr size_t name_bucket_count = size_t{1} << name_bucket_bits;
+
+    static_assert(name_slot_count > key_count && (name_slot_count & (name_slot_count - 1)) == 0);
+
+    constexpr size_t nameBucket(uint64_t hash) {
+      return static_cast<size_t>(hash >> (64 - name_bucket_bits));
+    }
+
+    constexpr size_t nameSlot(uint64_t hash, uint32_t displacement) {
+      const auto base = static_cast<uint32_t>(hash);
+      const auto step = static_cast<uint32_t>(hash >> 26) | 1u;
+      return (base + displacement * step) & (name_slot_count - 1);
+    }
+
+    struct NameTable {
+      std::array<uint16_t, name_bucket_count> displacements{};
+      std::array<Keyboard::Key, name_slot_count> keys{};
+    };
+
+    constexpr NameTable buildNameTable() {
+      NameTable table;
+      std::array<uint64_t, key_count> hashes{};
+      std::array<size_t, name_bucket_count> bucket_sizes{};
+      for(size_t key = 1; key < key_count; key++) {
+        hashes[key] = hashString(Keyboard::GetKeyName(static_cast<Keyboard::Key>(key)));
+        bucket_sizes[nameBucket(hashes[key])]++;
+      }
+
+      //place the most crowded buckets first, while the table is still mostly empty
+      std::array<size_t, name_bucket_count> order{};
+      for(size_t i = 0; i < name_bucket_count; i++) {
+        order[i] = i;
+      }
+      std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return bucket_sizes[lhs] > bucket_sizes[rhs]; });
 
-        "Space", "Comma", "Period", "Semicolon", "Slash", "Tilde",
-        "LeftBracket", "RightBracket", "Backslash", "Quote",
+      std::array<bool, name_slot_count> used{};
+      for(size_t bucket : order) {
+        std::array<size_t, key_count> members{};
+        size_t member_count = 0;
+        for(size_t key = 1; key < key_count; key++) {
+          if(nameBucket(hashes[key]) == bucket) {
+            members[member_count++] = key;
+          }
+        }
 
-        "LeftShift", "RightShift", "LeftCtrl", "RightCtrl",
-        "LeftAlt", "RightAlt", "LeftSystem", "RightSystem",
-        "Tab", "Backspace", "Enter", "CapsLock", "Escape",
+        for(uint32_t displacement = 0;; displacement++) {
+          //displacement is stored in 16 bits, running out means the table is too small
+          if(displacement > 0xFFFF) {
+            throw "Keyboard name table too small for a perfect hash";
+          }
 
-        "Num0", "Num1", "Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8", "Num9", "Dash", "Equals",
+          bool placed = true;
+          for(size_t i = 0; i < member_count && placed; i++) {
+            const size_t slot = nameSlot(hashes[members[i]], displacement);
+            placed = !used[slot];
+            for(size_t j = 0; j < i && placed; j++) {
+              placed = slot != nameSlot(hashes[members[j]], displacement);
+            }
+          }
 
-        "Numpad0", "Numpad1", "Numpad2", "Numpad3", "Numpad4", "Numpad5", "Numpad6",
-        "Numpad7", "Numpad8", "Numpad9", "Add", "Subtract", "Multiply", "Divide", "NumLock", 
+          if(placed) {
+            table.displacements[bucket] = static_cast<uint16_t>(displacement);
+            for(size_t i = 0; i < member_count; i++) {
+              const size_t slot = nameSlot(hashes[members[i]], displacement);
+              used[slot] = true;
+              table.keys[slot] = static_cast<Keyboard::Key>(members[i]);
+            }
+            break;
+          }
+        }
+      }
+      return table;
+    }
 
-        "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12",
+    constexpr NameTable name_table = buildNameTable();
+  }
 
-        "PrintScreen", "ScrollLock", "Pause",
-        "Insert", "Delete", "Home", "End", "PageUp", "PageDown",
-        "Up", "Down", "Left", "Right",
-      };
+  Keyboard::Key Keyboard::FromName(std::string_view name) {
+    const uint64_t hash = hashString(name);
+    const Key key = name_table.keys[nameSlot(hash, name_table.displacements[nameBucket(hash)])];
+    return (key != Key::Invalid && name == GetKeyName(key)) ? key : Key::Invalid;
+  }
 }
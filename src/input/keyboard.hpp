@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <string_view>
+
 #include "util/util.hpp"
 
 namespace rp::input {
@@ -30,11 +34,37 @@ namespace rp::input {
       ENUM_SIZE,
     };
 
-    static auto GetKeyName(Keyboard::Key key) {
+    static constexpr auto GetKeyName(Keyboard::Key key) {
       return keyNames[INDEX_CAST(key)];
     }
 
+    //Inverse of GetKeyName, for key bindings read from config files.
+    //Returns Key::Invalid for names that aren't a key. Case sensitive.
+    static Key FromName(std::string_view name);
+
   private:
-    static const std::array<const char*, INDEX_CAST(Key::ENUM_SIZE)> keyNames;
+    static constexpr std::array<const char*, INDEX_CAST(Key::ENUM_SIZE)> keyNames = {
+      "Invalid",
+      "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M",
+      "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z",
+
+      "Space", "Comma", "Period", "Semicolon", "Slash", "Tilde",
+      "LeftBracket", "RightBracket", "Backslash", "Quote",
+
+      "LeftShift", "RightShift", "LeftCtrl", "RightCtrl",
+      "LeftAlt", "RightAlt", "LeftSystem", "RightSystem",
+      "Tab", "Backspace", "Enter", "CapsLock", "Escape",
+
+      "Num0", "Num1", "Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8", "Num9", "Dash", "Equals",
+
+      "Numpad0", "Numpad1", "Numpad2", "Numpad3", "Numpad4", "Numpad5", "Numpad6",
+      "Numpad7", "Numpad8", "Numpad9", "Add", "Subtract", "Multiply", "Divide", "NumLock",
+
+      "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12",
+
+      "PrintScreen", "ScrollLock", "Pause",
+      "Insert", "Delete", "Home", "End", "PageUp", "PageDown",
+      "Up", "Down", "Left", "Right",
+    };
   };
 }
\ No newline at end of file
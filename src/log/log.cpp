@@ -10,6 +10,9 @@ namespace rp::log {
   const std::string          rapier_prefix = "Rapier";
   const size_t        rapier_prefix_length = rapier_prefix.length();
   size_t              source_prefix_length = calculateSourcePrefixLength(client_prefix.length()); 
+  std::FILE*                   output_file = stdout;
+
+  std::array<std::atomic<uint64_t>, INDEX_CAST(log::Level::ENUM_SIZE)> message_counts = {};
 
   constexpr std::array<const char*, INDEX_CAST(log::Level::ENUM_SIZE)> kLevelPrefixes = {
     "[Trace]",
@@ -26,6 +29,8 @@ namespace rp::log {
   };
 
   void logMessage(Source log_source, Level log_level, std::string_view format_string, fmt::format_args args) {
+    message_counts[INDEX_CAST(log_level)].fetch_add(1, std::memory_order_relaxed);
+
     // Log Format: [Source] Level: {Formatted String}
     auto source_prefix = fmt::format("{:<{}}",
       fmt::format("[{}]", ((log_source == Source::Engine) ? rapier_prefix : client_prefix)),
@@ -33,7 +38,7 @@ namespace rp::log {
 
     auto message = fmt::vformat(format_string, args);  
 
-    fmt::print(fg(kLevelColors[INDEX_CAST(log_level)]),
+    fmt::print(output_file, fg(kLevelColors[INDEX_CAST(log_level)]),
       fmt::format("{} {} {}\n",
         source_prefix,
         kLevelPrefixes[INDEX_CAST(log_level)],
@@ -57,4 +62,12 @@ namespace rp::log {
     client_prefix = prefix; 
     source_prefix_length = calculateSourcePrefixLength(client_prefix.length());
   }
+
+  void setOutput(std::FILE* output) {
+    output_file = output;
+  }
+
+  uint64_t getMessageCount(Level log_level) {
+    return message_counts[INDEX_CAST(log_level)].load(std::memory_order_relaxed);
+  }
 }
\ No newline at end of file
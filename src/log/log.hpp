@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <string_view>
 #include <array>
 
@@ -19,6 +20,13 @@ namespace rp::log {
   constexpr auto new_line   = "\n";
 
   void setClientPrefix(std::string_view client_name);
+
+  //Redirects log output, defaults to stdout
+  void setOutput(std::FILE* output);
+
+  //Messages logged at a level since startup, from engine and client alike
+  [[nodiscard]] uint64_t getMessageCount(Level log_level);
+
   void logClientMessage(Level log_level, std::string_view format_string, fmt::format_args args);
 
   template<typename... Args>
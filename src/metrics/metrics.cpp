@@ -0,0 +1,124 @@
+#include "pch.hpp"
+#include "metrics/metrics_internal.hpp"
+#include "util/process.hpp"
+#include "util/shared_memory.hpp"
+
+namespace rp::metrics {
+  namespace {
+    //metrics start on their own cache line so threads updating neighbours don't contend
+    constexpr uint32_t slots_per_line = 64 / sizeof(uint64_t);
+
+    struct Manager {
+      SharedMemory shared;
+      std::unique_ptr<std::byte[]> local;
+      SegmentHeader* header = nullptr;
+      MetricDescriptor* descriptors = nullptr;
+      std::atomic<uint64_t>* values = nullptr;
+
+      std::mutex mutex;
+      uint32_t next_slot = 0;
+    };
+
+    std::unique_ptr<Manager> manager;
+
+    Manager& getManager() {
+      if(!manager) {
+        throw std::runtime_error("Metrics system used before rp::run initialized it!");
+      }
+      return *manager;
+    }
+
+    std::atomic<uint64_t>* getValues(std::string_view name, Kind kind) {
+      auto& mgr = getManager();
+      if(name.empty() || name.size() >= name_capacity) {
+        throw std::invalid_argument(fmt::format("Metric name '{}' must be 1 to {} characters!", name, name_capacity - 1));
+      }
+
+      std::lock_guard lock(mgr.mutex);
+      const uint32_t count = mgr.header->metric_count.load(std::memory_order_relaxed);
+      for(uint32_t i = 0; i < count; i++) {
+        const auto& descriptor = mgr.descriptors[i];
+        if(std::string_view(descriptor.name.data()) == name) {
+          if(descriptor.kind != kind) {
+            throw std::invalid_argument(fmt::format("Metric '{}' is already registered as another kind!", name));
+          }
+          return &mgr.values[descriptor.value_index];
+        }
+      }
+
+      const uint32_t first_slot = (mgr.next_slot + slots_per_line - 1) / slots_per_line * slots_per_line;
+      if(count == max_metrics || first_slot + getValueCount(kind) > value_slots) {
+        throw std::length_error(fmt::format("No room left for metric '{}'!", name));
+      }
+
+      auto& descriptor = mgr.descriptors[count];
+      descriptor.name = {};
+      std::copy(name.begin(), name.end(), descriptor.name.begin());
+      descriptor.kind = kind;
+      descriptor.value_index = first_slot;
+      descriptor.value_count = getValueCount(kind);
+      mgr.next_slot = first_slot + descriptor.value_count;
+
+      //publishes the descriptor to monitors reading the count with acquire
+      mgr.header->metric_count.store(count + 1, std::memory_order_release);
+      return &mgr.values[first_slot];
+    }
+  }
+
+  void init(const Properties& properties) {
+    manager = std::make_unique<Manager>();
+    std::byte* base = nullptr;
+    if(properties.shared) {
+      const auto name = getSegmentName(getProcessId());
+      try {
+        manager->shared = SharedMemory::Create(name, segment_size);
+        base = manager->shared.data().data();
+        log::rp_info("Publishing metrics as {}", name);
+      } catch(const std::exception& e) {
+        log::rp_warn("Metrics stay private to this process: {}", e.what());
+      }
+    }
+    if(!base) {
+      manager->local = std::make_unique<std::byte[]>(segment_size);
+      base = manager->local.get();
+    }
+
+    //the header goes last so a monitor never sees the magic before the rest is in place
+    manager->descriptors = reinterpret_cast<MetricDescriptor*>(base + descriptors_offset);
+    manager->values = reinterpret_cast<std::atomic<uint64_t>*>(base + values_offset);
+    std::uninitialized_value_construct_n(manager->descriptors, max_metrics);
+    std::uninitialized_value_construct_n(manager->values, value_slots);
+
+    auto* header = new (base) SegmentHeader{};
+    header->layout_version = layout_version;
+    header->process_id = getProcessId();
+    header->max_metrics = max_metrics;
+    header->value_slots = value_slots;
+    header->histogram_buckets = histogram_buckets;
+    header->descriptors_offset = descriptors_offset;
+    header->values_offset = values_offset;
+    header->segment_size = segment_size;
+    header->magic.store(segment_magic, std::memory_order_release);
+    manager->header = header;
+  }
+
+  void beat() {
+    getManager().header->heartbeat.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void shutdown() {
+    manager.reset();
+  }
+
+  Counter getCounter(std::string_view name) {
+    return Counter(getValues(name, Kind::Counter));
+  }
+
+  Gauge getGauge(std::string_view name) {
+    return Gauge(getValues(name, Kind::Gauge));
+  }
+
+  Histogram getHistogram(std::string_view name) {
+    return Histogram(getValues(name, Kind::Histogram));
+  }
+}
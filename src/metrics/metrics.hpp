@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+#include "metrics/metrics_layout.hpp"
+
+//Live engine and app metrics
+//
+//Counters, gauges and histograms live in a named shared memory segment (see metrics_layout.hpp)
+//so monitors like rapier_top can read them from another process while the game runs. Getting a
+//metric takes a lock, updating one through its handle is a relaxed atomic with no syscalls or
+//formatting, from any thread. Getting a name again returns the same metric. Handles stay valid
+//until rp::run returns, default constructed handles ignore updates.
+namespace rp::metrics {
+  struct Properties {
+    bool shared = true;  //publish as getSegmentName(pid), otherwise keep the segment in private memory
+  };
+
+  class Counter {
+  public:
+    Counter() = default;
+    explicit Counter(std::atomic<uint64_t>* value) : mValue(value) {}
+
+    void add(uint64_t amount = 1) const noexcept {
+      if(mValue) {
+        mValue->fetch_add(amount, std::memory_order_relaxed);
+      }
+    }
+    //Mirrors a total kept elsewhere
+    void set(uint64_t total) const noexcept {
+      if(mValue) {
+        mValue->store(total, std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    std::atomic<uint64_t>* mValue = nullptr;
+  };
+
+  class Gauge {
+  public:
+    Gauge() = default;
+    explicit Gauge(std::atomic<uint64_t>* value) : mValue(value) {}
+
+    void set(double value) const noexcept {
+      if(mValue) {
+        mValue->store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    std::atomic<uint64_t>* mValue = nullptr;
+  };
+
+  class Histogram {
+  public:
+    Histogram() = default;
+    explicit Histogram(std::atomic<uint64_t>* values) : mValues(values) {}
+
+    void record(uint64_t value) const noexcept {
+      if(mValues) {
+        const auto bucket = std::min<uint32_t>(static_cast<uint32_t>(std::bit_width(value)), histogram_buckets - 1);
+        mValues[0].fetch_add(1, std::memory_order_relaxed);
+        mValues[1].fetch_add(value, std::memory_order_relaxed);
+        mValues[2 + bucket].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    std::atomic<uint64_t>* mValues = nullptr;
+  };
+
+  //Throw std::invalid_argument if the name is too long or taken by another kind,
+  //std::length_error when the segment has no room left
+  [[nodiscard]] Counter getCounter(std::string_view name);
+  [[nodiscard]] Gauge getGauge(std::string_view name);
+  [[nodiscard]] Histogram getHistogram(std::string_view name);
+}
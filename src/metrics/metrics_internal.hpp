@@ -0,0 +1,12 @@
+#pragma once
+
+#include "metrics/metrics.hpp"
+
+namespace rp::metrics {
+  void init(const Properties& properties);
+
+  //Bumps the segment heartbeat, called once per frame
+  void beat();
+
+  void shutdown();
+}
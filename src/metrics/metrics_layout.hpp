@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <fmt/format.h>
+
+//Layout of the shared metrics segment, read by external monitors such as rapier_top.
+//Any change to these structs or constants must bump layout_version.
+//
+//  SegmentHeader
+//  MetricDescriptor[max_metrics]
+//  std::atomic<uint64_t>[value_slots]
+//
+//A metric owns value_count slots starting at value_index. Counters are one slot holding the count,
+//gauges one slot holding the bits of a double, and histograms [count, sum, buckets...] where bucket 0
+//counts zeros, bucket i counts values in [2^(i-1), 2^i) and the last bucket everything larger.
+namespace rp::metrics {
+  constexpr uint32_t segment_magic = 'R' | ('P' << 8) | ('M' << 16) | ('X' << 24);  //"RPMX" in memory
+  constexpr uint32_t layout_version = 1;
+  constexpr uint32_t max_metrics = 256;
+  constexpr uint32_t value_slots = 8192;
+  constexpr uint32_t histogram_buckets = 40;
+  constexpr size_t name_capacity = 48;
+
+  enum class Kind : uint32_t {
+    Counter = 1,
+    Gauge = 2,
+    Histogram = 3,
+  };
+
+  struct SegmentHeader {
+    std::atomic<uint32_t> magic;         //stored last with release, once the rest of the segment is in place
+    uint32_t layout_version;
+    uint32_t process_id;
+    uint32_t max_metrics;
+    uint32_t value_slots;
+    uint32_t histogram_buckets;
+    std::atomic<uint32_t> metric_count;  //descriptors below this are complete, stored with release
+    uint32_t reserved;
+    uint64_t descriptors_offset;
+    uint64_t values_offset;
+    uint64_t segment_size;
+    std::atomic<uint64_t> heartbeat;      //bumped every frame, a monitor can tell a stalled engine by it
+  };
+  static_assert(sizeof(SegmentHeader) == 64);
+
+  struct MetricDescriptor {
+    std::array<char, name_capacity> name;  //null terminated
+    Kind kind;
+    uint32_t value_index;
+    uint32_t value_count;
+    uint32_t reserved;
+  };
+  static_assert(sizeof(MetricDescriptor) == 64);
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                "shared metrics need address free atomics");
+
+  constexpr uint64_t descriptors_offset = sizeof(SegmentHeader);
+  constexpr uint64_t values_offset = descriptors_offset + max_metrics * sizeof(MetricDescriptor);
+  constexpr uint64_t segment_size = values_offset + value_slots * sizeof(uint64_t);
+
+  constexpr uint32_t getValueCount(Kind kind) {
+    return (kind == Kind::Histogram) ? 2 + histogram_buckets : 1;
+  }
+
+  //Lower bound of a histogram bucket
+  constexpr uint64_t getBucketFloor(uint32_t bucket) {
+    return (bucket == 0) ? 0 : uint64_t(1) << (bucket - 1);
+  }
+
+  inline std::string getSegmentName(uint32_t process_id) {
+    return fmt::format("rapier_metrics_{}", process_id);
+  }
+}
@@ -3,12 +3,31 @@
 //standard library headers
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iomanip>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
 #include <random>
+#include <span>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 //fmt format library
 #include <fmt/format.h>
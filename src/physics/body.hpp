@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#include "physics/math.hpp"
+#include "physics/shape.hpp"
+
+namespace rp::physics {
+  enum class BodyType : uint8_t {
+    Static,
+    Dynamic,
+  };
+
+  struct BodyId {
+    static constexpr uint32_t invalid_index = 0xFFFFFFFF;
+
+    uint32_t index = invalid_index;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool isValid() const noexcept { return index != invalid_index; }
+    bool operator==(const BodyId& rhs) const = default;
+  };
+
+  struct BodyDef {
+    BodyType type = BodyType::Dynamic;
+    Vec2 position;
+    float angle = 0.0f;
+    Vec2 velocity;
+    float angularVelocity = 0.0f;
+    Shape shape = Shape::Circle(0.5f);
+    float density = 1.0f;
+    float friction = 0.6f;
+    float restitution = 0.0f;
+    float linearDamping = 0.0f;
+    float angularDamping = 0.01f;
+    uint64_t userData = 0;
+  };
+
+  struct Body {
+    Transform transform;
+    float angle = 0.0f;
+    Vec2 velocity;
+    float angular_velocity = 0.0f;
+    Vec2 force;
+    float torque = 0.0f;
+
+    float inv_mass = 0.0f;
+    float inv_inertia = 0.0f;
+    float friction = 0.6f;
+    float restitution = 0.0f;
+    float linear_damping = 0.0f;
+    float angular_damping = 0.0f;
+
+    Shape shape;
+    AABB aabb;
+    AABB fat_aabb;
+    int32_t proxy = -1;
+
+    BodyType type = BodyType::Dynamic;
+    bool alive = false;
+    uint32_t generation = 0;
+    uint64_t user_data = 0;
+
+    [[nodiscard]] bool isDynamic() const noexcept { return type == BodyType::Dynamic; }
+  };
+}
@@ -0,0 +1,340 @@
+#include "pch.hpp"
+
+#include <bit>
+#include <cfloat>
+
+#include "physics/broadphase.hpp"
+#include "util/simd.hpp"
+
+namespace rp::physics {
+  namespace {
+    constexpr float aabb_margin = 0.1f;
+
+    //LSD radix sort, 11 bits per pass. Passes where every key has the same digit are skipped,
+    //which is common since body indices rarely use the full 32 bits.
+    void sortPairs(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+      constexpr size_t radix_bits = 11;
+      constexpr size_t bucket_count = size_t{1} << radix_bits;
+      if(keys.size() < 256) {
+        std::sort(keys.begin(), keys.end());
+        return;
+      }
+
+      scratch.resize(keys.size());
+      std::vector<uint32_t> counts(bucket_count);
+      for(size_t shift = 0; shift < 64; shift += radix_bits) {
+        std::fill(counts.begin(), counts.end(), 0);
+        for(uint64_t key : keys) {
+          counts[(key >> shift) & (bucket_count - 1)]++;
+        }
+        if(counts[(keys.front() >> shift) & (bucket_count - 1)] == keys.size()) {
+          continue;
+        }
+
+        uint32_t total = 0;
+        for(auto& count : counts) {
+          const uint32_t bucket_size = count;
+          count = total;
+          total += bucket_size;
+        }
+        for(uint64_t key : keys) {
+          scratch[counts[(key >> shift) & (bucket_count - 1)]++] = key;
+        }
+        keys.swap(scratch);
+      }
+    }
+
+    //Collects per-chunk results from parallel loops
+    class PairCollector {
+    public:
+      explicit PairCollector(std::vector<uint64_t>& pairs) : mPairs(pairs) {}
+
+      void append(const std::vector<uint64_t>& local) {
+        if(local.empty()) {
+          return;
+        }
+        std::lock_guard lock(mMutex);
+        mPairs.insert(mPairs.end(), local.begin(), local.end());
+      }
+
+    private:
+      std::vector<uint64_t>& mPairs;
+      std::mutex mMutex;
+    };
+
+    //Static and dynamic bodies get separate trees, so large static bodies like the ground
+    //don't inflate the nodes every dynamic query descends through
+    class TreeBroadphase : public Broadphase {
+    public:
+      void addBody(uint32_t index, Body& body) override {
+        body.fat_aabb = body.aabb.expanded(aabb_margin);
+        body.proxy = getTree(body).createProxy(body.fat_aabb, index);
+      }
+
+      void removeBody(uint32_t, Body& body) override {
+        getTree(body).destroyProxy(body.proxy);
+        body.proxy = -1;
+      }
+
+      void findPairs(std::span<Body> bodies, ThreadPool& pool, std::vector<uint64_t>& pairs) override {
+        //reinsert proxies that left their fat AABB, the trees aren't thread safe for writes.
+        //Tight bounds are copied out so queries don't pull whole bodies into cache.
+        mBounds.resize(bodies.size());
+        for(uint32_t i = 0; i < bodies.size(); i++) {
+          Body& body = bodies[i];
+          if(!body.alive) {
+            continue;
+          }
+          mBounds[i] = body.aabb;
+          if(!body.fat_aabb.contains(body.aabb)) {
+            body.fat_aabb = body.aabb.expanded(aabb_margin);
+            getTree(body).moveProxy(body.proxy, body.fat_aabb);
+          }
+        }
+
+        pairs.clear();
+        PairCollector collector(pairs);
+        pool.parallelFor(bodies.size(), 256, [&](size_t begin, size_t end) {
+          std::vector<uint64_t> local;
+          for(size_t i = begin; i < end; i++) {
+            if(!bodies[i].alive || !bodies[i].isDynamic()) {
+              continue;
+            }
+
+            const uint32_t index = static_cast<uint32_t>(i);
+            const AABB& bounds = mBounds[i];
+            mStaticTree.query(bounds, [&](uint32_t other) {
+              if(bounds.overlaps(mBounds[other])) {
+                local.push_back(makePairKey(index, other));
+              }
+            });
+            //dynamic pairs are found from both sides, keep the one found by the lower index
+            mDynamicTree.query(bounds, [&](uint32_t other) {
+              if(other > index && bounds.overlaps(mBounds[other])) {
+                local.push_back(makePairKey(index, other));
+              }
+            });
+          }
+          collector.append(local);
+        });
+
+        sortPairs(pairs, mScratch);
+      }
+
+    private:
+      DynamicTree& getTree(const Body& body) { return body.isDynamic() ? mDynamicTree : mStaticTree; }
+
+      DynamicTree mStaticTree;
+      DynamicTree mDynamicTree;
+      std::vector<AABB> mBounds;
+      std::vector<uint64_t> mScratch;
+    };
+
+    class GridBroadphase : public Broadphase {
+    public:
+      explicit GridBroadphase(float cell_size) : mFixedCellSize(cell_size) {}
+
+      void addBody(uint32_t, Body&) override {}
+      void removeBody(uint32_t, Body&) override {}
+
+      void findPairs(std::span<Body> bodies, ThreadPool& pool, std::vector<uint64_t>& pairs) override;
+
+    private:
+      struct Bounds {
+        std::vector<float> min_x, min_y, max_x, max_y;
+        std::vector<uint32_t> body;
+        std::vector<uint8_t> dynamic;
+
+        void clear() {
+          min_x.clear(); min_y.clear(); max_x.clear(); max_y.clear();
+          body.clear(); dynamic.clear();
+        }
+        void resize(size_t size) {
+          min_x.resize(size); min_y.resize(size); max_x.resize(size); max_y.resize(size);
+          body.resize(size); dynamic.resize(size);
+        }
+        void set(size_t slot, uint32_t index, const Body& b) {
+          min_x[slot] = b.aabb.min.x; min_y[slot] = b.aabb.min.y;
+          max_x[slot] = b.aabb.max.x; max_y[slot] = b.aabb.max.y;
+          body[slot] = index;
+          dynamic[slot] = b.isDynamic();
+        }
+        void push(uint32_t index, const Body& b) {
+          resize(body.size() + 1);
+          set(body.size() - 1, index, b);
+        }
+      };
+
+      //Calls found(j) for each j in [begin, end) whose bounds overlap the query box, 4 at a time with SSE2
+      template<typename Found>
+      static void overlapRange(const Bounds& bounds, size_t begin, size_t end, const AABB& box, Found&& found) {
+        size_t j = begin;
+#if RP_SSE2
+        const __m128 q_min_x = _mm_set1_ps(box.min.x), q_min_y = _mm_set1_ps(box.min.y);
+        const __m128 q_max_x = _mm_set1_ps(box.max.x), q_max_y = _mm_set1_ps(box.max.y);
+        for(; j + 4 <= end; j += 4) {
+          const __m128 overlap = _mm_and_ps(
+            _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&bounds.min_x[j]), q_max_x), _mm_cmple_ps(q_min_x, _mm_loadu_ps(&bounds.max_x[j]))),
+            _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&bounds.min_y[j]), q_max_y), _mm_cmple_ps(q_min_y, _mm_loadu_ps(&bounds.max_y[j]))));
+          int mask = _mm_movemask_ps(overlap);
+          while(mask) {
+            const int lane = std::countr_zero(static_cast<unsigned>(mask));
+            found(j + lane);
+            mask &= mask - 1;
+          }
+        }
+#endif
+        for(; j < end; j++) {
+          if(bounds.min_x[j] <= box.max.x && box.min.x <= bounds.max_x[j] &&
+             bounds.min_y[j] <= box.max.y && box.min.y <= bounds.max_y[j]) {
+            found(j);
+          }
+        }
+      }
+
+      float mFixedCellSize;
+      Bounds mRegular;   //bodies small enough to bin, one entry per body
+      Bounds mCells;     //regular bodies binned by cell, one entry per overlapped cell
+      Bounds mOversize;  //bodies spanning too many cells, tested against everything
+      std::vector<uint32_t> mCellStarts;
+      std::vector<uint64_t> mScratch;
+    };
+
+    void GridBroadphase::findPairs(std::span<Body> bodies, ThreadPool& pool, std::vector<uint64_t>& pairs) {
+      constexpr int32_t max_cells_per_axis = 4;
+
+      //pick a cell size about twice the average dynamic body
+      float cell_size = mFixedCellSize;
+      if(cell_size <= 0.0f) {
+        double extent_sum = 0.0;
+        size_t dynamic_count = 0;
+        for(const auto& body : bodies) {
+          if(body.alive && body.isDynamic()) {
+            extent_sum += std::max(body.aabb.max.x - body.aabb.min.x, body.aabb.max.y - body.aabb.min.y);
+            dynamic_count++;
+          }
+        }
+        cell_size = dynamic_count ? static_cast<float>(2.0 * extent_sum / static_cast<double>(dynamic_count)) : 1.0f;
+      }
+
+      mRegular.clear();
+      mOversize.clear();
+      AABB bounds{{FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX}};
+      for(uint32_t i = 0; i < bodies.size(); i++) {
+        const Body& body = bodies[i];
+        if(!body.alive) {
+          continue;
+        }
+        const Vec2 size = body.aabb.max - body.aabb.min;
+        if(size.x > cell_size * max_cells_per_axis || size.y > cell_size * max_cells_per_axis) {
+          mOversize.push(i, body);
+        } else {
+          mRegular.push(i, body);
+          bounds = AABB::Combine(bounds, body.aabb);
+        }
+      }
+
+      pairs.clear();
+      PairCollector collector(pairs);
+
+      if(!mRegular.body.empty()) {
+        //keep the cell count proportional to the body count for sparse worlds
+        const size_t max_cell_count = std::max<size_t>(1024, mRegular.body.size() * 4);
+        int32_t cells_x, cells_y;
+        while(true) {
+          cells_x = static_cast<int32_t>((bounds.max.x - bounds.min.x) / cell_size) + 1;
+          cells_y = static_cast<int32_t>((bounds.max.y - bounds.min.y) / cell_size) + 1;
+          if(static_cast<size_t>(cells_x) * static_cast<size_t>(cells_y) <= max_cell_count) {
+            break;
+          }
+          cell_size *= 2.0f;
+        }
+
+        const float inv_cell = 1.0f / cell_size;
+        auto cellCoord = [&](float value, float origin, int32_t cells) {
+          return std::clamp(static_cast<int32_t>((value - origin) * inv_cell), 0, cells - 1);
+        };
+
+        //counting sort of body entries into cells
+        const size_t cell_count = static_cast<size_t>(cells_x) * static_cast<size_t>(cells_y);
+        mCellStarts.assign(cell_count + 1, 0);
+        const size_t regular_count = mRegular.body.size();
+        for(size_t r = 0; r < regular_count; r++) {
+          const int32_t x0 = cellCoord(mRegular.min_x[r], bounds.min.x, cells_x), x1 = cellCoord(mRegular.max_x[r], bounds.min.x, cells_x);
+          const int32_t y0 = cellCoord(mRegular.min_y[r], bounds.min.y, cells_y), y1 = cellCoord(mRegular.max_y[r], bounds.min.y, cells_y);
+          for(int32_t y = y0; y <= y1; y++) {
+            for(int32_t x = x0; x <= x1; x++) {
+              mCellStarts[static_cast<size_t>(y) * cells_x + x + 1]++;
+            }
+          }
+        }
+        for(size_t c = 0; c < cell_count; c++) {
+          mCellStarts[c + 1] += mCellStarts[c];
+        }
+
+        mCells.resize(mCellStarts[cell_count]);
+        std::vector<uint32_t> cursor(mCellStarts.begin(), mCellStarts.end() - 1);
+        for(size_t r = 0; r < regular_count; r++) {
+          const uint32_t index = mRegular.body[r];
+          const int32_t x0 = cellCoord(mRegular.min_x[r], bounds.min.x, cells_x), x1 = cellCoord(mRegular.max_x[r], bounds.min.x, cells_x);
+          const int32_t y0 = cellCoord(mRegular.min_y[r], bounds.min.y, cells_y), y1 = cellCoord(mRegular.max_y[r], bounds.min.y, cells_y);
+          for(int32_t y = y0; y <= y1; y++) {
+            for(int32_t x = x0; x <= x1; x++) {
+              mCells.set(cursor[static_cast<size_t>(y) * cells_x + x]++, index, bodies[index]);
+            }
+          }
+        }
+
+        pool.parallelFor(cell_count, 64, [&](size_t begin, size_t end) {
+          std::vector<uint64_t> local;
+          for(size_t cell = begin; cell < end; cell++) {
+            const size_t first = mCellStarts[cell], last = mCellStarts[cell + 1];
+            for(size_t k = first; k + 1 < last; k++) {
+              const AABB box{{mCells.min_x[k], mCells.min_y[k]}, {mCells.max_x[k], mCells.max_y[k]}};
+              overlapRange(mCells, k + 1, last, box, [&](size_t l) {
+                if(!mCells.dynamic[k] && !mCells.dynamic[l]) {
+                  return;
+                }
+                //pairs sharing several cells are reported only by the cell holding the overlap's min corner
+                const int32_t owner_x = cellCoord(std::max(mCells.min_x[k], mCells.min_x[l]), bounds.min.x, cells_x);
+                const int32_t owner_y = cellCoord(std::max(mCells.min_y[k], mCells.min_y[l]), bounds.min.y, cells_y);
+                if(static_cast<size_t>(owner_y) * cells_x + owner_x == cell) {
+                  local.push_back(makePairKey(mCells.body[k], mCells.body[l]));
+                }
+              });
+            }
+          }
+          collector.append(local);
+        });
+      }
+
+      const size_t oversize_count = mOversize.body.size();
+      pool.parallelFor(oversize_count, 1, [&](size_t begin, size_t end) {
+        std::vector<uint64_t> local;
+        for(size_t o = begin; o < end; o++) {
+          const AABB box{{mOversize.min_x[o], mOversize.min_y[o]}, {mOversize.max_x[o], mOversize.max_y[o]}};
+          auto report = [&](const Bounds& others, size_t j) {
+            if(mOversize.dynamic[o] || others.dynamic[j]) {
+              local.push_back(makePairKey(mOversize.body[o], others.body[j]));
+            }
+          };
+          overlapRange(mRegular, 0, mRegular.body.size(), box, [&](size_t j) { report(mRegular, j); });
+          overlapRange(mOversize, o + 1, oversize_count, box, [&](size_t j) { report(mOversize, j); });
+        }
+        collector.append(local);
+      });
+
+      sortPairs(pairs, mScratch);
+    }
+  }
+
+  std::unique_ptr<Broadphase> createBroadphase(BroadphaseType type, float grid_cell_size) {
+    switch(type) {
+      case BroadphaseType::DynamicTree:
+        return std::make_unique<TreeBroadphase>();
+      case BroadphaseType::UniformGrid:
+        return std::make_unique<GridBroadphase>(grid_cell_size);
+    }
+    throw std::invalid_argument("Unknown broadphase type");
+  }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "physics/body.hpp"
+#include "physics/dynamic_tree.hpp"
+#include "util/thread_pool.hpp"
+
+namespace rp::physics {
+  enum class BroadphaseType : uint8_t {
+    DynamicTree,  //best for mixed sizes and sparse scenes, incremental between steps
+    UniformGrid,  //rebuilt every step, best for many similarly sized bodies
+  };
+
+  //Pairs are encoded as (lower body index << 32) | higher body index
+  constexpr uint64_t makePairKey(uint32_t a, uint32_t b) {
+    return (a < b) ? (uint64_t{a} << 32) | b : (uint64_t{b} << 32) | a;
+  }
+
+  class Broadphase {
+  public:
+    virtual ~Broadphase() = default;
+
+    virtual void addBody(uint32_t index, Body& body) = 0;
+    virtual void removeBody(uint32_t index, Body& body) = 0;
+
+    //Finds every pair of bodies with overlapping AABBs where at least one is dynamic.
+    //Pairs are written to pairs sorted ascending, so results are deterministic across thread counts.
+    virtual void findPairs(std::span<Body> bodies, ThreadPool& pool, std::vector<uint64_t>& pairs) = 0;
+  };
+
+  //grid_cell_size of 0 sizes grid cells from the bodies every step
+  std::unique_ptr<Broadphase> createBroadphase(BroadphaseType type, float grid_cell_size);
+}
@@ -0,0 +1,206 @@
+#include "pch.hpp"
+#include "physics/dynamic_tree.hpp"
+
+namespace rp::physics {
+  int32_t DynamicTree::allocateNode() {
+    if(mFreeList == null_node) {
+      mNodes.emplace_back();
+      return static_cast<int32_t>(mNodes.size() - 1);
+    }
+
+    const int32_t node = mFreeList;
+    mFreeList = mNodes[node].parent;
+    mNodes[node] = Node{};
+    return node;
+  }
+
+  void DynamicTree::freeNode(int32_t node) {
+    mNodes[node].parent = mFreeList;
+    mNodes[node].height = -1;
+    mFreeList = node;
+  }
+
+  int32_t DynamicTree::createProxy(const AABB& aabb, uint32_t user_data) {
+    const int32_t proxy = allocateNode();
+    mNodes[proxy].aabb = aabb;
+    mNodes[proxy].user_data = user_data;
+    mNodes[proxy].height = 0;
+    insertLeaf(proxy);
+    return proxy;
+  }
+
+  void DynamicTree::destroyProxy(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+  }
+
+  bool DynamicTree::moveProxy(int32_t proxy, const AABB& aabb) {
+    if(mNodes[proxy].aabb.contains(aabb)) {
+      return false;
+    }
+
+    removeLeaf(proxy);
+    mNodes[proxy].aabb = aabb;
+    insertLeaf(proxy);
+    return true;
+  }
+
+  void DynamicTree::insertLeaf(int32_t leaf) {
+    if(mRoot == null_node) {
+      mRoot = leaf;
+      mNodes[leaf].parent = null_node;
+      return;
+    }
+
+    //descend towards the sibling that minimizes the surface area heuristic
+    const AABB leaf_aabb = mNodes[leaf].aabb;
+    int32_t index = mRoot;
+    while(!mNodes[index].isLeaf()) {
+      const Node& node = mNodes[index];
+      const float area = node.aabb.perimeter();
+      const float combined_area = AABB::Combine(node.aabb, leaf_aabb).perimeter();
+
+      //cost of making a new parent for this node and the leaf, and the cost pushed down to children
+      const float cost = 2.0f * combined_area;
+      const float inheritance_cost = 2.0f * (combined_area - area);
+
+      auto childCost = [&](int32_t child) {
+        const AABB combined = AABB::Combine(leaf_aabb, mNodes[child].aabb);
+        const float new_area = combined.perimeter();
+        return mNodes[child].isLeaf()
+          ? new_area + inheritance_cost
+          : (new_area - mNodes[child].aabb.perimeter()) + inheritance_cost;
+      };
+
+      const float cost1 = childCost(node.child1);
+      const float cost2 = childCost(node.child2);
+      if(cost < cost1 && cost < cost2) {
+        break;
+      }
+      index = (cost1 < cost2) ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t old_parent = mNodes[sibling].parent;
+    const int32_t new_parent = allocateNode();
+    mNodes[new_parent].parent = old_parent;
+    mNodes[new_parent].aabb = AABB::Combine(leaf_aabb, mNodes[sibling].aabb);
+    mNodes[new_parent].height = mNodes[sibling].height + 1;
+    mNodes[new_parent].child1 = sibling;
+    mNodes[new_parent].child2 = leaf;
+    mNodes[sibling].parent = new_parent;
+    mNodes[leaf].parent = new_parent;
+
+    if(old_parent == null_node) {
+      mRoot = new_parent;
+    } else if(mNodes[old_parent].child1 == sibling) {
+      mNodes[old_parent].child1 = new_parent;
+    } else {
+      mNodes[old_parent].child2 = new_parent;
+    }
+
+    //refit and rebalance up to the root
+    index = mNodes[leaf].parent;
+    while(index != null_node) {
+      index = balance(index);
+      Node& node = mNodes[index];
+      node.height = 1 + std::max(mNodes[node.child1].height, mNodes[node.child2].height);
+      node.aabb = AABB::Combine(mNodes[node.child1].aabb, mNodes[node.child2].aabb);
+      index = node.parent;
+    }
+  }
+
+  void DynamicTree::removeLeaf(int32_t leaf) {
+    if(leaf == mRoot) {
+      mRoot = null_node;
+      return;
+    }
+
+    const int32_t parent = mNodes[leaf].parent;
+    const int32_t grand_parent = mNodes[parent].parent;
+    const int32_t sibling = (mNodes[parent].child1 == leaf) ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if(grand_parent == null_node) {
+      mRoot = sibling;
+      mNodes[sibling].parent = null_node;
+      freeNode(parent);
+      return;
+    }
+
+    if(mNodes[grand_parent].child1 == parent) {
+      mNodes[grand_parent].child1 = sibling;
+    } else {
+      mNodes[grand_parent].child2 = sibling;
+    }
+    mNodes[sibling].parent = grand_parent;
+    freeNode(parent);
+
+    int32_t index = grand_parent;
+    while(index != null_node) {
+      index = balance(index);
+      Node& node = mNodes[index];
+      node.aabb = AABB::Combine(mNodes[node.child1].aabb, mNodes[node.child2].aabb);
+      node.height = 1 + std::max(mNodes[node.child1].height, mNodes[node.child2].height);
+      index = node.parent;
+    }
+  }
+
+  //Rotates node a's taller grandchild up if its children's heights differ by more than one.
+  //Returns the index of the node now at a's position.
+  int32_t DynamicTree::balance(int32_t a_index) {
+    Node& a = mNodes[a_index];
+    if(a.isLeaf() || a.height < 2) {
+      return a_index;
+    }
+
+    const int32_t b_index = a.child1;
+    const int32_t c_index = a.child2;
+    const int32_t height_difference = mNodes[c_index].height - mNodes[b_index].height;
+
+    auto rotateUp = [&](int32_t up_index, int32_t other_index, bool up_is_child2) {
+      Node& up = mNodes[up_index];
+      const int32_t f_index = up.child1;
+      const int32_t g_index = up.child2;
+
+      //swap a and up
+      up.child1 = a_index;
+      up.parent = a.parent;
+      a.parent = up_index;
+
+      if(up.parent == null_node) {
+        mRoot = up_index;
+      } else if(mNodes[up.parent].child1 == a_index) {
+        mNodes[up.parent].child1 = up_index;
+      } else {
+        mNodes[up.parent].child2 = up_index;
+      }
+
+      //the taller of up's children stays with up, the other replaces up under a
+      const bool keep_f = mNodes[f_index].height > mNodes[g_index].height;
+      const int32_t keep_index = keep_f ? f_index : g_index;
+      const int32_t move_index = keep_f ? g_index : f_index;
+
+      up.child2 = keep_index;
+      if(up_is_child2) {
+        a.child2 = move_index;
+      } else {
+        a.child1 = move_index;
+      }
+      mNodes[move_index].parent = a_index;
+
+      a.aabb = AABB::Combine(mNodes[other_index].aabb, mNodes[move_index].aabb);
+      a.height = 1 + std::max(mNodes[other_index].height, mNodes[move_index].height);
+      up.aabb = AABB::Combine(a.aabb, mNodes[keep_index].aabb);
+      up.height = 1 + std::max(a.height, mNodes[keep_index].height);
+      return up_index;
+    };
+
+    if(height_difference > 1) {
+      return rotateUp(c_index, b_index, true);
+    }
+    if(height_difference < -1) {
+      return rotateUp(b_index, c_index, false);
+    }
+    return a_index;
+  }
+}
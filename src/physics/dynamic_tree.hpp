@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "physics/math.hpp"
+
+namespace rp::physics {
+  //Bounding volume hierarchy over fattened AABBs, kept balanced with tree rotations.
+  //Proxies only need reinserting once their object leaves its fat AABB.
+  class DynamicTree {
+  public:
+    static constexpr int32_t null_node = -1;
+
+    int32_t createProxy(const AABB& aabb, uint32_t user_data);
+    void destroyProxy(int32_t proxy);
+
+    //Returns true if the proxy had to be reinserted
+    bool moveProxy(int32_t proxy, const AABB& aabb);
+
+    [[nodiscard]] const AABB& getFatAABB(int32_t proxy) const { return mNodes[proxy].aabb; }
+    [[nodiscard]] uint32_t getUserData(int32_t proxy) const { return mNodes[proxy].user_data; }
+    [[nodiscard]] int32_t getHeight() const { return (mRoot == null_node) ? 0 : mNodes[mRoot].height; }
+
+    //Calls callback(user_data) for every proxy whose fat AABB overlaps aabb. Safe to call from several threads.
+    template<typename Callback>
+    void query(const AABB& aabb, Callback&& callback) const {
+      if(mRoot == null_node) {
+        return;
+      }
+
+      int32_t stack[128];
+      int32_t stack_size = 0;
+      stack[stack_size++] = mRoot;
+      while(stack_size > 0) {
+        const Node& node = mNodes[stack[--stack_size]];
+        if(!node.aabb.overlaps(aabb)) {
+          continue;
+        }
+
+        if(node.isLeaf()) {
+          callback(node.user_data);
+        } else if(stack_size + 2 <= 128) {
+          stack[stack_size++] = node.child1;
+          stack[stack_size++] = node.child2;
+        }
+      }
+    }
+
+  private:
+    struct Node {
+      AABB aabb;
+      int32_t parent = null_node;  //next free node while on the free list
+      int32_t child1 = null_node;
+      int32_t child2 = null_node;
+      int32_t height = -1;
+      uint32_t user_data = 0;
+
+      [[nodiscard]] bool isLeaf() const { return child1 == null_node; }
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t node);
+
+    std::vector<Node> mNodes;
+    int32_t mRoot = null_node;
+    int32_t mFreeList = null_node;
+  };
+}
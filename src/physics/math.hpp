@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace rp::physics {
+  struct Vec2 {
+    float x = 0.0f;
+    float y = 0.0f;
+
+    constexpr Vec2 operator+(Vec2 rhs) const { return {x + rhs.x, y + rhs.y}; }
+    constexpr Vec2 operator-(Vec2 rhs) const { return {x - rhs.x, y - rhs.y}; }
+    constexpr Vec2 operator-() const { return {-x, -y}; }
+    constexpr Vec2 operator*(float s) const { return {x * s, y * s}; }
+    constexpr Vec2& operator+=(Vec2 rhs) { x += rhs.x; y += rhs.y; return *this; }
+    constexpr Vec2& operator-=(Vec2 rhs) { x -= rhs.x; y -= rhs.y; return *this; }
+    constexpr Vec2& operator*=(float s) { x *= s; y *= s; return *this; }
+  };
+
+  constexpr Vec2 operator*(float s, Vec2 v) { return {s * v.x, s * v.y}; }
+
+  constexpr float dot(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+  constexpr float cross(Vec2 a, Vec2 b) { return a.x * b.y - a.y * b.x; }
+  constexpr Vec2 cross(Vec2 v, float s) { return {s * v.y, -s * v.x}; }
+  constexpr Vec2 cross(float s, Vec2 v) { return {-s * v.y, s * v.x}; }
+  constexpr Vec2 perp(Vec2 v) { return {-v.y, v.x}; }
+  constexpr Vec2 min(Vec2 a, Vec2 b) { return {std::min(a.x, b.x), std::min(a.y, b.y)}; }
+  constexpr Vec2 max(Vec2 a, Vec2 b) { return {std::max(a.x, b.x), std::max(a.y, b.y)}; }
+  constexpr float lengthSquared(Vec2 v) { return dot(v, v); }
+  inline float length(Vec2 v) { return std::sqrt(dot(v, v)); }
+
+  inline Vec2 normalize(Vec2 v) {
+    const float len = length(v);
+    return (len > 1e-12f) ? v * (1.0f / len) : Vec2{};
+  }
+
+  //Rotation stored as cosine/sine
+  struct Rot {
+    float c = 1.0f;
+    float s = 0.0f;
+
+    static Rot FromAngle(float angle) { return {std::cos(angle), std::sin(angle)}; }
+
+    constexpr Vec2 rotate(Vec2 v) const { return {c * v.x - s * v.y, s * v.x + c * v.y}; }
+    constexpr Vec2 invRotate(Vec2 v) const { return {c * v.x + s * v.y, -s * v.x + c * v.y}; }
+  };
+
+  struct Transform {
+    Vec2 p;
+    Rot q;
+
+    constexpr Vec2 apply(Vec2 v) const { return q.rotate(v) + p; }
+    constexpr Vec2 invApply(Vec2 v) const { return q.invRotate(v - p); }
+  };
+
+  struct AABB {
+    Vec2 min;
+    Vec2 max;
+
+    constexpr bool overlaps(const AABB& rhs) const {
+      return min.x <= rhs.max.x && rhs.min.x <= max.x && min.y <= rhs.max.y && rhs.min.y <= max.y;
+    }
+    constexpr bool contains(const AABB& rhs) const {
+      return min.x <= rhs.min.x && min.y <= rhs.min.y && rhs.max.x <= max.x && rhs.max.y <= max.y;
+    }
+    constexpr float perimeter() const { return 2.0f * ((max.x - min.x) + (max.y - min.y)); }
+    constexpr AABB expanded(float margin) const { return {{min.x - margin, min.y - margin}, {max.x + margin, max.y + margin}}; }
+
+    static constexpr AABB Combine(const AABB& a, const AABB& b) {
+      return {physics::min(a.min, b.min), physics::max(a.max, b.max)};
+    }
+  };
+}
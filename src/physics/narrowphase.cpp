@@ -0,0 +1,354 @@
+#include "pch.hpp"
+
+#include <cfloat>
+
+#include "physics/narrowphase.hpp"
+#include "util/simd.hpp"
+
+namespace rp::physics {
+  namespace {
+    //Contact found by a collision routine, normal pointing from the first shape to the second
+    struct WorldContact {
+      Vec2 normal;
+      uint8_t count = 0;
+      std::array<Vec2, 2> points;
+      std::array<float, 2> separations{};
+      std::array<uint32_t, 2> features{};
+
+      void add(Vec2 point, float separation, uint32_t feature) {
+        points[count] = point;
+        separations[count] = separation;
+        features[count] = feature;
+        count++;
+      }
+    };
+
+    //circle-circle contact from the centre offset, with the distance precomputed
+    void circlesFromDistance(Vec2 pa, float ra, Vec2 pb, float rb, Vec2 offset, float distance, WorldContact& contact) {
+      contact.normal = (distance > 1e-6f) ? offset * (1.0f / distance) : Vec2{0.0f, 1.0f};
+      const Vec2 surface_a = pa + contact.normal * ra;
+      const Vec2 surface_b = pb - contact.normal * rb;
+      contact.add((surface_a + surface_b) * 0.5f, distance - ra - rb, 0);
+    }
+
+    bool collideCircles(const Body& a, const Body& b, WorldContact& contact) {
+      const Vec2 offset = b.transform.p - a.transform.p;
+      const float reach = a.shape.radius + b.shape.radius + speculative_distance;
+      const float distance_squared = lengthSquared(offset);
+      if(distance_squared > reach * reach) {
+        return false;
+      }
+      circlesFromDistance(a.transform.p, a.shape.radius, b.transform.p, b.shape.radius, offset, std::sqrt(distance_squared), contact);
+      return true;
+    }
+
+    bool collidePolygonCircle(const Body& polygon, const Body& circle, WorldContact& contact) {
+      const Shape& shape = polygon.shape;
+      const float radius = circle.shape.radius;
+      const Vec2 centre = polygon.transform.invApply(circle.transform.p);
+
+      //face of least penetration
+      float max_separation = -FLT_MAX;
+      uint8_t edge = 0;
+      for(uint8_t i = 0; i < shape.count; i++) {
+        const float separation = dot(shape.normals[i], centre - shape.vertices[i]);
+        if(separation > radius + speculative_distance) {
+          return false;
+        }
+        if(separation > max_separation) {
+          max_separation = separation;
+          edge = i;
+        }
+      }
+
+      const Vec2 v1 = shape.vertices[edge];
+      const Vec2 v2 = shape.vertices[(edge + 1) % shape.count];
+      Vec2 normal = shape.normals[edge];
+      Vec2 surface = centre - normal * dot(centre - v1, normal);
+      uint32_t feature = edge;
+
+      //outside the face, the closest feature may be a vertex
+      if(max_separation > 1e-6f) {
+        if(dot(centre - v1, v2 - v1) <= 0.0f) {
+          surface = v1;
+          feature = 0x100u | edge;
+        } else if(dot(centre - v2, v1 - v2) <= 0.0f) {
+          surface = v2;
+          feature = 0x100u | ((edge + 1) % shape.count);
+        }
+        if(feature & 0x100u) {
+          const Vec2 to_centre = centre - surface;
+          if(lengthSquared(to_centre) > (radius + speculative_distance) * (radius + speculative_distance)) {
+            return false;
+          }
+          if(lengthSquared(to_centre) > 1e-12f) {
+            normal = normalize(to_centre);
+          }
+        }
+      }
+
+      const float separation = dot(centre - surface, normal) - radius;
+      if(separation > speculative_distance) {
+        return false;
+      }
+
+      contact.normal = polygon.transform.q.rotate(normal);
+      const Vec2 surface_a = polygon.transform.apply(surface);
+      const Vec2 surface_b = circle.transform.p - contact.normal * radius;
+      contact.add((surface_a + surface_b) * 0.5f, separation, feature);
+      return true;
+    }
+
+    struct WorldPolygon {
+      uint8_t count;
+      std::array<Vec2, max_polygon_vertices> vertices;
+      std::array<Vec2, max_polygon_vertices> normals;
+
+      explicit WorldPolygon(const Body& body) : count(body.shape.count) {
+        for(uint8_t i = 0; i < count; i++) {
+          vertices[i] = body.transform.apply(body.shape.vertices[i]);
+          normals[i] = body.transform.q.rotate(body.shape.normals[i]);
+        }
+      }
+    };
+
+    //Largest separation along the faces of p1, and the face it was found on
+    float findMaxSeparation(const WorldPolygon& p1, const WorldPolygon& p2, uint8_t& edge) {
+      float max_separation = -FLT_MAX;
+      for(uint8_t i = 0; i < p1.count; i++) {
+        float separation = FLT_MAX;
+        for(uint8_t j = 0; j < p2.count; j++) {
+          separation = std::min(separation, dot(p1.normals[i], p2.vertices[j] - p1.vertices[i]));
+        }
+        if(separation > max_separation) {
+          max_separation = separation;
+          edge = i;
+        }
+      }
+      return max_separation;
+    }
+
+    struct ClipVertex {
+      Vec2 v;
+      uint8_t id;
+    };
+
+    //Keeps the part of the segment behind the plane dot(normal, p) = offset
+    uint8_t clipSegment(const std::array<ClipVertex, 2>& in, std::array<ClipVertex, 2>& out, Vec2 normal, float offset, uint8_t plane) {
+      uint8_t count = 0;
+      const float d0 = dot(normal, in[0].v) - offset;
+      const float d1 = dot(normal, in[1].v) - offset;
+      if(d0 <= 0.0f) {
+        out[count++] = in[0];
+      }
+      if(d1 <= 0.0f) {
+        out[count++] = in[1];
+      }
+      if(d0 * d1 < 0.0f) {
+        out[count++] = {in[0].v + (in[1].v - in[0].v) * (d0 / (d0 - d1)), static_cast<uint8_t>(0x80u | plane)};
+      }
+      return count;
+    }
+
+    bool collidePolygons(const Body& a, const Body& b, WorldContact& contact) {
+      //prefer a's faces unless b's are clearly better, which keeps the reference face from flickering
+      constexpr float flip_tolerance = 0.0005f;
+
+      const WorldPolygon poly_a(a);
+      const WorldPolygon poly_b(b);
+
+      uint8_t edge_a = 0, edge_b = 0;
+      const float separation_a = findMaxSeparation(poly_a, poly_b, edge_a);
+      if(separation_a > speculative_distance) {
+        return false;
+      }
+      const float separation_b = findMaxSeparation(poly_b, poly_a, edge_b);
+      if(separation_b > speculative_distance) {
+        return false;
+      }
+
+      const bool flip = separation_b > separation_a + flip_tolerance;
+      const WorldPolygon& reference = flip ? poly_b : poly_a;
+      const WorldPolygon& incident = flip ? poly_a : poly_b;
+      const uint8_t edge = flip ? edge_b : edge_a;
+      const Vec2 normal = reference.normals[edge];
+
+      //incident edge is the one facing most against the reference normal
+      uint8_t incident_edge = 0;
+      float min_dot = FLT_MAX;
+      for(uint8_t i = 0; i < incident.count; i++) {
+        const float d = dot(normal, incident.normals[i]);
+        if(d < min_dot) {
+          min_dot = d;
+          incident_edge = i;
+        }
+      }
+
+      const uint8_t incident_next = static_cast<uint8_t>((incident_edge + 1) % incident.count);
+      const std::array<ClipVertex, 2> incident_points{{{incident.vertices[incident_edge], incident_edge},
+                                                       {incident.vertices[incident_next], incident_next}}};
+
+      const Vec2 v1 = reference.vertices[edge];
+      const Vec2 v2 = reference.vertices[(edge + 1) % reference.count];
+      const Vec2 tangent = normalize(v2 - v1);
+
+      std::array<ClipVertex, 2> clipped1{}, clipped2{};
+      if(clipSegment(incident_points, clipped1, -tangent, -dot(tangent, v1), 0) < 2 ||
+         clipSegment(clipped1, clipped2, tangent, dot(tangent, v2), 1) < 2) {
+        return false;
+      }
+
+      const float front = dot(normal, v1);
+      for(const auto& clip : clipped2) {
+        const float separation = dot(normal, clip.v) - front;
+        if(separation <= speculative_distance) {
+          const uint32_t feature = (uint32_t{flip} << 24) | (uint32_t{edge} << 16) | (uint32_t{incident_edge} << 8) | clip.id;
+          contact.add(clip.v - normal * (0.5f * separation), separation, feature);
+        }
+      }
+      contact.normal = flip ? -normal : normal;
+      return contact.count > 0;
+    }
+
+    bool collide(const Body& a, const Body& b, WorldContact& contact) {
+      const ShapeType type_a = a.shape.type, type_b = b.shape.type;
+      if(type_a == ShapeType::Circle && type_b == ShapeType::Circle) {
+        return collideCircles(a, b, contact);
+      }
+      if(type_a == ShapeType::Polygon && type_b == ShapeType::Circle) {
+        return collidePolygonCircle(a, b, contact);
+      }
+      if(type_a == ShapeType::Circle && type_b == ShapeType::Polygon) {
+        if(!collidePolygonCircle(b, a, contact)) {
+          return false;
+        }
+        contact.normal = -contact.normal;
+        return true;
+      }
+      return collidePolygons(a, b, contact);
+    }
+
+    void buildManifold(const Body& a, const Body& b, uint32_t index_a, uint32_t index_b, const WorldContact& contact,
+                       std::span<const Manifold> previous, Manifold& manifold) {
+      manifold.a = index_a;
+      manifold.b = index_b;
+      manifold.normal = contact.normal;
+      manifold.point_count = contact.count;
+      manifold.friction = std::sqrt(a.friction * b.friction);
+      manifold.restitution = std::max(a.restitution, b.restitution);
+
+      const uint64_t key = makePairKey(index_a, index_b);
+      auto match = std::lower_bound(previous.begin(), previous.end(), key,
+                                    [](const Manifold& m, uint64_t k) { return m.getKey() < k; });
+      const bool has_previous = (match != previous.end() && match->getKey() == key);
+
+      for(uint8_t i = 0; i < contact.count; i++) {
+        ContactPoint& point = manifold.points[i];
+        point = {};
+        point.anchor_a = contact.points[i] - a.transform.p;
+        point.anchor_b = contact.points[i] - b.transform.p;
+        point.separation = contact.separations[i];
+        point.feature = contact.features[i];
+
+        //warm start from the same features last step
+        if(has_previous) {
+          for(uint8_t j = 0; j < match->point_count; j++) {
+            if(match->points[j].feature == point.feature) {
+              point.normal_impulse = match->points[j].normal_impulse;
+              point.tangent_impulse = match->points[j].tangent_impulse;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    //Tests four circle pairs at once, only the touching ones get a manifold
+    void collideCircleBatch(std::span<const Body> bodies, std::span<const uint64_t> pairs, const size_t (&batch)[4],
+                            std::span<const Manifold> previous, std::span<Manifold> manifolds) {
+      alignas(16) float ax[4], ay[4], bx[4], by[4], reach[4], distance[4];
+      for(int lane = 0; lane < 4; lane++) {
+        const Body& a = bodies[pairs[batch[lane]] >> 32];
+        const Body& b = bodies[pairs[batch[lane]] & 0xFFFFFFFF];
+        ax[lane] = a.transform.p.x; ay[lane] = a.transform.p.y;
+        bx[lane] = b.transform.p.x; by[lane] = b.transform.p.y;
+        reach[lane] = a.shape.radius + b.shape.radius + speculative_distance;
+      }
+
+      int touching = 0;
+#if RP_SSE2
+      const __m128 dx = _mm_sub_ps(_mm_load_ps(bx), _mm_load_ps(ax));
+      const __m128 dy = _mm_sub_ps(_mm_load_ps(by), _mm_load_ps(ay));
+      const __m128 distance_squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      const __m128 r = _mm_load_ps(reach);
+      touching = _mm_movemask_ps(_mm_cmple_ps(distance_squared, _mm_mul_ps(r, r)));
+      _mm_store_ps(distance, _mm_sqrt_ps(distance_squared));
+#else
+      for(int lane = 0; lane < 4; lane++) {
+        const float dx = bx[lane] - ax[lane], dy = by[lane] - ay[lane];
+        const float distance_squared = dx * dx + dy * dy;
+        distance[lane] = std::sqrt(distance_squared);
+        touching |= (distance_squared <= reach[lane] * reach[lane]) << lane;
+      }
+#endif
+
+      for(int lane = 0; lane < 4; lane++) {
+        if(!(touching & (1 << lane))) {
+          continue;
+        }
+        const uint32_t index_a = static_cast<uint32_t>(pairs[batch[lane]] >> 32);
+        const uint32_t index_b = static_cast<uint32_t>(pairs[batch[lane]] & 0xFFFFFFFF);
+        const Body& a = bodies[index_a];
+        const Body& b = bodies[index_b];
+        WorldContact contact;
+        circlesFromDistance(a.transform.p, a.shape.radius, b.transform.p, b.shape.radius,
+                            {bx[lane] - ax[lane], by[lane] - ay[lane]}, distance[lane], contact);
+        buildManifold(a, b, index_a, index_b, contact, previous, manifolds[batch[lane]]);
+      }
+    }
+  }
+
+  void collidePairs(std::span<const Body> bodies, std::span<const uint64_t> pairs, ThreadPool& pool,
+                    std::span<const Manifold> previous, std::vector<Manifold>& manifolds) {
+    //one slot per pair keeps the output in pair order, empty slots are compacted after
+    manifolds.resize(pairs.size());
+    std::span<Manifold> slots(manifolds);
+
+    pool.parallelFor(pairs.size(), 512, [&](size_t begin, size_t end) {
+      size_t batch[4];
+      size_t batch_size = 0;
+      for(size_t p = begin; p < end; p++) {
+        slots[p].point_count = 0;
+        const uint32_t index_a = static_cast<uint32_t>(pairs[p] >> 32);
+        const uint32_t index_b = static_cast<uint32_t>(pairs[p] & 0xFFFFFFFF);
+        const Body& a = bodies[index_a];
+        const Body& b = bodies[index_b];
+
+        if(a.shape.type == ShapeType::Circle && b.shape.type == ShapeType::Circle) {
+          batch[batch_size++] = p;
+          if(batch_size == 4) {
+            collideCircleBatch(bodies, pairs, batch, previous, slots);
+            batch_size = 0;
+          }
+          continue;
+        }
+
+        WorldContact contact;
+        if(collide(a, b, contact)) {
+          buildManifold(a, b, index_a, index_b, contact, previous, slots[p]);
+        }
+      }
+
+      for(size_t i = 0; i < batch_size; i++) {
+        const uint32_t index_a = static_cast<uint32_t>(pairs[batch[i]] >> 32);
+        const uint32_t index_b = static_cast<uint32_t>(pairs[batch[i]] & 0xFFFFFFFF);
+        WorldContact contact;
+        if(collideCircles(bodies[index_a], bodies[index_b], contact)) {
+          buildManifold(bodies[index_a], bodies[index_b], index_a, index_b, contact, previous, slots[batch[i]]);
+        }
+      }
+    });
+
+    std::erase_if(manifolds, [](const Manifold& m) { return m.point_count == 0; });
+  }
+}
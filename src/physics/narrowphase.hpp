@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "physics/body.hpp"
+#include "physics/broadphase.hpp"
+#include "util/thread_pool.hpp"
+
+namespace rp::physics {
+  struct ContactPoint {
+    Vec2 anchor_a;  //contact point relative to each body's centre, world orientation
+    Vec2 anchor_b;
+    float separation = 0.0f;  //negative when penetrating
+    uint32_t feature = 0;     //identifies the features in contact so impulses carry across steps
+
+    //solver state
+    float normal_impulse = 0.0f;
+    float tangent_impulse = 0.0f;
+    float normal_mass = 0.0f;
+    float tangent_mass = 0.0f;
+    float velocity_bias = 0.0f;
+  };
+
+  //Contact between two bodies, with a < b
+  struct Manifold {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    Vec2 normal;  //points from a to b
+    uint8_t point_count = 0;
+    std::array<ContactPoint, 2> points;
+    float friction = 0.0f;
+    float restitution = 0.0f;
+
+    [[nodiscard]] uint64_t getKey() const noexcept { return makePairKey(a, b); }
+  };
+
+  //Bodies closer than this are given contacts ahead of touching, so the solver can stop them in one step
+  constexpr float speculative_distance = 0.02f;
+
+  //Builds manifolds for the sorted broadphase pairs that are touching, in pair order.
+  //Impulses are carried over from matching contacts in previous, which must be sorted by key.
+  void collidePairs(std::span<const Body> bodies, std::span<const uint64_t> pairs, ThreadPool& pool,
+                    std::span<const Manifold> previous, std::vector<Manifold>& manifolds);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace rp::physics {
+  //Updates every world created with autoStep, called once per frame with the frame's duration
+  void stepWorlds(float elapsed_seconds);
+}
@@ -0,0 +1,135 @@
+#include "pch.hpp"
+#include "physics/shape.hpp"
+
+namespace rp::physics {
+  namespace {
+    void computeNormals(Shape& shape) {
+      for(uint8_t i = 0; i < shape.count; i++) {
+        const Vec2 edge = shape.vertices[(i + 1) % shape.count] - shape.vertices[i];
+        shape.normals[i] = normalize(cross(edge, 1.0f));
+      }
+    }
+  }
+
+  Shape Shape::Circle(float radius) {
+    if(!(radius > 0.0f)) {
+      throw std::invalid_argument(fmt::format("Circle radius must be positive, got {}", radius));
+    }
+    Shape shape;
+    shape.type = ShapeType::Circle;
+    shape.radius = radius;
+    return shape;
+  }
+
+  Shape Shape::Box(float half_width, float half_height) {
+    if(!(half_width > 0.0f && half_height > 0.0f)) {
+      throw std::invalid_argument(fmt::format("Box extents must be positive, got {}x{}", half_width, half_height));
+    }
+    Shape shape;
+    shape.type = ShapeType::Polygon;
+    shape.radius = 0.0f;
+    shape.count = 4;
+    shape.vertices[0] = {-half_width, -half_height};
+    shape.vertices[1] = {half_width, -half_height};
+    shape.vertices[2] = {half_width, half_height};
+    shape.vertices[3] = {-half_width, half_height};
+    computeNormals(shape);
+    return shape;
+  }
+
+  Shape Shape::Convex(std::span<const Vec2> points) {
+    //gift wrapping, fine for the handful of points a collider has. Keeping the other points on the left
+    //walks the hull counter-clockwise, the winding polygons are stored in.
+    constexpr float collinear_tolerance = 1e-6f;
+    if(points.size() < 3) {
+      throw std::invalid_argument("Convex shapes need at least 3 points");
+    }
+
+    size_t start = 0;
+    for(size_t i = 1; i < points.size(); i++) {
+      if(points[i].x < points[start].x || (points[i].x == points[start].x && points[i].y < points[start].y)) {
+        start = i;
+      }
+    }
+
+    std::vector<Vec2> hull;
+    size_t current = start;
+    do {
+      if(hull.size() == max_polygon_vertices) {
+        throw std::invalid_argument(fmt::format("Convex hull has more than {} vertices", max_polygon_vertices));
+      }
+      hull.push_back(points[current]);
+
+      size_t next = (current + 1) % points.size();
+      for(size_t i = 0; i < points.size(); i++) {
+        const Vec2 to_next = points[next] - points[current];
+        const Vec2 to_i = points[i] - points[current];
+        const float turn = cross(to_next, to_i);
+        //take the point with every other point on its left, and the farthest one when collinear
+        if(turn < -collinear_tolerance || (std::abs(turn) <= collinear_tolerance && lengthSquared(to_i) > lengthSquared(to_next))) {
+          next = i;
+        }
+      }
+      current = next;
+    } while(current != start);
+
+    Shape shape;
+    shape.type = ShapeType::Polygon;
+    shape.radius = 0.0f;
+    shape.count = static_cast<uint8_t>(hull.size());
+
+    //area weighted centroid
+    float area = 0.0f;
+    Vec2 centroid;
+    for(size_t i = 0; i < hull.size(); i++) {
+      const Vec2 a = hull[i];
+      const Vec2 b = hull[(i + 1) % hull.size()];
+      const float triangle_area = 0.5f * cross(a - hull[0], b - hull[0]);
+      area += triangle_area;
+      centroid += triangle_area * (1.0f / 3.0f) * (a + b - hull[0] * 2.0f);
+    }
+    if(hull.size() < 3 || area <= collinear_tolerance) {
+      throw std::invalid_argument("Convex hull is degenerate");
+    }
+    centroid = hull[0] + centroid * (1.0f / area);
+
+    for(size_t i = 0; i < hull.size(); i++) {
+      shape.vertices[i] = hull[i] - centroid;
+    }
+    computeNormals(shape);
+    return shape;
+  }
+
+  MassData Shape::computeMass(float density) const {
+    if(type == ShapeType::Circle) {
+      const float mass = density * 3.14159265f * radius * radius;
+      return {mass, 0.5f * mass * radius * radius};
+    }
+
+    //sum of triangles fanned from the origin, which is the centroid
+    float area = 0.0f;
+    float inertia = 0.0f;
+    for(uint8_t i = 0; i < count; i++) {
+      const Vec2 a = vertices[i];
+      const Vec2 b = vertices[(i + 1) % count];
+      const float d = cross(a, b);
+      area += 0.5f * d;
+      inertia += d * (dot(a, a) + dot(a, b) + dot(b, b)) / 12.0f;
+    }
+    return {density * area, density * inertia};
+  }
+
+  AABB Shape::computeAABB(const Transform& transform) const {
+    if(type == ShapeType::Circle) {
+      return {{transform.p.x - radius, transform.p.y - radius}, {transform.p.x + radius, transform.p.y + radius}};
+    }
+
+    AABB box{transform.apply(vertices[0]), transform.apply(vertices[0])};
+    for(uint8_t i = 1; i < count; i++) {
+      const Vec2 v = transform.apply(vertices[i]);
+      box.min = min(box.min, v);
+      box.max = max(box.max, v);
+    }
+    return box;
+  }
+}
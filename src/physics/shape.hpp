@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "physics/math.hpp"
+
+namespace rp::physics {
+  constexpr size_t max_polygon_vertices = 8;
+
+  enum class ShapeType : uint8_t {
+    Circle,
+    Polygon,
+  };
+
+  struct MassData {
+    float mass;
+    float inertia;  //about the shape's origin
+  };
+
+  //Collision shape in body space. Shapes are centred on their centre of mass,
+  //so a body's position is also its centre of mass.
+  struct Shape {
+    ShapeType type = ShapeType::Circle;
+    float radius = 0.5f;
+    uint8_t count = 0;
+    std::array<Vec2, max_polygon_vertices> vertices{};
+    std::array<Vec2, max_polygon_vertices> normals{};
+
+    [[nodiscard]] static Shape Circle(float radius);
+    [[nodiscard]] static Shape Box(float half_width, float half_height);
+
+    //Convex hull of the given points, recentred on its centroid. Throws if the hull is degenerate.
+    [[nodiscard]] static Shape Convex(std::span<const Vec2> points);
+
+    [[nodiscard]] MassData computeMass(float density) const;
+    [[nodiscard]] AABB computeAABB(const Transform& transform) const;
+  };
+}
@@ -0,0 +1,285 @@
+#include "pch.hpp"
+
+#include <bit>
+
+#include "physics/solver.hpp"
+
+namespace rp::physics {
+  namespace {
+    constexpr float baumgarte = 0.2f;
+    constexpr float linear_slop = 0.005f;
+    constexpr float restitution_threshold = 1.0f;  //slower impacts don't bounce, keeps resting contacts still
+    constexpr uint32_t large_island_contacts = 1024;
+    constexpr uint32_t max_colors = 64;            //contacts past this are solved serially
+    constexpr uint32_t no_island = 0xFFFFFFFF;
+
+    //Impulse helpers skip static bodies, so contacts sharing one can be solved on different threads
+    template<typename SolverBody>
+    void applyImpulse(SolverBody& a, SolverBody& b, Vec2 anchor_a, Vec2 anchor_b, Vec2 impulse) {
+      if(a.inv_mass != 0.0f) {
+        a.v -= a.inv_mass * impulse;
+        a.w -= a.inv_inertia * cross(anchor_a, impulse);
+      }
+      if(b.inv_mass != 0.0f) {
+        b.v += b.inv_mass * impulse;
+        b.w += b.inv_inertia * cross(anchor_b, impulse);
+      }
+    }
+
+    template<typename SolverBody>
+    Vec2 relativeVelocity(const SolverBody& a, const SolverBody& b, Vec2 anchor_a, Vec2 anchor_b) {
+      return b.v + cross(b.w, anchor_b) - a.v - cross(a.w, anchor_a);
+    }
+
+    template<typename SolverBody>
+    void warmStart(Manifold& m, std::span<SolverBody> bodies) {
+      SolverBody& a = bodies[m.a];
+      SolverBody& b = bodies[m.b];
+      const Vec2 tangent = cross(m.normal, 1.0f);
+      for(uint8_t i = 0; i < m.point_count; i++) {
+        const ContactPoint& point = m.points[i];
+        applyImpulse(a, b, point.anchor_a, point.anchor_b, m.normal * point.normal_impulse + tangent * point.tangent_impulse);
+      }
+    }
+
+    template<typename SolverBody>
+    void solveContact(Manifold& m, std::span<SolverBody> bodies) {
+      SolverBody& a = bodies[m.a];
+      SolverBody& b = bodies[m.b];
+      const Vec2 tangent = cross(m.normal, 1.0f);
+
+      //friction first, bounded by the current normal impulse
+      for(uint8_t i = 0; i < m.point_count; i++) {
+        ContactPoint& point = m.points[i];
+        const float vt = dot(relativeVelocity(a, b, point.anchor_a, point.anchor_b), tangent);
+        const float max_friction = m.friction * point.normal_impulse;
+        const float impulse = std::clamp(point.tangent_impulse - point.tangent_mass * vt, -max_friction, max_friction);
+        const float lambda = impulse - point.tangent_impulse;
+        point.tangent_impulse = impulse;
+        applyImpulse(a, b, point.anchor_a, point.anchor_b, tangent * lambda);
+      }
+
+      for(uint8_t i = 0; i < m.point_count; i++) {
+        ContactPoint& point = m.points[i];
+        const float vn = dot(relativeVelocity(a, b, point.anchor_a, point.anchor_b), m.normal);
+        const float impulse = std::max(point.normal_impulse - point.normal_mass * (vn - point.velocity_bias), 0.0f);
+        const float lambda = impulse - point.normal_impulse;
+        point.normal_impulse = impulse;
+        applyImpulse(a, b, point.anchor_a, point.anchor_b, m.normal * lambda);
+      }
+    }
+  }
+
+  void Solver::step(std::span<Body> bodies, std::span<Manifold> manifolds, ThreadPool& pool, const SolverSettings& settings) {
+    const float dt = settings.dt;
+    const float inv_dt = (dt > 0.0f) ? 1.0f / dt : 0.0f;
+
+    mBodies.resize(bodies.size());
+    pool.parallelFor(bodies.size(), 1024, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        const Body& body = bodies[i];
+        SolverBody& solver_body = mBodies[i];
+        if(!body.alive || !body.isDynamic()) {
+          solver_body = {};
+          continue;
+        }
+        solver_body.inv_mass = body.inv_mass;
+        solver_body.inv_inertia = body.inv_inertia;
+        solver_body.v = (body.velocity + dt * (settings.gravity + body.inv_mass * body.force)) * (1.0f / (1.0f + dt * body.linear_damping));
+        solver_body.w = (body.angular_velocity + dt * body.inv_inertia * body.torque) * (1.0f / (1.0f + dt * body.angular_damping));
+      }
+    });
+
+    buildIslands(bodies, manifolds);
+
+    std::span<SolverBody> solver_bodies(mBodies);
+    pool.parallelFor(manifolds.size(), 512, [&](size_t begin, size_t end) {
+      for(size_t c = begin; c < end; c++) {
+        Manifold& m = manifolds[c];
+        const SolverBody& a = solver_bodies[m.a];
+        const SolverBody& b = solver_bodies[m.b];
+        const Vec2 tangent = cross(m.normal, 1.0f);
+        for(uint8_t i = 0; i < m.point_count; i++) {
+          ContactPoint& point = m.points[i];
+          const float rn_a = cross(point.anchor_a, m.normal), rn_b = cross(point.anchor_b, m.normal);
+          const float rt_a = cross(point.anchor_a, tangent), rt_b = cross(point.anchor_b, tangent);
+          const float k_normal = a.inv_mass + b.inv_mass + a.inv_inertia * rn_a * rn_a + b.inv_inertia * rn_b * rn_b;
+          const float k_tangent = a.inv_mass + b.inv_mass + a.inv_inertia * rt_a * rt_a + b.inv_inertia * rt_b * rt_b;
+          point.normal_mass = (k_normal > 0.0f) ? 1.0f / k_normal : 0.0f;
+          point.tangent_mass = (k_tangent > 0.0f) ? 1.0f / k_tangent : 0.0f;
+
+          //speculative contacts may close their gap this step, touching ones push out by a fraction of the overlap
+          const float vn = dot(relativeVelocity(a, b, point.anchor_a, point.anchor_b), m.normal);
+          const float bounce = (vn < -restitution_threshold) ? -m.restitution * vn : 0.0f;
+          if(point.separation > 0.0f) {
+            point.velocity_bias = std::max(-point.separation * inv_dt, bounce);
+          } else {
+            point.velocity_bias = std::max(baumgarte * inv_dt * std::max(-point.separation - linear_slop, 0.0f), bounce);
+          }
+        }
+      }
+    });
+
+    //small islands are independent, so each is solved start to finish by one thread
+    pool.parallelFor(mSmallIslands.size(), 8, [&](size_t begin, size_t end) {
+      for(size_t s = begin; s < end; s++) {
+        const uint32_t island = mSmallIslands[s];
+        std::span<const uint32_t> contacts(mIslandContacts.data() + mIslandStarts[island], mIslandStarts[island + 1] - mIslandStarts[island]);
+        for(uint32_t c : contacts) {
+          warmStart(manifolds[c], solver_bodies);
+        }
+        for(uint32_t iteration = 0; iteration < settings.velocity_iterations; iteration++) {
+          for(uint32_t c : contacts) {
+            solveContact(manifolds[c], solver_bodies);
+          }
+        }
+      }
+    });
+
+    mColorCount = 0;
+    for(uint32_t island : mLargeIslands) {
+      std::span<const uint32_t> contacts(mIslandContacts.data() + mIslandStarts[island], mIslandStarts[island + 1] - mIslandStarts[island]);
+      solveColored(manifolds, contacts, pool, settings.velocity_iterations);
+    }
+
+    pool.parallelFor(bodies.size(), 1024, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        Body& body = bodies[i];
+        if(!body.alive || !body.isDynamic()) {
+          continue;
+        }
+        body.velocity = solver_bodies[i].v;
+        body.angular_velocity = solver_bodies[i].w;
+        body.transform.p += dt * body.velocity;
+        body.angle += dt * body.angular_velocity;
+        body.transform.q = Rot::FromAngle(body.angle);
+        body.aabb = body.shape.computeAABB(body.transform);
+        body.force = {};
+        body.torque = 0.0f;
+      }
+    });
+  }
+
+  void Solver::buildIslands(std::span<const Body> bodies, std::span<const Manifold> manifolds) {
+    mParent.resize(bodies.size());
+    for(uint32_t i = 0; i < mParent.size(); i++) {
+      mParent[i] = i;
+    }
+    auto find = [&](uint32_t i) {
+      while(mParent[i] != i) {
+        mParent[i] = mParent[mParent[i]];
+        i = mParent[i];
+      }
+      return i;
+    };
+
+    //static bodies don't join islands, a floor would otherwise link everything resting on it
+    for(const auto& m : manifolds) {
+      if(bodies[m.a].isDynamic() && bodies[m.b].isDynamic()) {
+        const uint32_t root_a = find(m.a), root_b = find(m.b);
+        if(root_a != root_b) {
+          mParent[std::max(root_a, root_b)] = std::min(root_a, root_b);
+        }
+      }
+    }
+
+    //number islands in order of first contact and bucket contacts by island, keeping key order
+    mIslandIndex.assign(bodies.size(), no_island);
+    mIslandStarts.assign(1, 0);
+    std::vector<uint32_t> contact_islands(manifolds.size());
+    for(size_t c = 0; c < manifolds.size(); c++) {
+      const Manifold& m = manifolds[c];
+      const uint32_t root = find(bodies[m.a].isDynamic() ? m.a : m.b);
+      if(mIslandIndex[root] == no_island) {
+        mIslandIndex[root] = static_cast<uint32_t>(mIslandStarts.size() - 1);
+        mIslandStarts.push_back(0);
+      }
+      contact_islands[c] = mIslandIndex[root];
+      mIslandStarts[mIslandIndex[root] + 1]++;
+    }
+    for(size_t island = 1; island < mIslandStarts.size(); island++) {
+      mIslandStarts[island] += mIslandStarts[island - 1];
+    }
+
+    mIslandContacts.resize(manifolds.size());
+    std::vector<uint32_t> cursor(mIslandStarts.begin(), mIslandStarts.end() - 1);
+    for(size_t c = 0; c < manifolds.size(); c++) {
+      mIslandContacts[cursor[contact_islands[c]]++] = static_cast<uint32_t>(c);
+    }
+
+    mSmallIslands.clear();
+    mLargeIslands.clear();
+    for(uint32_t island = 0; island + 1 < mIslandStarts.size(); island++) {
+      if(mIslandStarts[island + 1] - mIslandStarts[island] > large_island_contacts) {
+        mLargeIslands.push_back(island);
+      } else {
+        mSmallIslands.push_back(island);
+      }
+    }
+  }
+
+  void Solver::solveColored(std::span<Manifold> manifolds, std::span<const uint32_t> contacts, ThreadPool& pool, uint32_t iterations) {
+    std::span<SolverBody> solver_bodies(mBodies);
+
+    //greedy colouring, no two contacts of a colour share a dynamic body
+    mBodyColors.resize(mBodies.size());
+    mContactColors.resize(contacts.size());
+    mColorStarts.assign(max_colors + 2, 0);
+    for(size_t i = 0; i < contacts.size(); i++) {
+      const Manifold& m = manifolds[contacts[i]];
+      const bool dynamic_a = mBodies[m.a].inv_mass != 0.0f, dynamic_b = mBodies[m.b].inv_mass != 0.0f;
+      const uint64_t used = (dynamic_a ? mBodyColors[m.a] : 0) | (dynamic_b ? mBodyColors[m.b] : 0);
+      const uint32_t color = (used == ~uint64_t{0}) ? max_colors : static_cast<uint32_t>(std::countr_one(used));
+      if(color < max_colors) {
+        const uint64_t bit = uint64_t{1} << color;
+        mBodyColors[m.a] |= dynamic_a ? bit : 0;
+        mBodyColors[m.b] |= dynamic_b ? bit : 0;
+      }
+      mContactColors[i] = static_cast<uint8_t>(color);
+      mColorStarts[color + 1]++;
+    }
+    for(const uint32_t c : contacts) {
+      mBodyColors[manifolds[c].a] = 0;
+      mBodyColors[manifolds[c].b] = 0;
+    }
+
+    for(uint32_t color = 1; color < mColorStarts.size(); color++) {
+      mColorStarts[color] += mColorStarts[color - 1];
+    }
+    mColorContacts.resize(contacts.size());
+    std::vector<uint32_t> cursor(mColorStarts.begin(), mColorStarts.end() - 1);
+    for(size_t i = 0; i < contacts.size(); i++) {
+      mColorContacts[cursor[mContactColors[i]]++] = contacts[i];
+    }
+
+    uint32_t color_count = 0;
+    for(uint32_t color = 0; color <= max_colors; color++) {
+      if(mColorStarts[color + 1] > mColorStarts[color]) {
+        color_count = color + 1;
+      }
+    }
+    mColorCount = std::max<size_t>(mColorCount, color_count);
+
+    auto forEachColor = [&](auto&& solve) {
+      for(uint32_t color = 0; color < color_count; color++) {
+        const uint32_t first = mColorStarts[color], last = mColorStarts[color + 1];
+        if(color == max_colors) {
+          for(uint32_t i = first; i < last; i++) {
+            solve(manifolds[mColorContacts[i]]);
+          }
+          continue;
+        }
+        pool.parallelFor(last - first, 128, [&](size_t begin, size_t end) {
+          for(size_t i = first + begin; i < first + end; i++) {
+            solve(manifolds[mColorContacts[i]]);
+          }
+        });
+      }
+    };
+
+    forEachColor([&](Manifold& m) { warmStart(m, solver_bodies); });
+    for(uint32_t iteration = 0; iteration < iterations; iteration++) {
+      forEachColor([&](Manifold& m) { solveContact(m, solver_bodies); });
+    }
+  }
+}
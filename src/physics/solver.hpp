@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "physics/body.hpp"
+#include "physics/narrowphase.hpp"
+#include "util/thread_pool.hpp"
+
+namespace rp::physics {
+  struct SolverSettings {
+    float dt = 1.0f / 60.0f;
+    Vec2 gravity;
+    uint32_t velocity_iterations = 8;
+  };
+
+  //Sequential impulse contact solver.
+  //Contacts are split into islands of touching dynamic bodies, which are solved in parallel. Islands too big
+  //to balance across threads are graph coloured instead, and each colour's contacts are solved in parallel.
+  class Solver {
+  public:
+    //Integrates velocities, solves the contacts and integrates positions, updating each body's AABB
+    void step(std::span<Body> bodies, std::span<Manifold> manifolds, ThreadPool& pool, const SolverSettings& settings);
+
+    [[nodiscard]] size_t getIslandCount() const noexcept { return mIslandStarts.empty() ? 0 : mIslandStarts.size() - 1; }
+    [[nodiscard]] size_t getColorCount() const noexcept { return mColorCount; }
+
+  private:
+    struct SolverBody {
+      Vec2 v;
+      float w = 0.0f;
+      float inv_mass = 0.0f;
+      float inv_inertia = 0.0f;
+    };
+
+    void buildIslands(std::span<const Body> bodies, std::span<const Manifold> manifolds);
+    void solveColored(std::span<Manifold> manifolds, std::span<const uint32_t> contacts, ThreadPool& pool, uint32_t iterations);
+
+    std::vector<SolverBody> mBodies;
+    std::vector<uint32_t> mParent;           //union-find over body indices
+    std::vector<uint32_t> mIslandIndex;      //island of each union-find root
+    std::vector<uint32_t> mIslandStarts;     //offsets into mIslandContacts
+    std::vector<uint32_t> mIslandContacts;   //manifold indices grouped by island, in key order
+    std::vector<uint32_t> mSmallIslands;
+    std::vector<uint32_t> mLargeIslands;
+    std::vector<uint64_t> mBodyColors;       //colours already used by each body's contacts
+    std::vector<uint32_t> mColorStarts;
+    std::vector<uint32_t> mColorContacts;
+    std::vector<uint8_t> mContactColors;
+    size_t mColorCount = 0;
+  };
+}
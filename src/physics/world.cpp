@@ -0,0 +1,175 @@
+#include "pch.hpp"
+
+#include <chrono>
+
+#include "physics/world.hpp"
+#include "physics/physics_internal.hpp"
+
+namespace rp::physics {
+  namespace {
+    //worlds with autoStep, only touched from the main thread
+    std::vector<World*> auto_step_worlds;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+
+  World::World(const WorldDef& def)
+    : mDef(def),
+      mPool(def.workerThreads),
+      mBroadphase(createBroadphase(def.broadphase, def.gridCellSize)) {
+    if(!(mDef.fixedTimestep > 0.0f)) {
+      throw std::invalid_argument(fmt::format("World fixed timestep must be positive, got {}", mDef.fixedTimestep));
+    }
+    if(mDef.autoStep) {
+      auto_step_worlds.push_back(this);
+    }
+  }
+
+  World::~World() {
+    std::erase(auto_step_worlds, this);
+  }
+
+  BodyId World::createBody(const BodyDef& def) {
+    if(def.type == BodyType::Dynamic && !(def.density > 0.0f)) {
+      throw std::invalid_argument(fmt::format("Dynamic bodies need a positive density, got {}", def.density));
+    }
+
+    uint32_t index;
+    if(!mFreeBodies.empty()) {
+      index = mFreeBodies.back();
+      mFreeBodies.pop_back();
+    } else {
+      index = static_cast<uint32_t>(mBodies.size());
+      mBodies.emplace_back();
+    }
+
+    Body& body = mBodies[index];
+    const uint32_t generation = body.generation;
+    body = {};
+    body.generation = generation;
+    body.alive = true;
+    body.type = def.type;
+    body.shape = def.shape;
+    body.angle = def.angle;
+    body.transform = {def.position, Rot::FromAngle(def.angle)};
+    body.friction = def.friction;
+    body.restitution = def.restitution;
+    body.user_data = def.userData;
+    if(def.type == BodyType::Dynamic) {
+      const MassData mass = def.shape.computeMass(def.density);
+      body.inv_mass = 1.0f / mass.mass;
+      body.inv_inertia = (mass.inertia > 0.0f) ? 1.0f / mass.inertia : 0.0f;
+      body.velocity = def.velocity;
+      body.angular_velocity = def.angularVelocity;
+      body.linear_damping = def.linearDamping;
+      body.angular_damping = def.angularDamping;
+    }
+    body.aabb = body.shape.computeAABB(body.transform);
+    mBroadphase->addBody(index, body);
+
+    mStats.body_count++;
+    return {index, generation};
+  }
+
+  void World::destroyBody(BodyId id) {
+    Body& body = getMutableBody(id);
+    mBroadphase->removeBody(id.index, body);
+    body.alive = false;
+    body.generation++;
+    mFreeBodies.push_back(id.index);
+    mStats.body_count--;
+
+    //the index may be reused, so drop its contacts rather than warm starting a new body from them
+    auto involves = [&](const Manifold& m) { return m.a == id.index || m.b == id.index; };
+    std::erase_if(mManifolds, involves);
+    std::erase_if(mPreviousManifolds, involves);
+  }
+
+  bool World::isValid(BodyId id) const noexcept {
+    return id.index < mBodies.size() && mBodies[id.index].alive && mBodies[id.index].generation == id.generation;
+  }
+
+  const Body& World::getBody(BodyId id) const {
+    if(!isValid(id)) {
+      throw std::invalid_argument(fmt::format("Invalid body id {} (generation {})", id.index, id.generation));
+    }
+    return mBodies[id.index];
+  }
+
+  Body& World::getMutableBody(BodyId id) {
+    return const_cast<Body&>(std::as_const(*this).getBody(id));
+  }
+
+  void World::setTransform(BodyId id, Vec2 position, float angle) {
+    Body& body = getMutableBody(id);
+    body.angle = angle;
+    body.transform = {position, Rot::FromAngle(angle)};
+    body.aabb = body.shape.computeAABB(body.transform);
+  }
+
+  void World::setVelocity(BodyId id, Vec2 velocity, float angular_velocity) {
+    Body& body = getMutableBody(id);
+    if(body.isDynamic()) {
+      body.velocity = velocity;
+      body.angular_velocity = angular_velocity;
+    }
+  }
+
+  void World::applyForce(BodyId id, Vec2 force, Vec2 point) {
+    Body& body = getMutableBody(id);
+    if(body.isDynamic()) {
+      body.force += force;
+      body.torque += cross(point - body.transform.p, force);
+    }
+  }
+
+  void World::applyLinearImpulse(BodyId id, Vec2 impulse, Vec2 point) {
+    Body& body = getMutableBody(id);
+    if(body.isDynamic()) {
+      body.velocity += body.inv_mass * impulse;
+      body.angular_velocity += body.inv_inertia * cross(point - body.transform.p, impulse);
+    }
+  }
+
+  void World::step(float dt) {
+    auto start = std::chrono::steady_clock::now();
+    mBroadphase->findPairs(mBodies, mPool, mPairs);
+    mStats.broadphase_ms = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    mPreviousManifolds.swap(mManifolds);
+    collidePairs(mBodies, mPairs, mPool, mPreviousManifolds, mManifolds);
+    mStats.narrowphase_ms = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    mSolver.step(mBodies, mManifolds, mPool, {dt, mDef.gravity, mDef.velocityIterations});
+    mStats.solver_ms = millisecondsSince(start);
+
+    mStats.pair_count = mPairs.size();
+    mStats.contact_count = mManifolds.size();
+    mStats.island_count = mSolver.getIslandCount();
+    mStats.color_count = mSolver.getColorCount();
+  }
+
+  void World::update(float elapsed_seconds) {
+    mAccumulator += elapsed_seconds;
+    uint32_t steps = 0;
+    while(mAccumulator >= mDef.fixedTimestep && steps < mDef.maxSubsteps) {
+      step(mDef.fixedTimestep);
+      mAccumulator -= mDef.fixedTimestep;
+      steps++;
+    }
+    if(steps == mDef.maxSubsteps && mAccumulator >= mDef.fixedTimestep) {
+      log::rp_trace("Physics fell behind, dropping {:.1f}ms", mAccumulator * 1000.0f);
+      mAccumulator = std::fmod(mAccumulator, mDef.fixedTimestep);
+    }
+  }
+
+  void stepWorlds(float elapsed_seconds) {
+    for(World* world : auto_step_worlds) {
+      world->update(elapsed_seconds);
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "physics/body.hpp"
+#include "physics/broadphase.hpp"
+#include "physics/narrowphase.hpp"
+#include "physics/solver.hpp"
+#include "util/thread_pool.hpp"
+
+//2D rigid body physics
+//
+//Each step runs the broadphase, builds contact manifolds for the overlapping pairs and
+//solves them with a sequential impulse solver, spreading each stage over the world's
+//thread pool. Results don't depend on the thread count.
+//Worlds with autoStep set are advanced at a fixed timestep from rp::run's loop, before App::update.
+namespace rp::physics {
+  struct WorldDef {
+    Vec2 gravity{0.0f, -10.0f};
+    BroadphaseType broadphase = BroadphaseType::DynamicTree;
+    float gridCellSize = 0.0f;  //0 sizes grid cells from the bodies
+    float fixedTimestep = 1.0f / 60.0f;
+    uint32_t maxSubsteps = 4;   //steps per update before dropping time, avoids spiralling when behind
+    uint32_t velocityIterations = 8;
+    size_t workerThreads = ThreadPool::GetDefaultWorkerCount();
+    bool autoStep = true;
+  };
+
+  struct WorldStats {
+    size_t body_count = 0;
+    size_t pair_count = 0;
+    size_t contact_count = 0;
+    size_t island_count = 0;
+    size_t color_count = 0;
+    double broadphase_ms = 0.0;
+    double narrowphase_ms = 0.0;
+    double solver_ms = 0.0;
+  };
+
+  class World {
+  public:
+    explicit World(const WorldDef& def = {});
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    BodyId createBody(const BodyDef& def);
+    void destroyBody(BodyId id);
+    [[nodiscard]] bool isValid(BodyId id) const noexcept;
+
+    //Throws std::invalid_argument for stale ids
+    [[nodiscard]] const Body& getBody(BodyId id) const;
+    void setTransform(BodyId id, Vec2 position, float angle);
+    void setVelocity(BodyId id, Vec2 velocity, float angular_velocity);
+
+    //Forces are cleared after every step, points are in world space
+    void applyForce(BodyId id, Vec2 force, Vec2 point);
+    void applyLinearImpulse(BodyId id, Vec2 impulse, Vec2 point);
+
+    //Advances the world by exactly dt
+    void step(float dt);
+
+    //Runs as many fixed steps as the elapsed time allows, carrying the remainder to the next call
+    void update(float elapsed_seconds);
+
+    //How far between the last two fixed steps the accumulated time is, for interpolating rendering
+    [[nodiscard]] float getInterpolationAlpha() const noexcept { return mAccumulator / mDef.fixedTimestep; }
+
+    void setGravity(Vec2 gravity) noexcept { mDef.gravity = gravity; }
+    [[nodiscard]] Vec2 getGravity() const noexcept { return mDef.gravity; }
+
+    //Indexed by BodyId::index, check Body::alive before use
+    [[nodiscard]] std::span<const Body> getBodies() const noexcept { return mBodies; }
+    [[nodiscard]] std::span<const Manifold> getContacts() const noexcept { return mManifolds; }
+    [[nodiscard]] const WorldStats& getStats() const noexcept { return mStats; }
+
+  private:
+    Body& getMutableBody(BodyId id);
+
+    WorldDef mDef;
+    ThreadPool mPool;
+    std::unique_ptr<Broadphase> mBroadphase;
+    Solver mSolver;
+
+    std::vector<Body> mBodies;
+    std::vector<uint32_t> mFreeBodies;
+    std::vector<uint64_t> mPairs;
+    std::vector<Manifold> mManifolds;
+    std::vector<Manifold> mPreviousManifolds;
+    float mAccumulator = 0.0f;
+    WorldStats mStats;
+  };
+}
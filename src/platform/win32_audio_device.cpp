@@ -0,0 +1,62 @@
+#include "pch.hpp"
+#include "platform/win32_audio_device.hpp"
+
+namespace rp::audio {
+
+  Win32AudioDevice::Win32AudioDevice(uint32_t sample_rate, uint32_t block_frames) {
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = 2;
+    format.nSamplesPerSec = sample_rate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+    mDoneEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if(mDoneEvent == NULL) {
+      throw std::runtime_error(fmt::format("Failed to create audio event! GetLastError = 0x{:x}", GetLastError()));
+    }
+
+    MMRESULT result = waveOutOpen(&mWaveOut, WAVE_MAPPER, &format, reinterpret_cast<DWORD_PTR>(mDoneEvent), 0, CALLBACK_EVENT);
+    if(result != MMSYSERR_NOERROR) {
+      CloseHandle(mDoneEvent);
+      throw std::runtime_error(fmt::format("Failed to open waveOut device! MMRESULT = {}", result));
+    }
+
+    for(size_t i = 0; i < buffer_count; i++) {
+      mBuffers[i].resize(size_t{block_frames} * 2);
+      mHeaders[i].lpData = reinterpret_cast<LPSTR>(mBuffers[i].data());
+      mHeaders[i].dwBufferLength = static_cast<DWORD>(mBuffers[i].size() * sizeof(int16_t));
+      waveOutPrepareHeader(mWaveOut, &mHeaders[i], sizeof(WAVEHDR));
+      //start out done so the first writes don't wait
+      mHeaders[i].dwFlags |= WHDR_DONE;
+    }
+
+    log::rp_info("Opened waveOut device ({} Hz, {} frame blocks)", sample_rate, block_frames);
+  }
+
+  Win32AudioDevice::~Win32AudioDevice() {
+    waveOutReset(mWaveOut);
+    for(auto& header : mHeaders) {
+      waveOutUnprepareHeader(mWaveOut, &header, sizeof(WAVEHDR));
+    }
+    waveOutClose(mWaveOut);
+    CloseHandle(mDoneEvent);
+  }
+
+  void Win32AudioDevice::write(std::span<const int16_t> samples) {
+    WAVEHDR& header = mHeaders[mNext];
+    while(!(header.dwFlags & WHDR_DONE)) {
+      WaitForSingleObject(mDoneEvent, INFINITE);
+    }
+
+    auto& buffer = mBuffers[mNext];
+    const size_t count = std::min(samples.size(), buffer.size());
+    std::copy_n(samples.begin(), count, buffer.begin());
+    header.dwBufferLength = static_cast<DWORD>(count * sizeof(int16_t));
+    header.dwFlags &= ~WHDR_DONE;
+    waveOutWrite(mWaveOut, &header, sizeof(WAVEHDR));
+
+    mNext = (mNext + 1) % buffer_count;
+  }
+}
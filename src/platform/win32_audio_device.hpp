@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "audio/audio_device.hpp"
+
+//include windows type definitions
+#include <winDef.h>
+#include <mmsystem.h>
+
+namespace rp::audio {
+  //waveOut output, cycles through a few queued buffers and waits for the oldest to finish playing
+  class Win32AudioDevice : public AudioDevice {
+    public:
+      Win32AudioDevice(uint32_t sample_rate, uint32_t block_frames);
+      ~Win32AudioDevice();
+
+      void write(std::span<const int16_t> samples) override;
+      const char* getName() const override { return "waveOut"; }
+
+    protected:
+      static constexpr size_t buffer_count = 4;
+
+      HWAVEOUT mWaveOut = NULL;
+      HANDLE mDoneEvent = NULL;
+      std::array<WAVEHDR, buffer_count> mHeaders = {};
+      std::array<std::vector<int16_t>, buffer_count> mBuffers;
+      size_t mNext = 0;
+  };
+}
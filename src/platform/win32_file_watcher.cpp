@@ -0,0 +1,99 @@
+#include "pch.hpp"
+#include "platform/win32_file_watcher.hpp"
+
+namespace rp {
+
+  Win32FileWatcher::Win32FileWatcher(const std::filesystem::path& directory, Clock::duration debounce)
+    : FileWatcher(directory, debounce) {
+    mDirectoryHandle = CreateFileW(
+      directory.c_str(),
+      FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL,
+      OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+      NULL);
+
+    if(mDirectoryHandle == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error(fmt::format("Failed to watch {}! GetLastError = 0x{:x}", directory.string(), GetLastError()));
+    }
+
+    mStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if(mStopEvent == NULL) {
+      CloseHandle(mDirectoryHandle);
+      throw std::runtime_error(fmt::format("Failed to create watcher stop event! GetLastError = 0x{:x}", GetLastError()));
+    }
+
+    mThread = std::thread(&Win32FileWatcher::watchThreadMain, this);
+  }
+
+  Win32FileWatcher::~Win32FileWatcher() {
+    SetEvent(mStopEvent);
+    mThread.join();
+    CloseHandle(mStopEvent);
+    CloseHandle(mDirectoryHandle);
+  }
+
+  void Win32FileWatcher::watchThreadMain() {
+    //ReadDirectoryChangesW needs a DWORD aligned buffer
+    alignas(DWORD) std::array<BYTE, 64 * 1024> buffer;
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    const HANDLE wait_handles[] = { overlapped.hEvent, mStopEvent };
+
+    while(true) {
+      ResetEvent(overlapped.hEvent);
+      BOOL issued = ReadDirectoryChangesW(
+        mDirectoryHandle,
+        buffer.data(),
+        static_cast<DWORD>(buffer.size()),
+        TRUE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+        NULL,
+        &overlapped,
+        NULL);
+
+      if(!issued) {
+        log::rp_error("ReadDirectoryChangesW failed for {}! GetLastError = 0x{:x}", mDirectory.string(), GetLastError());
+        break;
+      }
+
+      if(WaitForMultipleObjects(2, wait_handles, FALSE, INFINITE) != WAIT_OBJECT_0) {
+        //wait for the cancelled read to finish, it still writes into buffer and overlapped
+        DWORD cancelled_bytes = 0;
+        CancelIo(mDirectoryHandle);
+        GetOverlappedResult(mDirectoryHandle, &overlapped, &cancelled_bytes, TRUE);
+        break;
+      }
+
+      DWORD bytes = 0;
+      if(!GetOverlappedResult(mDirectoryHandle, &overlapped, &bytes, FALSE)) {
+        log::rp_error("Watching {} failed! GetLastError = 0x{:x}", mDirectory.string(), GetLastError());
+        break;
+      }
+
+      //zero bytes means the notification buffer overflowed and the changes were lost
+      if(bytes == 0) {
+        log::rp_warn("Too many changes in {}, some reloads were missed", mDirectory.string());
+        continue;
+      }
+
+      size_t offset = 0;
+      while(true) {
+        const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer.data() + offset);
+        if(info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+          std::wstring_view name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+          notifyChanged(mDirectory / name);
+        }
+
+        if(info->NextEntryOffset == 0) {
+          break;
+        }
+        offset += info->NextEntryOffset;
+      }
+    }
+
+    CloseHandle(overlapped.hEvent);
+  }
+}
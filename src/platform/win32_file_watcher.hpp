@@ -0,0 +1,23 @@
+#pragma once
+
+#include <thread>
+
+#include "util/file_watcher.hpp"
+
+//include windows type definitions
+#include <winDef.h>
+
+namespace rp {
+  class Win32FileWatcher : public rp::FileWatcher {
+    public:
+      Win32FileWatcher(const std::filesystem::path& directory, Clock::duration debounce);
+      ~Win32FileWatcher();
+
+    protected:
+      HANDLE mDirectoryHandle = NULL;
+      HANDLE mStopEvent = NULL;
+      std::thread mThread;
+
+      void watchThreadMain();
+  };
+}
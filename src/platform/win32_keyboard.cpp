@@ -2,83 +2,90 @@
 #include "platform/win32_keyboard.hpp"
 
 namespace rp::input {
+  namespace {
+    struct Win32KeyMapping {
+      uint8_t virtual_key;
+      Keyboard::Key key;
+    };
+
+    //Virtual keys that don't fall in the contiguous ranges below.
+    //VK_SHIFT, VK_CONTROL and VK_MENU map to the left key here and are resolved using the message flags.
+    constexpr Win32KeyMapping win32_key_mappings[] = {
+      {VK_SPACE, Keyboard::Key::Space},
+      {VK_OEM_COMMA, Keyboard::Key::Comma},
+      {VK_OEM_PERIOD, Keyboard::Key::Period},
+      {VK_OEM_1, Keyboard::Key::Semicolon},
+      {VK_OEM_2, Keyboard::Key::Slash},
+      {VK_OEM_3, Keyboard::Key::Tilde},
+      {VK_OEM_4, Keyboard::Key::LeftBracket},
+      {VK_OEM_6, Keyboard::Key::RightBracket},
+      {VK_OEM_5, Keyboard::Key::Backslash},
+      {VK_OEM_7, Keyboard::Key::Quote},
+
+      {VK_SHIFT, Keyboard::Key::LeftShift},
+      {VK_CONTROL, Keyboard::Key::LeftCtrl},
+      {VK_MENU, Keyboard::Key::LeftAlt},
+      {VK_LWIN, Keyboard::Key::LeftSystem},
+      {VK_RWIN, Keyboard::Key::RightSystem},
+      {VK_TAB, Keyboard::Key::Tab},
+      {VK_BACK, Keyboard::Key::Backspace},
+      {VK_RETURN, Keyboard::Key::Enter},
+      {VK_CAPITAL, Keyboard::Key::CapsLock},
+      {VK_ESCAPE, Keyboard::Key::Escape},
+
+      {VK_OEM_MINUS, Keyboard::Key::Dash},
+      {VK_OEM_PLUS, Keyboard::Key::Equals},
+
+      {VK_ADD, Keyboard::Key::Add},
+      {VK_SUBTRACT, Keyboard::Key::Subtract},
+      {VK_MULTIPLY, Keyboard::Key::Multiply},
+      {VK_DIVIDE, Keyboard::Key::Divide},
+      {VK_NUMLOCK, Keyboard::Key::NumLock},
+
+      {VK_SNAPSHOT, Keyboard::Key::PrintScreen},
+      {VK_SCROLL, Keyboard::Key::ScrollLock},
+      {VK_PAUSE, Keyboard::Key::Pause},
+
+      {VK_INSERT, Keyboard::Key::Insert},
+      {VK_DELETE, Keyboard::Key::Delete},
+      {VK_HOME, Keyboard::Key::Home},
+      {VK_END, Keyboard::Key::End},
+      {VK_PRIOR, Keyboard::Key::PageUp},
+      {VK_NEXT, Keyboard::Key::PageDown},
+
+      {VK_UP, Keyboard::Key::Up},
+      {VK_DOWN, Keyboard::Key::Down},
+      {VK_LEFT, Keyboard::Key::Left},
+      {VK_RIGHT, Keyboard::Key::Right},
+    };
+
+    //Dense table indexed directly by virtual key code, unmapped codes are Key::Invalid
+    constexpr auto win32_key_table = []() {
+      std::array<Keyboard::Key, 256> table{};
+
+      auto mapRange = [&](uint8_t first_code, Keyboard::Key first_key, size_t count) {
+        for(size_t i = 0; i < count; i++) {
+          table[first_code + i] = static_cast<Keyboard::Key>(INDEX_CAST(first_key) + i);
+        }
+      };
+      mapRange('A', Keyboard::Key::A, 26);
+      mapRange('0', Keyboard::Key::Num0, 10);
+      mapRange(VK_NUMPAD0, Keyboard::Key::Numpad0, 10);
+      mapRange(VK_F1, Keyboard::Key::F1, 12);
+
+      for(const auto& mapping : win32_key_mappings) {
+        table[mapping.virtual_key] = mapping.key;
+      }
+      return table;
+    }();
+  }
+
   Keyboard::Key translateWin32KeyCode(WPARAM win32_key_code, LPARAM flags) {
+    const Keyboard::Key key = (win32_key_code < win32_key_table.size())
+      ? win32_key_table[win32_key_code]
+      : Keyboard::Key::Invalid;
 
     switch (win32_key_code) {
-      case 'A':
-        return Keyboard::Key::A;
-      case 'B':
-        return Keyboard::Key::B;
-      case 'C':
-        return Keyboard::Key::C;
-      case 'D':
-        return Keyboard::Key::D;
-      case 'E':
-        return Keyboard::Key::E;
-      case 'F':
-        return Keyboard::Key::F;
-      case 'G':
-        return Keyboard::Key::G;
-      case 'H':
-        return Keyboard::Key::H;
-      case 'I':
-        return Keyboard::Key::I;
-      case 'J':
-        return Keyboard::Key::J;
-      case 'K':
-        return Keyboard::Key::K;
-      case 'L':
-        return Keyboard::Key::L;
-      case 'M':
-        return Keyboard::Key::M;
-      case 'N':
-        return Keyboard::Key::N;
-      case 'O':
-        return Keyboard::Key::O;
-      case 'P':
-        return Keyboard::Key::P;
-      case 'Q':
-        return Keyboard::Key::Q;
-      case 'R':
-        return Keyboard::Key::R;
-      case 'S':
-        return Keyboard::Key::S;
-      case 'T':
-        return Keyboard::Key::T;
-      case 'U':
-        return Keyboard::Key::U;
-      case 'V':
-        return Keyboard::Key::V;
-      case 'W':
-        return Keyboard::Key::W;
-      case 'X':
-        return Keyboard::Key::X;
-      case 'Y':
-        return Keyboard::Key::Y;
-      case 'Z':
-        return Keyboard::Key::Z;
-      
-      case VK_SPACE:
-        return Keyboard::Key::Space;
-      case VK_OEM_COMMA:
-        return Keyboard::Key::Comma;
-      case VK_OEM_PERIOD:
-        return Keyboard::Key::Period;
-      case VK_OEM_1:
-        return Keyboard::Key::Semicolon;
-      case VK_OEM_2:
-        return Keyboard::Key::Slash;
-      case VK_OEM_3:
-        return Keyboard::Key::Tilde;
-      case VK_OEM_4:
-        return Keyboard::Key::LeftBracket;
-      case VK_OEM_6:
-        return Keyboard::Key::RightBracket;
-      case VK_OEM_5:
-        return Keyboard::Key::Backslash;
-      case VK_OEM_7:
-        return Keyboard::Key::Quote;
-      
       case VK_SHIFT:
       {
         //VK_SHIFT doesn't differentiate between left and right shift, but the actual scan code is in the flags.
@@ -93,135 +100,11 @@ namespace rp::input {
         return (HIWORD(flags) & KF_EXTENDED) ? Keyboard::Key::RightCtrl : Keyboard::Key::LeftCtrl;
       case VK_MENU:
         return (HIWORD(flags) & KF_EXTENDED) ? Keyboard::Key::RightAlt : Keyboard::Key::LeftAlt;
-      case VK_LWIN:
-        return Keyboard::Key::LeftSystem;
-      case VK_RWIN:
-        return Keyboard::Key::RightSystem;
-      case VK_TAB:
-        return Keyboard::Key::Tab;
-      case VK_BACK:
-        return Keyboard::Key::Backspace;
-      case VK_RETURN:
-        return Keyboard::Key::Enter;
-      case VK_CAPITAL:
-        return Keyboard::Key::CapsLock;
-      case VK_ESCAPE:
-        return Keyboard::Key::Escape;
-      
-      case '0':
-        return Keyboard::Key::Num0;
-      case '1':
-        return Keyboard::Key::Num1;
-      case '2':
-        return Keyboard::Key::Num2;
-      case '3':
-        return Keyboard::Key::Num3;
-      case '4':
-        return Keyboard::Key::Num4;
-      case '5':
-        return Keyboard::Key::Num5;
-      case '6':
-        return Keyboard::Key::Num6;
-      case '7':
-        return Keyboard::Key::Num7;
-      case '8':
-        return Keyboard::Key::Num8;
-      case '9':
-        return Keyboard::Key::Num9;
-      case VK_OEM_MINUS:
-        return Keyboard::Key::Dash;
-      case VK_OEM_PLUS:
-        return Keyboard::Key::Equals;
-      
-      case VK_NUMPAD0:
-        return Keyboard::Key::Numpad0;
-      case VK_NUMPAD1:
-        return Keyboard::Key::Numpad1;
-      case VK_NUMPAD2:
-        return Keyboard::Key::Numpad2;
-      case VK_NUMPAD3:
-        return Keyboard::Key::Numpad3;
-      case VK_NUMPAD4:
-        return Keyboard::Key::Numpad4;
-      case VK_NUMPAD5:
-        return Keyboard::Key::Numpad5;
-      case VK_NUMPAD6:
-        return Keyboard::Key::Numpad6;
-      case VK_NUMPAD7:
-        return Keyboard::Key::Numpad7;
-      case VK_NUMPAD8:
-        return Keyboard::Key::Numpad8;
-      case VK_NUMPAD9:
-        return Keyboard::Key::Numpad9;
-      
-      case VK_ADD:
-        return Keyboard::Key::Add;
-      case VK_SUBTRACT:
-        return Keyboard::Key::Subtract;
-      case VK_MULTIPLY:
-        return Keyboard::Key::Multiply;
-      case VK_DIVIDE:
-        return Keyboard::Key::Divide;
-      case VK_NUMLOCK:
-        return Keyboard::Key::NumLock;
-
-      case VK_F1:
-        return Keyboard::Key::F1;
-      case VK_F2:
-        return Keyboard::Key::F2;
-      case VK_F3:
-        return Keyboard::Key::F3;
-      case VK_F4:
-        return Keyboard::Key::F4;
-      case VK_F5:
-        return Keyboard::Key::F5;
-      case VK_F6:
-        return Keyboard::Key::F6;
-      case VK_F7:
-        return Keyboard::Key::F7;
-      case VK_F8:
-        return Keyboard::Key::F8;
-      case VK_F9:
-        return Keyboard::Key::F9;
-      case VK_F10:
-        return Keyboard::Key::F10;
-      case VK_F11:
-        return Keyboard::Key::F11;
-      case VK_F12:
-        return Keyboard::Key::F12;
-
-      case VK_SNAPSHOT:
-        return Keyboard::Key::PrintScreen;
-      case VK_SCROLL:
-        return Keyboard::Key::ScrollLock;
-      case VK_PAUSE:
-        return Keyboard::Key::Pause;
-
-
-      case VK_INSERT:
-        return Keyboard::Key::Insert;
-      case VK_DELETE:
-        return Keyboard::Key::Delete;
-      case VK_HOME:
-        return Keyboard::Key::Home;
-      case VK_END:
-        return Keyboard::Key::End;
-      case VK_PRIOR:
-        return Keyboard::Key::PageUp;
-      case VK_NEXT:
-        return Keyboard::Key::PageDown;
-
-      case VK_UP:
-        return Keyboard::Key::Up;
-      case VK_DOWN:
-        return Keyboard::Key::Down;
-      case VK_LEFT:
-        return Keyboard::Key::Left;
-      case VK_RIGHT:
-        return Keyboard::Key::Right;
     }
 
-    log::rp_error("KeyCode {:#x} Not Handled!", win32_key_code);
-    return Keyboard::Key::Invalid;
+    if(key == Keyboard::Key::Invalid) {
+      log::rp_error("KeyCode {:#x} Not Handled!", win32_key_code);
+    }
+    return key;
   }
-}
\ No newline at end of file
+}
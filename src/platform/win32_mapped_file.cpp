@@ -0,0 +1,82 @@
+#include "pch.hpp"
+#include "util/mapped_file.hpp"
+
+namespace rp {
+  MappedFile::MappedFile(const std::filesystem::path& path) {
+    HANDLE file = CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      NULL,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+      NULL);
+
+    if(file == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error(fmt::format("Failed to open {}! GetLastError = 0x{:x}", path.string(), GetLastError()));
+    }
+
+    LARGE_INTEGER file_size = {};
+    if(!GetFileSizeEx(file, &file_size)) {
+      CloseHandle(file);
+      throw std::runtime_error(fmt::format("Failed to query size of {}! GetLastError = 0x{:x}", path.string(), GetLastError()));
+    }
+
+    mFileHandle = file;
+    mSize = static_cast<size_t>(file_size.QuadPart);
+
+    //empty files can't be mapped, leave them as an open file with an empty view
+    if(mSize == 0) {
+      return;
+    }
+
+    mMappingHandle = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mMappingHandle == NULL) {
+      auto error = GetLastError();
+      close();
+      throw std::runtime_error(fmt::format("Failed to create file mapping for {}! GetLastError = 0x{:x}", path.string(), error));
+    }
+
+    mData = MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if(mData == nullptr) {
+      auto error = GetLastError();
+      close();
+      throw std::runtime_error(fmt::format("Failed to map view of {}! GetLastError = 0x{:x}", path.string(), error));
+    }
+  }
+
+  MappedFile::~MappedFile() {
+    close();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+      close();
+      mData = std::exchange(other.mData, nullptr);
+      mSize = std::exchange(other.mSize, 0);
+      mFileHandle = std::exchange(other.mFileHandle, nullptr);
+      mMappingHandle = std::exchange(other.mMappingHandle, nullptr);
+    }
+    return *this;
+  }
+
+  void MappedFile::close() noexcept {
+    if(mData) {
+      UnmapViewOfFile(mData);
+      mData = nullptr;
+    }
+    if(mMappingHandle) {
+      CloseHandle(mMappingHandle);
+      mMappingHandle = nullptr;
+    }
+    if(mFileHandle) {
+      CloseHandle(mFileHandle);
+      mFileHandle = nullptr;
+    }
+    mSize = 0;
+  }
+}
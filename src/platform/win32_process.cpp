@@ -0,0 +1,8 @@
+#include "pch.hpp"
+#include "util/process.hpp"
+
+namespace rp {
+  uint32_t getProcessId() {
+    return static_cast<uint32_t>(GetCurrentProcessId());
+  }
+}
@@ -0,0 +1,89 @@
+#include "pch.hpp"
+#include "util/shared_memory.hpp"
+
+namespace rp {
+  namespace {
+    std::wstring toWide(std::string_view name) {
+      return std::wstring(name.begin(), name.end());
+    }
+  }
+
+  SharedMemory SharedMemory::Create(std::string_view name, size_t size) {
+    const auto size64 = static_cast<uint64_t>(size);
+    HANDLE mapping = CreateFileMappingW(
+      INVALID_HANDLE_VALUE,
+      NULL,
+      PAGE_READWRITE,
+      static_cast<DWORD>(size64 >> 32),
+      static_cast<DWORD>(size64 & 0xFFFFFFFF),
+      toWide(name).c_str());
+
+    if(mapping == NULL) {
+      throw std::runtime_error(fmt::format("Failed to create shared memory {}! GetLastError = 0x{:x}", name, GetLastError()));
+    }
+    //a leftover segment of the same name would carry stale contents and maybe another size
+    if(GetLastError() == ERROR_ALREADY_EXISTS) {
+      CloseHandle(mapping);
+      throw std::runtime_error(fmt::format("Shared memory {} already exists!", name));
+    }
+
+    SharedMemory memory;
+    memory.mMappingHandle = mapping;
+    memory.mData = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if(memory.mData == nullptr) {
+      throw std::runtime_error(fmt::format("Failed to map shared memory {}! GetLastError = 0x{:x}", name, GetLastError()));
+    }
+    memory.mSize = size;
+    return memory;
+  }
+
+  SharedMemory SharedMemory::Open(std::string_view name) {
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, toWide(name).c_str());
+    if(mapping == NULL) {
+      throw std::runtime_error(fmt::format("Failed to open shared memory {}! GetLastError = 0x{:x}", name, GetLastError()));
+    }
+
+    SharedMemory memory;
+    memory.mMappingHandle = mapping;
+    memory.mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(memory.mData == nullptr) {
+      throw std::runtime_error(fmt::format("Failed to map shared memory {}! GetLastError = 0x{:x}", name, GetLastError()));
+    }
+
+    //views are whole pages, so this can be larger than the size the segment was created with
+    MEMORY_BASIC_INFORMATION info = {};
+    VirtualQuery(memory.mData, &info, sizeof(info));
+    memory.mSize = info.RegionSize;
+    return memory;
+  }
+
+  SharedMemory::~SharedMemory() {
+    close();
+  }
+
+  SharedMemory::SharedMemory(SharedMemory&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept {
+    if(this != &other) {
+      close();
+      mData = std::exchange(other.mData, nullptr);
+      mSize = std::exchange(other.mSize, 0);
+      mMappingHandle = std::exchange(other.mMappingHandle, nullptr);
+    }
+    return *this;
+  }
+
+  void SharedMemory::close() noexcept {
+    if(mData) {
+      UnmapViewOfFile(mData);
+      mData = nullptr;
+    }
+    if(mMappingHandle) {
+      CloseHandle(mMappingHandle);
+      mMappingHandle = nullptr;
+    }
+    mSize = 0;
+  }
+}
@@ -3,6 +3,20 @@
 // rapier.hpp - to be included by the application ONLY,
 // not rapier itself
 #include "log/log.hpp"
+#include "util/string_id.hpp"
 #include "core/core.hpp"
 #include "core/window.hpp"
-#include "core/app.hpp"
\ No newline at end of file
+#include "core/event_queue.hpp"
+#include "core/app.hpp"
+#include "input/action_map.hpp"
+#include "asset/archive.hpp"
+#include "asset/asset.hpp"
+#include "audio/audio.hpp"
+#include "metrics/metrics.hpp"
+#include "physics/world.hpp"
+#include "serial/scene_reader.hpp"
+#include "serial/scene_writer.hpp"
+#include "snapshot/rollback.hpp"
+#include "text/cpu_canvas.hpp"
+#include "text/text_renderer.hpp"
+#include "timers/timers.hpp"
\ No newline at end of file
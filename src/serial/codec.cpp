@@ -0,0 +1,40 @@
+#include "pch.hpp"
+#include "serial/codec.hpp"
+
+namespace rp::serial {
+  OutputStream::OutputStream(std::ofstream& file, size_t buffer_size) : mFile(file), mBuffer(buffer_size) {}
+
+  OutputStream::~OutputStream() {
+    try {
+      flush();
+    } catch(std::exception& e) {
+      log::rp_error("Failed to flush serialized data: {}", e.what());
+    }
+  }
+
+  void OutputStream::flush() {
+    if(mUsed == 0) {
+      return;
+    }
+    mFile.write(reinterpret_cast<const char*>(mBuffer.data()), static_cast<std::streamsize>(mUsed));
+    mUsed = 0;
+    if(!mFile) {
+      throw std::runtime_error("Failed to write serialized data");
+    }
+  }
+
+  void OutputStream::writeSlow(const void* data, size_t size) {
+    flush();
+    if(size >= mBuffer.size()) {
+      //large arrays go straight to the file
+      mFile.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+      if(!mFile) {
+        throw std::runtime_error("Failed to write serialized data");
+      }
+    } else {
+      std::memcpy(mBuffer.data(), data, size);
+      mUsed = size;
+    }
+    mPosition += size;
+  }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "serial/reflect.hpp"
+
+namespace rp::serial {
+  //Buffered sequential writer, so a save issues a few large writes however small its fields are
+  class OutputStream {
+  public:
+    explicit OutputStream(std::ofstream& file, size_t buffer_size = size_t{1} << 20);
+    ~OutputStream();
+
+    OutputStream(const OutputStream&) = delete;
+    OutputStream& operator=(const OutputStream&) = delete;
+
+    void write(const void* data, size_t size) {
+      if(size <= mBuffer.size() - mUsed) {
+        std::memcpy(mBuffer.data() + mUsed, data, size);
+        mUsed += size;
+        mPosition += size;
+        return;
+      }
+      writeSlow(data, size);
+    }
+
+    void flush();
+
+    //Bytes written so far, including those still buffered
+    [[nodiscard]] uint64_t getPosition() const noexcept { return mPosition; }
+
+  private:
+    void writeSlow(const void* data, size_t size);
+
+    std::ofstream& mFile;
+    std::vector<std::byte> mBuffer;
+    size_t mUsed = 0;
+    uint64_t mPosition = 0;
+  };
+
+  //Bounds checked reader over an in-memory payload, throws std::runtime_error on truncated data
+  class InputStream {
+  public:
+    explicit InputStream(std::span<const std::byte> data) : mData(data) {}
+
+    void read(void* dst, size_t size) {
+      if(size > mData.size() - mOffset) {
+        throw std::runtime_error("Serialized data is truncated");
+      }
+      std::memcpy(dst, mData.data() + mOffset, size);
+      mOffset += size;
+    }
+
+    [[nodiscard]] size_t getRemaining() const noexcept { return mData.size() - mOffset; }
+
+  private:
+    std::span<const std::byte> mData;
+    size_t mOffset = 0;
+  };
+
+  template<typename T>
+  void write(OutputStream& out, const T& value) {
+    if constexpr(isBulk<T>()) {
+      out.write(&value, sizeof(T));
+    } else if constexpr(Reflected<T>) {
+      forEachField<T>(value, [&](std::string_view, const auto& field) { write(out, field); });
+    } else if constexpr(std::is_same_v<T, std::string>) {
+      const uint64_t length = value.size();
+      out.write(&length, sizeof(length));
+      out.write(value.data(), value.size());
+    } else if constexpr(IsVector<T>::value) {
+      const uint64_t count = value.size();
+      out.write(&count, sizeof(count));
+      if constexpr(isBulk<typename T::value_type>()) {
+        out.write(value.data(), value.size() * sizeof(typename T::value_type));
+      } else {
+        for(const auto& element : value) {
+          write(out, element);
+        }
+      }
+    } else if constexpr(IsArray<T>::value) {
+      for(const auto& element : value) {
+        write(out, element);
+      }
+    } else {
+      static_assert(isBulk<T>(), "Type can't be stored as raw bytes (padding, floats or not trivially copyable), reflect it with RP_REFLECT");
+    }
+  }
+
+  template<typename T>
+  void read(InputStream& in, T& value) {
+    if constexpr(isBulk<T>()) {
+      in.read(&value, sizeof(T));
+    } else if constexpr(Reflected<T>) {
+      forEachField<T>(value, [&](std::string_view, auto& field) { read(in, field); });
+    } else if constexpr(std::is_same_v<T, std::string>) {
+      uint64_t length = 0;
+      in.read(&length, sizeof(length));
+      if(length > in.getRemaining()) {
+        throw std::runtime_error("Serialized data is truncated");
+      }
+      value.resize(static_cast<size_t>(length));
+      in.read(value.data(), value.size());
+    } else if constexpr(IsVector<T>::value) {
+      using Element = typename T::value_type;
+      uint64_t count = 0;
+      in.read(&count, sizeof(count));
+      if constexpr(isBulk<Element>()) {
+        if(count > in.getRemaining() / sizeof(Element)) {
+          throw std::runtime_error("Serialized data is truncated");
+        }
+        value.resize(static_cast<size_t>(count));
+        in.read(value.data(), value.size() * sizeof(Element));
+      } else {
+        //every element takes at least one byte, so a corrupt count fails here instead of allocating
+        if(count > in.getRemaining()) {
+          throw std::runtime_error("Serialized data is truncated");
+        }
+        value.resize(static_cast<size_t>(count));
+        for(auto& element : value) {
+          read(in, element);
+        }
+      }
+    } else if constexpr(IsArray<T>::value) {
+      for(auto& element : value) {
+        read(in, element);
+      }
+    } else {
+      static_assert(isBulk<T>(), "Type can't be stored as raw bytes (padding, floats or not trivially copyable), reflect it with RP_REFLECT");
+    }
+  }
+}
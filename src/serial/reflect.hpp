@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "util/hash.hpp"
+
+//Compile-time field reflection for serialization
+//
+//A struct opts in by listing its fields with RP_REFLECT inside its definition:
+//
+//  struct Enemy {
+//    rp::UUID target;
+//    float health;
+//    std::vector<Vec2> path;  //Vec2 is reflected too
+//    RP_REFLECT(Enemy, target, health, path)
+//  };
+//
+//Fields may be reflected structs, std::string, std::vector and std::array of serializable
+//types, or any trivially copyable value without padding, which is stored as raw bytes.
+//The field list is a tuple of member pointers, so visiting it compiles down to direct
+//member accesses.
+namespace rp::serial {
+  template<typename Class, typename Member>
+  struct Field {
+    std::string_view name;
+    Member Class::* pointer;
+  };
+
+  template<typename T>
+  concept Reflected = requires {
+    { T::reflect_name } -> std::convertible_to<std::string_view>;
+    T::ReflectFields();
+  };
+
+  template<typename T>
+  struct IsVector : std::false_type {};
+  template<typename T, typename Allocator>
+  struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+  template<typename T>
+  struct IsArray : std::false_type {};
+  template<typename T, size_t N>
+  struct IsArray<std::array<T, N>> : std::true_type {};
+
+  //Calls fn(name, member) for every reflected field of object
+  template<Reflected T, typename Object, typename Fn>
+  constexpr void forEachField(Object& object, Fn&& fn) {
+    std::apply([&](const auto&... fields) { (fn(fields.name, object.*fields.pointer), ...); }, T::ReflectFields());
+  }
+
+  //Sum of the field sizes, equal to sizeof(T) when the struct has no padding
+  template<Reflected T>
+  constexpr size_t getFieldBytes() {
+    return std::apply([](const auto&... fields) {
+      return (size_t{0} + ... + sizeof(std::remove_cvref_t<decltype(std::declval<T&>().*fields.pointer)>));
+    }, T::ReflectFields());
+  }
+
+  //Values written as one block of raw bytes. Every byte has to belong to a value, or uninitialized
+  //padding would end up in the file and saving the same data twice could give different bytes.
+  //Reflected structs and arrays qualify when all their elements do and nothing sits between
+  //them, so arrays of them load with a single memcpy. Other structs only qualify when the
+  //compiler can tell they have no padding, which rules out floats, so those must be reflected.
+  template<typename T>
+  constexpr bool isBulk() {
+    if constexpr(std::is_pointer_v<T> || std::is_member_pointer_v<T> || !std::is_trivially_copyable_v<T>) {
+      return false;
+    } else if constexpr(std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+      return true;
+    } else if constexpr(Reflected<T>) {
+      return getFieldBytes<T>() == sizeof(T) && std::apply([](const auto&... fields) {
+        return (true && ... && isBulk<std::remove_cvref_t<decltype(std::declval<T&>().*fields.pointer)>>());
+      }, T::ReflectFields());
+    } else if constexpr(IsArray<T>::value) {
+      using Element = typename T::value_type;
+      return isBulk<Element>() && sizeof(T) == std::tuple_size_v<T> * sizeof(Element);
+    } else if constexpr(std::is_array_v<T>) {
+      return isBulk<std::remove_extent_t<T>>();
+    } else {
+      return std::has_unique_object_representations_v<T>;
+    }
+  }
+
+  //Hash of a type's serialized layout, stored with each object so a load into a struct
+  //whose fields have since changed fails instead of misreading the data
+  template<typename T>
+  constexpr uint64_t getSchemaHash() {
+    if constexpr(Reflected<T>) {
+      uint64_t hash = hashString(T::reflect_name);
+      std::apply([&](const auto&... fields) {
+        ((hash = hashCombine(hashCombine(hash, hashString(fields.name)),
+                             getSchemaHash<std::remove_cvref_t<decltype(std::declval<T&>().*fields.pointer)>>())), ...);
+      }, T::ReflectFields());
+      return hash;
+    } else if constexpr(std::is_same_v<T, std::string>) {
+      return hashString("string");
+    } else if constexpr(IsVector<T>::value) {
+      return hashCombine(hashString("vector"), getSchemaHash<typename T::value_type>());
+    } else if constexpr(IsArray<T>::value && !isBulk<T>()) {
+      return hashCombine(hashCombine(hashString("array"), std::tuple_size_v<T>), getSchemaHash<typename T::value_type>());
+    } else {
+      static_assert(isBulk<T>(), "Type can't be stored as raw bytes (padding, floats or not trivially copyable), reflect it with RP_REFLECT");
+      return hashCombine(hashString("bytes"), sizeof(T));
+    }
+  }
+
+  template<Reflected T>
+  constexpr uint64_t getTypeHash() {
+    return hashString(T::reflect_name);
+  }
+}
+
+//Lists the fields of T to serialize, place inside the struct definition. Supports up to 32 fields.
+#define RP_REFLECT(T, ...) \
+  static constexpr std::string_view reflect_name = #T; \
+  static constexpr auto ReflectFields() { return std::make_tuple(RP_REFLECT_FOR_EACH(RP_REFLECT_FIELD, T, __VA_ARGS__)); }
+
+#define RP_REFLECT_FIELD(T, name) ::rp::serial::Field<T, decltype(T::name)>{#name, &T::name}
+
+//Applies m(T, field) to each field, the extra expansion steps keep MSVC's preprocessor happy
+#define RP_REFLECT_EXPAND(x) x
+#define RP_REFLECT_FE_1(m, T, x) m(T, x)
+#define RP_REFLECT_FE_2(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_1(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_3(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_2(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_4(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_3(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_5(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_4(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_6(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_5(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_7(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_6(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_8(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_7(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_9(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_8(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_10(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_9(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_11(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_10(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_12(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_11(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_13(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_12(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_14(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_13(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_15(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_14(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_16(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_15(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_17(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_16(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_18(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_17(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_19(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_18(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_20(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_19(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_21(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_20(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_22(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_21(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_23(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_22(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_24(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_23(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_25(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_24(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_26(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_25(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_27(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_26(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_28(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_27(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_29(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_28(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_30(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_29(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_31(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_30(m, T, __VA_ARGS__))
+#define RP_REFLECT_FE_32(m, T, x, ...) m(T, x), RP_REFLECT_EXPAND(RP_REFLECT_FE_31(m, T, __VA_ARGS__))
+#define RP_REFLECT_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, name, ...) name
+#define RP_REFLECT_FOR_EACH(m, T, ...) \
+  RP_REFLECT_EXPAND(RP_REFLECT_SELECT(__VA_ARGS__, RP_REFLECT_FE_32, RP_REFLECT_FE_31, RP_REFLECT_FE_30, RP_REFLECT_FE_29, RP_REFLECT_FE_28, RP_REFLECT_FE_27, RP_REFLECT_FE_26, RP_REFLECT_FE_25, RP_REFLECT_FE_24, RP_REFLECT_FE_23, RP_REFLECT_FE_22, RP_REFLECT_FE_21, RP_REFLECT_FE_20, RP_REFLECT_FE_19, RP_REFLECT_FE_18, RP_REFLECT_FE_17, RP_REFLECT_FE_16, RP_REFLECT_FE_15, RP_REFLECT_FE_14, RP_REFLECT_FE_13, RP_REFLECT_FE_12, RP_REFLECT_FE_11, RP_REFLECT_FE_10, RP_REFLECT_FE_9, RP_REFLECT_FE_8, RP_REFLECT_FE_7, RP_REFLECT_FE_6, RP_REFLECT_FE_5, RP_REFLECT_FE_4, RP_REFLECT_FE_3, RP_REFLECT_FE_2, RP_REFLECT_FE_1)(m, T, __VA_ARGS__))
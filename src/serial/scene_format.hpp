@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+//On-disk layout of a serialized scene (.rpscene)
+//
+//  [SceneHeader]
+//  [object payloads]               written in save order
+//  [SceneObject x object_count]    sorted by uuid, aligned to 8
+//
+//All values are little endian. The table is read in place from the mapped file and
+//payloads are only decoded when an object is loaded.
+//
+//Payload encoding, by field type:
+//  trivially copyable values   raw bytes
+//  std::string                 uint64 length, then the characters
+//  std::vector                 uint64 count, then the elements, or one block of raw bytes for bulk types
+//  std::array                  the elements, or raw bytes for bulk types
+//  reflected structs           each field in declaration order, or raw bytes for bulk types
+namespace rp::serial {
+  constexpr std::array<char, 4> scene_magic = {'R', 'P', 'S', 'C'};
+  constexpr uint32_t scene_format_version = 1;
+
+  struct SceneHeader {
+    std::array<char, 4> magic;
+    uint32_t format_version;
+    uint16_t engine_major;  //rp::getVersion() of the engine that wrote the file
+    uint16_t engine_minor;
+    uint16_t engine_patch;
+    uint16_t reserved;
+    uint64_t object_count;
+    uint64_t toc_offset;
+  };
+
+  struct SceneObject {
+    std::array<uint8_t, 16> uuid;
+    uint64_t type_hash;    //hash of the reflected type name
+    uint64_t schema_hash;  //hash of the type's fields, see getSchemaHash
+    uint64_t offset;       //payload offset from the start of the file
+    uint64_t size;
+  };
+
+  static_assert(std::is_trivially_copyable_v<SceneHeader> && sizeof(SceneHeader) == 32);
+  static_assert(std::is_trivially_copyable_v<SceneObject> && sizeof(SceneObject) == 48);
+}
@@ -0,0 +1,63 @@
+#include "pch.hpp"
+#include "serial/scene_reader.hpp"
+
+namespace rp::serial {
+  SceneReader::SceneReader(const std::filesystem::path& path) : mPath(path), mFile(path) {
+    auto file = mFile.data();
+    if(file.size() < sizeof(SceneHeader)) {
+      throw std::runtime_error(fmt::format("{} is not a scene file!", path.string()));
+    }
+
+    const auto& header = *reinterpret_cast<const SceneHeader*>(file.data());
+    if(header.magic != scene_magic) {
+      throw std::runtime_error(fmt::format("{} is not a scene file!", path.string()));
+    }
+    if(header.format_version != scene_format_version) {
+      throw std::runtime_error(fmt::format("Scene {} has format version {}, expected {}",
+        path.string(), header.format_version, scene_format_version));
+    }
+    mEngineVersion = {header.engine_major, header.engine_minor, header.engine_patch};
+
+    if(header.toc_offset > file.size() || header.object_count > (file.size() - header.toc_offset) / sizeof(SceneObject)
+       || header.toc_offset % alignof(SceneObject) != 0) {
+      throw std::runtime_error(fmt::format("Scene {} is corrupt: object table out of bounds", path.string()));
+    }
+    mObjects = { reinterpret_cast<const SceneObject*>(file.data() + header.toc_offset), static_cast<size_t>(header.object_count) };
+
+    for(const auto& object : mObjects) {
+      if(object.offset > header.toc_offset || object.size > header.toc_offset - object.offset) {
+        throw std::runtime_error(fmt::format("Scene {} is corrupt: object out of bounds", path.string()));
+      }
+    }
+
+    log::rp_trace("Opened scene {} ({} objects, saved by v{})", path.string(), mObjects.size(), mEngineVersion.toString());
+  }
+
+  const SceneObject* SceneReader::find(const UUID& id) const {
+    auto it = std::lower_bound(mObjects.begin(), mObjects.end(), id.data(),
+      [](const SceneObject& object, const std::array<uint8_t, 16>& key) { return object.uuid < key; });
+
+    if(it == mObjects.end() || it->uuid != id.data()) {
+      return nullptr;
+    }
+    return &*it;
+  }
+
+  void SceneReader::check(const SceneObject& object, uint64_t type_hash, uint64_t schema_hash, std::string_view type_name) const {
+    if(object.type_hash != type_hash) {
+      throw std::runtime_error(fmt::format("Object {} in {} is not of type {}", UUID(object.uuid).to_string(), mPath.string(), type_name));
+    }
+    if(object.schema_hash != schema_hash) {
+      throw std::runtime_error(fmt::format("Object {} in {} was saved with different {} fields",
+        UUID(object.uuid).to_string(), mPath.string(), type_name));
+    }
+  }
+
+  void SceneReader::missing(const UUID& id) const {
+    throw std::runtime_error(fmt::format("Scene {} has no object {}", mPath.string(), id.to_string()));
+  }
+
+  std::span<const std::byte> SceneReader::payload(const SceneObject& object) const {
+    return mFile.data().subspan(static_cast<size_t>(object.offset), static_cast<size_t>(object.size));
+  }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "serial/codec.hpp"
+#include "serial/reflect.hpp"
+#include "serial/scene_format.hpp"
+#include "util/mapped_file.hpp"
+#include "util/uuid.hpp"
+#include "util/version.hpp"
+
+namespace rp::serial {
+  //Lazy reader for scene files.
+  //The file is memory mapped and only the table of contents is validated on open,
+  //an object's payload is decoded (and its pages read from disk) when it is loaded.
+  class SceneReader {
+  public:
+    explicit SceneReader(const std::filesystem::path& path);
+
+    [[nodiscard]] const SceneObject* find(const UUID& id) const;
+    [[nodiscard]] std::span<const SceneObject> objects() const noexcept { return mObjects; }
+
+    //Version of the engine that wrote the file
+    [[nodiscard]] Version getEngineVersion() const noexcept { return mEngineVersion; }
+    [[nodiscard]] const std::filesystem::path& getPath() const noexcept { return mPath; }
+
+    template<Reflected T>
+    [[nodiscard]] static bool isType(const SceneObject& object) noexcept {
+      return object.type_hash == getTypeHash<T>();
+    }
+
+    //Throws std::runtime_error if the object is missing, of another type or was saved with different fields
+    template<Reflected T>
+    void load(const SceneObject& object, T& out) const {
+      check(object, getTypeHash<T>(), getSchemaHash<T>(), T::reflect_name);
+      InputStream in(payload(object));
+      read(in, out);
+    }
+
+    template<Reflected T>
+    [[nodiscard]] T load(const UUID& id) const {
+      const SceneObject* object = find(id);
+      if(!object) {
+        missing(id);
+      }
+      T out{};
+      load(*object, out);
+      return out;
+    }
+
+  private:
+    void check(const SceneObject& object, uint64_t type_hash, uint64_t schema_hash, std::string_view type_name) const;
+    [[noreturn]] void missing(const UUID& id) const;
+    [[nodiscard]] std::span<const std::byte> payload(const SceneObject& object) const;
+
+    std::filesystem::path mPath;
+    MappedFile mFile;
+    std::span<const SceneObject> mObjects;
+    Version mEngineVersion{};
+  };
+}
@@ -0,0 +1,66 @@
+#include "pch.hpp"
+#include "serial/scene_writer.hpp"
+#include "util/version.hpp"
+
+namespace rp::serial {
+  SceneWriter::SceneWriter(const std::filesystem::path& path) : mPath(path), mFile(path, std::ios::binary | std::ios::trunc) {
+    if(!mFile) {
+      throw std::runtime_error(fmt::format("Failed to open {} for writing", path.string()));
+    }
+    mStream = std::make_unique<OutputStream>(mFile);
+
+    //patched with the real counts by finish
+    const SceneHeader header = {};
+    mStream->write(&header, sizeof(header));
+  }
+
+  SceneWriter::~SceneWriter() {
+    if(!mFinished) {
+      try {
+        finish();
+      } catch(std::exception& e) {
+        log::rp_error("Failed to finish scene {}: {}", mPath.string(), e.what());
+      }
+    }
+  }
+
+  void SceneWriter::finish() {
+    if(mFinished) {
+      return;
+    }
+    mFinished = true;
+
+    std::sort(mObjects.begin(), mObjects.end(), [](const SceneObject& lhs, const SceneObject& rhs) { return lhs.uuid < rhs.uuid; });
+    auto duplicate = std::adjacent_find(mObjects.begin(), mObjects.end(),
+      [](const SceneObject& lhs, const SceneObject& rhs) { return lhs.uuid == rhs.uuid; });
+    if(duplicate != mObjects.end()) {
+      mStream.reset();
+      mFile.close();
+      throw std::invalid_argument(fmt::format("Scene {} has more than one object with id {}", mPath.string(), UUID(duplicate->uuid).to_string()));
+    }
+
+    static constexpr std::array<std::byte, alignof(SceneObject)> padding = {};
+    mStream->write(padding.data(), (alignof(SceneObject) - mStream->getPosition() % alignof(SceneObject)) % alignof(SceneObject));
+
+    const Version version = getVersion();
+    SceneHeader header = {};
+    header.magic = scene_magic;
+    header.format_version = scene_format_version;
+    header.engine_major = version.major;
+    header.engine_minor = version.minor;
+    header.engine_patch = version.patch;
+    header.object_count = mObjects.size();
+    header.toc_offset = mStream->getPosition();
+
+    mStream->write(mObjects.data(), mObjects.size() * sizeof(SceneObject));
+    mStream->flush();
+    mStream.reset();
+
+    mFile.seekp(0);
+    mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mFile.close();
+    if(!mFile) {
+      throw std::runtime_error(fmt::format("Failed to write scene {}", mPath.string()));
+    }
+  }
+}
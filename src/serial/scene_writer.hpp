@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "serial/codec.hpp"
+#include "serial/reflect.hpp"
+#include "serial/scene_format.hpp"
+#include "util/uuid.hpp"
+
+namespace rp::serial {
+  //Streams objects to a scene file as they are added, see scene_format.hpp for the layout.
+  //Only the table of contents is kept in memory, so saves of any size use a fixed amount of it.
+  class SceneWriter {
+  public:
+    explicit SceneWriter(const std::filesystem::path& path);
+    ~SceneWriter();
+
+    SceneWriter(const SceneWriter&) = delete;
+    SceneWriter& operator=(const SceneWriter&) = delete;
+
+    template<Reflected T>
+    void add(const UUID& id, const T& object) {
+      if(mFinished) {
+        throw std::logic_error("SceneWriter::add called after finish");
+      }
+      SceneObject entry = {};
+      entry.uuid = id.data();
+      entry.type_hash = getTypeHash<T>();
+      entry.schema_hash = getSchemaHash<T>();
+      entry.offset = mStream->getPosition();
+      write(*mStream, object);
+      entry.size = mStream->getPosition() - entry.offset;
+      mObjects.push_back(entry);
+    }
+
+    //Writes the table of contents and closes the file. Throws std::invalid_argument if two objects share an id.
+    void finish();
+
+    [[nodiscard]] size_t getObjectCount() const noexcept { return mObjects.size(); }
+
+  private:
+    std::filesystem::path mPath;
+    std::ofstream mFile;
+    std::unique_ptr<OutputStream> mStream;
+    std::vector<SceneObject> mObjects;
+    bool mFinished = false;
+  };
+}
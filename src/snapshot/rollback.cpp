@@ -0,0 +1,96 @@
+#include "pch.hpp"
+#include "snapshot/rollback.hpp"
+#include "snapshot/snapshot_internal.hpp"
+
+namespace rp::snapshot {
+  namespace {
+    //rollbacks with autoAdvance, only touched from the main thread
+    std::vector<Rollback*> auto_advance_rollbacks;
+  }
+
+  Rollback::Rollback(SnapshotBuffer& snapshots, Step step, bool auto_advance)
+    : mSnapshots(snapshots),
+      mStep(std::move(step)),
+      mEvents(snapshots.getWindow()) {
+    if(!mSnapshots.isEmpty()) {
+      throw std::logic_error("Rollback needs a snapshot buffer that hasn't captured yet");
+    }
+    if(auto_advance) {
+      auto_advance_rollbacks.push_back(this);
+    }
+  }
+
+  Rollback::~Rollback() {
+    std::erase(auto_advance_rollbacks, this);
+  }
+
+  void Rollback::advance(std::span<const Event> events) {
+    resimulate();
+
+    //snapshot numbers track frames: snapshot n holds the state before frame n was stepped
+    mSnapshots.capture();
+    auto& frame_events = getFrameEvents(mFrame);
+    frame_events.assign(events.begin(), events.end());
+    for(auto it = mFutureEvents.begin(); it != mFutureEvents.end();) {
+      if(it->first == mFrame) {
+        frame_events.push_back(it->second);
+        it = mFutureEvents.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    mStep(mFrame, frame_events);
+    mFrame++;
+  }
+
+  bool Rollback::addEvent(uint64_t frame, const Event& e) {
+    if(frame >= mFrame) {
+      mFutureEvents.emplace_back(frame, e);
+      return true;
+    }
+    if(!mSnapshots.canRestore(frame)) {
+      mStats.dropped_events++;
+      return false;
+    }
+    getFrameEvents(frame).push_back(e);
+    mDirtyFrame = std::min(mDirtyFrame, frame);
+    return true;
+  }
+
+  void Rollback::resimulate() {
+    if(mDirtyFrame == UINT64_MAX) {
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t first = mDirtyFrame;
+    mDirtyFrame = UINT64_MAX;
+
+    mSnapshots.restore(first);
+    for(uint64_t frame = first; frame < mFrame; frame++) {
+      if(frame != first) {
+        mSnapshots.capture();
+      }
+      mStep(frame, getFrameEvents(frame));
+    }
+
+    const auto frames = static_cast<uint32_t>(mFrame - first);
+    mStats.rollbacks++;
+    mStats.resimulated_frames += frames;
+    mStats.last_resimulated_frames = frames;
+    mStats.last_rollback_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::span<const Event> Rollback::getEvents(uint64_t frame) const {
+    if(frame >= mFrame || !mSnapshots.canRestore(frame)) {
+      return {};
+    }
+    return mEvents[frame % mEvents.size()];
+  }
+
+  void advanceRollbacks(std::span<const Event> events) {
+    for(Rollback* rollback : auto_advance_rollbacks) {
+      rollback->advance(events);
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "core/event.hpp"
+#include "snapshot/snapshot_buffer.hpp"
+
+//Rollback and re-simulation
+//
+//A Rollback owns the deterministic part of a game: every frame it snapshots the registered
+//state, records the frame's events and runs the step function with them. When an event for
+//an earlier frame arrives late (from the network, say), the next advance restores the
+//snapshot of that frame and re-runs every step since with the corrected events.
+//Rollbacks created with autoAdvance are advanced from rp::run's loop with each frame's
+//events, before they are delivered to App::onEvent.
+namespace rp::snapshot {
+  struct RollbackStats {
+    uint64_t rollbacks = 0;
+    uint64_t resimulated_frames = 0;
+    uint64_t dropped_events = 0;  //arrived for frames older than the snapshot window
+    uint32_t last_resimulated_frames = 0;
+    double last_rollback_us = 0.0;
+  };
+
+  class Rollback {
+  public:
+    using Step = std::function<void(uint64_t frame, std::span<const Event> events)>;
+
+    Rollback(SnapshotBuffer& snapshots, Step step, bool auto_advance = true);
+    ~Rollback();
+
+    Rollback(const Rollback&) = delete;
+    Rollback& operator=(const Rollback&) = delete;
+
+    //Re-simulates if a past frame changed, then snapshots and steps the next frame
+    void advance(std::span<const Event> events);
+
+    //Adds an event to a frame. Past frames are re-simulated on the next advance, future ones
+    //are held until their frame. Returns false if the frame is older than the snapshot window.
+    bool addEvent(uint64_t frame, const Event& e);
+
+    //Restores the latest snapshot with a past frame changed and steps back up to the present
+    void resimulate();
+
+    //The frame the next advance will step
+    [[nodiscard]] uint64_t getFrame() const noexcept { return mFrame; }
+    [[nodiscard]] std::span<const Event> getEvents(uint64_t frame) const;
+    [[nodiscard]] const RollbackStats& getStats() const noexcept { return mStats; }
+
+  private:
+    [[nodiscard]] std::vector<Event>& getFrameEvents(uint64_t frame) { return mEvents[frame % mEvents.size()]; }
+
+    SnapshotBuffer& mSnapshots;
+    Step mStep;
+    uint64_t mFrame = 0;
+    std::vector<std::vector<Event>> mEvents;  //ring matching the snapshot window
+    std::vector<std::pair<uint64_t, Event>> mFutureEvents;
+    uint64_t mDirtyFrame = UINT64_MAX;
+    RollbackStats mStats;
+  };
+}
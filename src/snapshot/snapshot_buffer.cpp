@@ -0,0 +1,165 @@
+#include "pch.hpp"
+#include "snapshot/snapshot_buffer.hpp"
+
+namespace rp::snapshot {
+  namespace {
+    double microsecondsSince(std::chrono::steady_clock::time_point start) {
+      return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //dst ^= src, a word at a time
+    void xorBlock(std::byte* dst, const std::byte* src, size_t size) {
+      size_t i = 0;
+      for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t a, b;
+        std::memcpy(&a, dst + i, sizeof(a));
+        std::memcpy(&b, src + i, sizeof(b));
+        a ^= b;
+        std::memcpy(dst + i, &a, sizeof(a));
+      }
+      for(; i < size; i++) {
+        dst[i] ^= src[i];
+      }
+    }
+  }
+
+  SnapshotBuffer::SnapshotBuffer(uint32_t window, uint32_t block_size) : mBlockSize(block_size), mFrames(window) {
+    if(window == 0) {
+      throw std::invalid_argument("Snapshot window must hold at least one frame");
+    }
+    if(block_size < sizeof(uint64_t) || (block_size & (block_size - 1)) != 0) {
+      throw std::invalid_argument(fmt::format("Snapshot block size must be a power of two >= 8, got {}", block_size));
+    }
+    mScratch.resize(block_size);
+  }
+
+  RegionId SnapshotBuffer::addRegion(std::string_view name, void* data, size_t size) {
+    auto* bytes = static_cast<std::byte*>(data);
+    return addRegion(name, [bytes, size]() { return std::span<std::byte>(bytes, size); }, {});
+  }
+
+  RegionId SnapshotBuffer::addRegion(std::string_view name, Resolve resolve, Resize resize) {
+    if(mNextFrame != 0) {
+      throw std::logic_error(fmt::format("Snapshot region {} registered after the first capture", name));
+    }
+    mRegions.push_back({std::string(name), std::move(resolve), std::move(resize), {}, 0});
+    return static_cast<RegionId>(mRegions.size() - 1);
+  }
+
+  void SnapshotBuffer::captureRegion(RegionId id, Frame& frame) {
+    Region& region = mRegions[id];
+    const std::span<std::byte> live = region.resolve();
+    const size_t previous_size = region.size;
+    const size_t size = live.size();
+    const size_t block_count = (std::max(size, previous_size) + mBlockSize - 1) / mBlockSize;
+    if(region.copy.size() < block_count * mBlockSize) {
+      region.copy.resize(block_count * mBlockSize);
+    }
+
+    const size_t first_block = frame.blocks.size();
+    for(size_t b = 0; b < block_count; b++) {
+      const size_t offset = b * mBlockSize;
+      std::byte* copy = region.copy.data() + offset;
+
+      //bytes past the end of the live region compare as zeros, so shrinking is recorded too
+      const std::byte* current;
+      if(offset + mBlockSize <= size) {
+        current = live.data() + offset;
+      } else {
+        std::fill(mScratch.begin(), mScratch.end(), std::byte{0});
+        if(offset < size) {
+          std::memcpy(mScratch.data(), live.data() + offset, size - offset);
+        }
+        current = mScratch.data();
+      }
+      if(std::memcmp(copy, current, mBlockSize) == 0) {
+        continue;
+      }
+
+      frame.blocks.push_back(static_cast<uint32_t>(b));
+      const size_t data_offset = frame.data.size();
+      frame.data.resize(data_offset + mBlockSize);
+      std::memcpy(frame.data.data() + data_offset, copy, mBlockSize);
+      xorBlock(frame.data.data() + data_offset, current, mBlockSize);
+      std::memcpy(copy, current, mBlockSize);
+    }
+
+    region.size = size;
+    const size_t changed = frame.blocks.size() - first_block;
+    if(changed > 0 || size != previous_size) {
+      frame.regions.push_back({id, previous_size, size, first_block, changed});
+    }
+  }
+
+  uint64_t SnapshotBuffer::capture() {
+    const auto start = std::chrono::steady_clock::now();
+
+    Frame& frame = getFrame(mNextFrame);
+    if(mFrameCount == mFrames.size()) {
+      mStats.stored_bytes -= frame.data.size();
+    } else {
+      mFrameCount++;
+    }
+    //clear keeps the capacity, so a steady state capture doesn't allocate
+    frame.regions.clear();
+    frame.blocks.clear();
+    frame.data.clear();
+
+    mStats.state_bytes = 0;
+    for(RegionId id = 0; id < mRegions.size(); id++) {
+      captureRegion(id, frame);
+      mStats.state_bytes += mRegions[id].size;
+    }
+
+    mStats.frames_captured++;
+    mStats.stored_bytes += frame.data.size();
+    mStats.last_changed_blocks = frame.blocks.size();
+    mStats.last_capture_us = microsecondsSince(start);
+    return mNextFrame++;
+  }
+
+  void SnapshotBuffer::undo(const Frame& frame) {
+    for(auto it = frame.regions.rbegin(); it != frame.regions.rend(); ++it) {
+      Region& region = mRegions[it->region];
+      for(size_t i = 0; i < it->block_count; i++) {
+        const size_t index = it->first_block + i;
+        xorBlock(region.copy.data() + size_t{frame.blocks[index]} * mBlockSize, frame.data.data() + index * mBlockSize, mBlockSize);
+      }
+      region.size = it->previous_size;
+    }
+  }
+
+  bool SnapshotBuffer::canRestore(uint64_t frame) const noexcept {
+    return mFrameCount > 0 && frame >= getOldestFrame() && frame <= getLatestFrame();
+  }
+
+  void SnapshotBuffer::restore(uint64_t frame) {
+    if(!canRestore(frame)) {
+      throw std::out_of_range(fmt::format("Snapshot frame {} is not in the window [{}, {}]",
+        frame, getOldestFrame(), isEmpty() ? 0 : getLatestFrame()));
+    }
+    const auto start = std::chrono::steady_clock::now();
+
+    for(uint64_t f = getLatestFrame(); f > frame; f--) {
+      Frame& undone = getFrame(f);
+      undo(undone);
+      mStats.stored_bytes -= undone.data.size();
+      mFrameCount--;
+    }
+    mNextFrame = frame + 1;
+
+    for(Region& region : mRegions) {
+      if(region.resize) {
+        region.resize(region.size);
+      }
+      const std::span<std::byte> live = region.resolve();
+      if(live.size() != region.size) {
+        throw std::runtime_error(fmt::format("Snapshot region {} is {} bytes, the snapshot holds {}", region.name, live.size(), region.size));
+      }
+      if(region.size > 0) {
+        std::memcpy(live.data(), region.copy.data(), region.size);
+      }
+    }
+    mStats.last_restore_us = microsecondsSince(start);
+  }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+//Per-frame snapshots of registered memory
+//
+//The buffer keeps one full copy of the newest snapshot plus a ring of deltas. Each capture
+//compares the registered memory with that copy block by block and stores the XOR of every
+//block that changed, so a frame costs a compare pass plus the bytes that actually changed.
+//XOR deltas undo themselves, so restoring an older frame applies the newer frames' deltas
+//to the copy in reverse and writes the result back to the registered memory.
+namespace rp::snapshot {
+  using RegionId = uint32_t;
+
+  struct SnapshotStats {
+    uint64_t frames_captured = 0;
+    size_t state_bytes = 0;      //size of everything registered at the last capture
+    size_t stored_bytes = 0;     //delta bytes held in the ring
+    size_t last_changed_blocks = 0;
+    double last_capture_us = 0.0;
+    double last_restore_us = 0.0;
+  };
+
+  class SnapshotBuffer {
+  public:
+    //window is the number of frames that can be restored, block_size is the diff granularity in bytes
+    explicit SnapshotBuffer(uint32_t window, uint32_t block_size = 64);
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    //Fixed-size region. Regions must be registered before the first capture and outlive the buffer.
+    RegionId addRegion(std::string_view name, void* data, size_t size);
+
+    //Component pool whose size may change between frames, restored by resizing the vector
+    template<typename T>
+    RegionId addPool(std::string_view name, std::vector<T>& pool) {
+      static_assert(std::is_trivially_copyable_v<T>, "Snapshot pools must hold trivially copyable elements");
+      return addRegion(name,
+        [&pool]() { return std::as_writable_bytes(std::span(pool)); },
+        [&pool](size_t bytes) { pool.resize(bytes / sizeof(T)); });
+    }
+
+    //Snapshots the current contents of every region, returns the new frame's number
+    uint64_t capture();
+
+    //Writes frame back into the regions and discards every newer frame, so the next capture follows it
+    void restore(uint64_t frame);
+
+    [[nodiscard]] bool canRestore(uint64_t frame) const noexcept;
+    [[nodiscard]] bool isEmpty() const noexcept { return mFrameCount == 0; }
+    [[nodiscard]] uint64_t getLatestFrame() const noexcept { return mNextFrame - 1; }
+    [[nodiscard]] uint64_t getOldestFrame() const noexcept { return mNextFrame - mFrameCount; }
+    [[nodiscard]] uint32_t getWindow() const noexcept { return static_cast<uint32_t>(mFrames.size()); }
+    [[nodiscard]] const SnapshotStats& getStats() const noexcept { return mStats; }
+
+  private:
+    using Resolve = std::function<std::span<std::byte>()>;
+    using Resize = std::function<void(size_t bytes)>;
+
+    struct Region {
+      std::string name;
+      Resolve resolve;
+      Resize resize;               //empty for fixed-size regions
+      std::vector<std::byte> copy; //newest snapshot, zero padded to whole blocks
+      size_t size = 0;
+    };
+
+    //Changed blocks of one region in one frame
+    struct RegionDelta {
+      RegionId region;
+      size_t previous_size;
+      size_t size;
+      size_t first_block;  //into Frame::blocks
+      size_t block_count;
+    };
+
+    struct Frame {
+      std::vector<RegionDelta> regions;
+      std::vector<uint32_t> blocks;
+      std::vector<std::byte> data;  //XOR of each changed block, block_size bytes apiece
+    };
+
+    RegionId addRegion(std::string_view name, Resolve resolve, Resize resize);
+    void captureRegion(RegionId id, Frame& frame);
+    void undo(const Frame& frame);
+    [[nodiscard]] Frame& getFrame(uint64_t frame) { return mFrames[frame % mFrames.size()]; }
+
+    uint32_t mBlockSize;
+    std::vector<Region> mRegions;
+    std::vector<Frame> mFrames;  //ring indexed by frame number
+    uint64_t mNextFrame = 0;
+    uint32_t mFrameCount = 0;
+    std::vector<std::byte> mScratch;
+    SnapshotStats mStats;
+  };
+}
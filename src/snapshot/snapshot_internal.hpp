@@ -0,0 +1,10 @@
+#pragma once
+
+#include <span>
+
+#include "core/event.hpp"
+
+namespace rp::snapshot {
+  //Advances every Rollback created with autoAdvance, called once per frame with the frame's events
+  void advanceRollbacks(std::span<const Event> events);
+}
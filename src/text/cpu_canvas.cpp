@@ -0,0 +1,65 @@
+#include "pch.hpp"
+#include "text/cpu_canvas.hpp"
+
+#include <cmath>
+
+namespace rp::text {
+  namespace {
+    uint32_t blend(uint32_t dst, uint32_t src, uint32_t coverage) {
+      const uint32_t alpha = (((src >> 24) & 0xFF) * coverage + 127) / 255;
+      if(alpha == 0) {
+        return dst;
+      }
+
+      uint32_t result = 0;
+      for(uint32_t shift = 0; shift < 24; shift += 8) {
+        const uint32_t s = (src >> shift) & 0xFF;
+        const uint32_t d = (dst >> shift) & 0xFF;
+        result |= ((s * alpha + d * (255 - alpha) + 127) / 255) << shift;
+      }
+      const uint32_t dst_alpha = (dst >> 24) & 0xFF;
+      result |= (alpha + (dst_alpha * (255 - alpha) + 127) / 255) << 24;
+      return result;
+    }
+  }
+
+  CpuCanvas::CpuCanvas(uint32_t width, uint32_t height)
+    : mWidth(width),
+      mHeight(height),
+      mPixels(static_cast<size_t>(width) * height, 0) {}
+
+  void CpuCanvas::clear(uint32_t color) {
+    std::fill(mPixels.begin(), mPixels.end(), color);
+  }
+
+  void CpuCanvas::draw(const TextBatch& batch, const GlyphAtlas& atlas) {
+    const auto coverage = atlas.getPixels();
+    const float atlas_width = static_cast<float>(atlas.getWidth());
+    const float atlas_height = static_cast<float>(atlas.getHeight());
+
+    for(const auto& quad : batch.quads) {
+      const auto x_begin = static_cast<int64_t>(std::max(std::floor(quad.x0), 0.0f));
+      const auto y_begin = static_cast<int64_t>(std::max(std::floor(quad.y0), 0.0f));
+      const auto x_end = static_cast<int64_t>(std::min(std::ceil(quad.x1), static_cast<float>(mWidth)));
+      const auto y_end = static_cast<int64_t>(std::min(std::ceil(quad.y1), static_cast<float>(mHeight)));
+      if(x_begin >= x_end || y_begin >= y_end) {
+        continue;
+      }
+
+      //texels per pixel, 1 for quads straight from TextRenderer
+      const float du = (quad.u1 - quad.u0) * atlas_width / (quad.x1 - quad.x0);
+      const float dv = (quad.v1 - quad.v0) * atlas_height / (quad.y1 - quad.y0);
+      for(int64_t y = y_begin; y < y_end; y++) {
+        const float v = quad.v0 * atlas_height + (static_cast<float>(y) + 0.5f - quad.y0) * dv;
+        const auto texel_y = std::clamp<int64_t>(static_cast<int64_t>(v), 0, atlas.getHeight() - 1);
+        const uint8_t* row = coverage.data() + texel_y * atlas.getWidth();
+        uint32_t* out = mPixels.data() + y * mWidth;
+        for(int64_t x = x_begin; x < x_end; x++) {
+          const float u = quad.u0 * atlas_width + (static_cast<float>(x) + 0.5f - quad.x0) * du;
+          const auto texel_x = std::clamp<int64_t>(static_cast<int64_t>(u), 0, atlas.getWidth() - 1);
+          out[x] = blend(out[x], quad.color, row[texel_x]);
+        }
+      }
+    }
+  }
+}
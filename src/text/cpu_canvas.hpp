@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "text/glyph_atlas.hpp"
+#include "text/text_renderer.hpp"
+
+namespace rp::text {
+  //Software render target that draws text batches into RGBA8 pixels, for headless runs and tests
+  class CpuCanvas {
+  public:
+    CpuCanvas(uint32_t width, uint32_t height);
+
+    void clear(uint32_t color);
+    //Alpha blends every quad's color by the atlas coverage under it, nearest texel, clipped to the canvas
+    void draw(const TextBatch& batch, const GlyphAtlas& atlas);
+
+    [[nodiscard]] uint32_t getWidth() const noexcept { return mWidth; }
+    [[nodiscard]] uint32_t getHeight() const noexcept { return mHeight; }
+    //0xAABBGGRR per pixel, row major
+    [[nodiscard]] std::span<const uint32_t> getPixels() const noexcept { return mPixels; }
+    [[nodiscard]] uint32_t getPixel(uint32_t x, uint32_t y) const noexcept { return mPixels[static_cast<size_t>(y) * mWidth + x]; }
+
+  private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<uint32_t> mPixels;
+  };
+}
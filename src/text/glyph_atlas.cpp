@@ -0,0 +1,131 @@
+#include "pch.hpp"
+#include "text/glyph_atlas.hpp"
+
+namespace rp::text {
+  GlyphAtlas::GlyphAtlas(uint32_t width, uint32_t height)
+    : mWidth(width),
+      mHeight(height),
+      mPixels(static_cast<size_t>(width) * height, 0) {
+    if(width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF) {
+      throw std::invalid_argument(fmt::format("Invalid glyph atlas size {}x{}!", width, height));
+    }
+  }
+
+  const GlyphAtlas::Glyph* GlyphAtlas::find(uint64_t key) const {
+    const auto it = mGlyphs.find(key);
+    return (it != mGlyphs.end()) ? &it->second : nullptr;
+  }
+
+  void GlyphAtlas::touch(uint32_t shelf) noexcept {
+    if(shelf != no_shelf) {
+      mShelves[shelf].last_frame = mFrame;
+    }
+  }
+
+  uint32_t GlyphAtlas::findShelf(uint32_t width, uint32_t height, bool allow_waste) const {
+    //the shortest shelf that fits, skipping ones much taller than the glyph unless out of room
+    uint32_t best = no_shelf;
+    for(uint32_t i = 0; i < mShelves.size(); i++) {
+      const auto& shelf = mShelves[i];
+      if(shelf.height < height || shelf.x + width > mWidth) {
+        continue;
+      }
+      if(!allow_waste && shelf.height > height + height / 2) {
+        continue;
+      }
+      if(best == no_shelf || shelf.height < mShelves[best].height) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  uint32_t GlyphAtlas::evictShelf(uint32_t height) {
+    uint32_t oldest = no_shelf;
+    for(uint32_t i = 0; i < mShelves.size(); i++) {
+      const auto& shelf = mShelves[i];
+      if(shelf.height < height || shelf.last_frame == mFrame) {
+        continue;
+      }
+      if(oldest == no_shelf || shelf.last_frame < mShelves[oldest].last_frame) {
+        oldest = i;
+      }
+    }
+    if(oldest == no_shelf) {
+      return no_shelf;
+    }
+
+    auto& shelf = mShelves[oldest];
+    for(const auto key : shelf.keys) {
+      mGlyphs.erase(key);
+    }
+    shelf.keys.clear();
+    shelf.x = 0;
+    //stale coverage would bleed into the padding around new glyphs
+    for(uint32_t y = shelf.y; y < shelf.y + shelf.height; y++) {
+      std::fill_n(mPixels.begin() + static_cast<size_t>(y) * mWidth, mWidth, uint8_t(0));
+    }
+    markDirty({0, shelf.y, mWidth, shelf.height});
+    mEvictions++;
+    return oldest;
+  }
+
+  const GlyphAtlas::Glyph* GlyphAtlas::insert(uint64_t key, const GlyphBitmap& bitmap) {
+    Glyph glyph;
+    glyph.left = bitmap.left;
+    glyph.top = bitmap.top;
+    glyph.advance = bitmap.advance;
+    if(bitmap.width == 0 || bitmap.height == 0) {
+      return &(mGlyphs[key] = glyph);
+    }
+
+    const uint32_t width = bitmap.width + padding;
+    const uint32_t height = bitmap.height + padding;
+    if(width > mWidth || height > mHeight) {
+      return nullptr;
+    }
+
+    uint32_t shelf_index = findShelf(width, height, false);
+    if(shelf_index == no_shelf && mNextShelfY + height <= mHeight) {
+      mShelves.push_back({mNextShelfY, height, 0, mFrame, {}});
+      mNextShelfY += height;
+      shelf_index = static_cast<uint32_t>(mShelves.size() - 1);
+    }
+    if(shelf_index == no_shelf) {
+      shelf_index = findShelf(width, height, true);
+    }
+    if(shelf_index == no_shelf) {
+      shelf_index = evictShelf(height);
+    }
+    if(shelf_index == no_shelf) {
+      return nullptr;
+    }
+
+    auto& shelf = mShelves[shelf_index];
+    glyph.rect = {shelf.x, shelf.y, bitmap.width, bitmap.height};
+    glyph.shelf = shelf_index;
+    shelf.x += width;
+    shelf.last_frame = mFrame;
+    shelf.keys.push_back(key);
+
+    for(uint32_t y = 0; y < bitmap.height; y++) {
+      std::copy_n(bitmap.coverage.begin() + static_cast<size_t>(y) * bitmap.width, bitmap.width,
+                  mPixels.begin() + static_cast<size_t>(glyph.rect.y + y) * mWidth + glyph.rect.x);
+    }
+    markDirty(glyph.rect);
+    return &(mGlyphs[key] = glyph);
+  }
+
+  void GlyphAtlas::markDirty(const AtlasRect& rect) noexcept {
+    if(mDirty.width == 0) {
+      mDirty = rect;
+      return;
+    }
+    const uint32_t x1 = std::max(mDirty.x + mDirty.width, rect.x + rect.width);
+    const uint32_t y1 = std::max(mDirty.y + mDirty.height, rect.y + rect.height);
+    mDirty.x = std::min(mDirty.x, rect.x);
+    mDirty.y = std::min(mDirty.y, rect.y);
+    mDirty.width = x1 - mDirty.x;
+    mDirty.height = y1 - mDirty.y;
+  }
+}
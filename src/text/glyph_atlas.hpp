@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "text/glyph_source.hpp"
+
+namespace rp::text {
+  struct AtlasRect {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+  };
+
+  //Single channel coverage texture that glyphs are packed into on demand.
+  //Glyphs go on shelves, rows as tall as the tallest glyph placed on them, filled left to right.
+  //When the atlas is full the least recently used shelf is cleared as a whole, which keeps
+  //packing simple and never fragments the texture. Shelves used in the current frame are
+  //never cleared, so quads emitted during a frame stay valid until the next beginFrame.
+  class GlyphAtlas {
+  public:
+    static constexpr uint32_t no_shelf = 0xFFFFFFFF;
+
+    struct Glyph {
+      AtlasRect rect;        //empty for blank glyphs like space
+      int32_t left = 0;
+      int32_t top = 0;
+      float advance = 0.0f;
+      uint32_t shelf = no_shelf;
+    };
+
+    GlyphAtlas(uint32_t width, uint32_t height);
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    void beginFrame() noexcept { mFrame++; }
+
+    [[nodiscard]] const Glyph* find(uint64_t key) const;
+    //Packs bitmap under key, clearing old shelves if needed. Returns nullptr when every shelf
+    //that could hold it is in use this frame.
+    const Glyph* insert(uint64_t key, const GlyphBitmap& bitmap);
+    //Keeps a shelf alive for this frame
+    void touch(uint32_t shelf) noexcept;
+
+    //Counts shelf clears, anything holding atlas positions must look them up again when it changes
+    [[nodiscard]] uint64_t getEvictionCount() const noexcept { return mEvictions; }
+    [[nodiscard]] size_t getGlyphCount() const noexcept { return mGlyphs.size(); }
+
+    [[nodiscard]] uint32_t getWidth() const noexcept { return mWidth; }
+    [[nodiscard]] uint32_t getHeight() const noexcept { return mHeight; }
+    [[nodiscard]] std::span<const uint8_t> getPixels() const noexcept { return mPixels; }
+
+    //Region written since the last clearDirty, for backends that upload the atlas to a texture
+    [[nodiscard]] const AtlasRect& getDirtyRect() const noexcept { return mDirty; }
+    void clearDirty() noexcept { mDirty = {}; }
+
+  private:
+    static constexpr uint32_t padding = 1;
+
+    struct Shelf {
+      uint32_t y = 0;
+      uint32_t height = 0;
+      uint32_t x = 0;
+      uint64_t last_frame = 0;
+      std::vector<uint64_t> keys;
+    };
+
+    uint32_t findShelf(uint32_t width, uint32_t height, bool allow_waste) const;
+    uint32_t evictShelf(uint32_t height);
+    void markDirty(const AtlasRect& rect) noexcept;
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<uint8_t> mPixels;
+    std::vector<Shelf> mShelves;
+    uint32_t mNextShelfY = 0;
+    std::unordered_map<uint64_t, Glyph> mGlyphs;
+    uint64_t mFrame = 1;
+    uint64_t mEvictions = 0;
+    AtlasRect mDirty;
+  };
+}
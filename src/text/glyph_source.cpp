@@ -0,0 +1,100 @@
+#include "pch.hpp"
+#include "text/glyph_source.hpp"
+
+#include <cmath>
+
+namespace rp::text {
+  namespace {
+    //Glyphs sit in a 6x8 cell: 5 columns plus spacing, 7 rows above the baseline plus one below
+    constexpr uint32_t cell_width = 6;
+    constexpr uint32_t cell_height = 8;
+    constexpr uint32_t glyph_columns = 5;
+    constexpr uint32_t glyph_rows = 7;
+
+    //One byte per column for ' ' to '~', bit 0 is the top row
+    constexpr std::array<std::array<uint8_t, glyph_columns>, 95> ascii_glyphs = {{
+      {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14},
+      {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00},
+      {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+      {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+      {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31},
+      {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+      {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00},
+      {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06},
+      {0x32, 0x49, 0x79, 0x41, 0x3E}, {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+      {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x49, 0x49, 0x7A},
+      {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41},
+      {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+      {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31},
+      {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F},
+      {0x63, 0x14, 0x08, 0x14, 0x63}, {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+      {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+      {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20},
+      {0x38, 0x44, 0x44, 0x48, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+      {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00},
+      {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+      {0x7C, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+      {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C},
+      {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00},
+      {0x00, 0x00, 0x7F, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+    }};
+
+    //hollow box for codepoints outside the font
+    constexpr std::array<uint8_t, glyph_columns> fallback_glyph = {0x7F, 0x41, 0x41, 0x41, 0x7F};
+
+    const std::array<uint8_t, glyph_columns>& getColumns(char32_t codepoint) {
+      if(codepoint >= U' ' && codepoint <= U'~') {
+        return ascii_glyphs[codepoint - U' '];
+      }
+      return fallback_glyph;
+    }
+
+    bool isSet(const std::array<uint8_t, glyph_columns>& columns, uint32_t x, uint32_t y) {
+      return x < glyph_columns && y < glyph_rows && ((columns[x] >> y) & 1);
+    }
+  }
+
+  FontMetrics BuiltinFont::getFontMetrics(uint32_t pixel_size) const {
+    const float scale = static_cast<float>(pixel_size) / cell_height;
+    return {glyph_rows * scale, (cell_height - glyph_rows) * scale, static_cast<float>(pixel_size)};
+  }
+
+  void BuiltinFont::rasterize(char32_t codepoint, uint32_t pixel_size, GlyphBitmap& out) const {
+    const double scale = static_cast<double>(pixel_size) / cell_height;
+    out.advance = static_cast<float>(std::round(cell_width * scale));
+    out.coverage.clear();
+    if(codepoint == U' ' || pixel_size == 0) {
+      out.width = out.height = 0;
+      out.left = out.top = 0;
+      return;
+    }
+
+    const auto& columns = getColumns(codepoint);
+    out.width = static_cast<uint32_t>(std::ceil(glyph_columns * scale));
+    out.height = static_cast<uint32_t>(std::ceil(glyph_rows * scale));
+    out.left = 0;
+    out.top = -static_cast<int32_t>(std::round(glyph_rows * scale));
+    out.coverage.assign(static_cast<size_t>(out.width) * out.height, 0);
+
+    //each output pixel covers a 1/scale square of the source grid, its value is the lit fraction of that square
+    const double inverse = 1.0 / scale;
+    for(uint32_t y = 0; y < out.height; y++) {
+      const double y0 = y * inverse;
+      const double y1 = y0 + inverse;
+      for(uint32_t x = 0; x < out.width; x++) {
+        const double x0 = x * inverse;
+        const double x1 = x0 + inverse;
+        double lit = 0.0;
+        for(auto sy = static_cast<uint32_t>(y0); sy < std::min<double>(y1, glyph_rows); sy++) {
+          const double overlap_y = std::min(y1, sy + 1.0) - std::max(y0, static_cast<double>(sy));
+          for(auto sx = static_cast<uint32_t>(x0); sx < std::min<double>(x1, glyph_columns); sx++) {
+            if(isSet(columns, sx, sy)) {
+              lit += overlap_y * (std::min(x1, sx + 1.0) - std::max(x0, static_cast<double>(sx)));
+            }
+          }
+        }
+        out.coverage[static_cast<size_t>(y) * out.width + x] = static_cast<uint8_t>(std::lround(std::min(lit * scale * scale, 1.0) * 255.0));
+      }
+    }
+  }
+}
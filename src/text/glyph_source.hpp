@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace rp::text {
+  struct FontMetrics {
+    float ascent = 0.0f;       //baseline to the top of the tallest glyph
+    float descent = 0.0f;      //baseline to the bottom of the lowest glyph, positive
+    float line_height = 0.0f;
+  };
+
+  //8-bit coverage of one glyph, offset from the pen position on the baseline, y down
+  struct GlyphBitmap {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int32_t left = 0;
+    int32_t top = 0;
+    float advance = 0.0f;
+    std::vector<uint8_t> coverage;  //width * height, row major
+  };
+
+  //Turns codepoints into glyph bitmaps at a pixel size, so fonts can come from anywhere
+  class GlyphSource {
+  public:
+    virtual ~GlyphSource() = default;
+
+    [[nodiscard]] virtual FontMetrics getFontMetrics(uint32_t pixel_size) const = 0;
+    //Codepoints the source has no glyph for render as its fallback glyph
+    virtual void rasterize(char32_t codepoint, uint32_t pixel_size, GlyphBitmap& out) const = 0;
+  };
+
+  //Built-in 5x7 bitmap font covering printable ASCII. Scaled with an area filter, so
+  //multiples of 8 pixels are crisp and other sizes are antialiased.
+  class BuiltinFont final : public GlyphSource {
+  public:
+    [[nodiscard]] FontMetrics getFontMetrics(uint32_t pixel_size) const override;
+    void rasterize(char32_t codepoint, uint32_t pixel_size, GlyphBitmap& out) const override;
+  };
+}
@@ -0,0 +1,179 @@
+#include "pch.hpp"
+#include "text/text_renderer.hpp"
+#include "util/hash.hpp"
+
+namespace rp::text {
+  namespace {
+    constexpr char32_t replacement_character = 0xFFFD;
+    //cached runs are swept for expiry this often rather than every frame
+    constexpr uint64_t sweep_interval = 64;
+
+    uint64_t getGlyphKey(char32_t codepoint, uint32_t pixel_size) {
+      return (static_cast<uint64_t>(codepoint) << 32) | pixel_size;
+    }
+
+    //Decodes one UTF-8 sequence and advances pos, malformed bytes decode as U+FFFD
+    char32_t decodeUtf8(std::string_view text, size_t& pos) {
+      const auto lead = static_cast<uint8_t>(text[pos++]);
+      if(lead < 0x80) {
+        return lead;
+      }
+
+      const uint32_t length = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 0;
+      if(length == 0 || lead > 0xF4) {
+        return replacement_character;
+      }
+      char32_t codepoint = lead & (0x7F >> length);
+      for(uint32_t i = 1; i < length; i++) {
+        if(pos >= text.size() || (static_cast<uint8_t>(text[pos]) & 0xC0) != 0x80) {
+          return replacement_character;
+        }
+        codepoint = (codepoint << 6) | (static_cast<uint8_t>(text[pos++]) & 0x3F);
+      }
+      return codepoint;
+    }
+  }
+
+  TextRenderer::TextRenderer(std::shared_ptr<const GlyphSource> source, const Properties& properties)
+    : mSource(source ? std::move(source) : std::make_shared<BuiltinFont>()),
+      mAtlas(properties.atlasWidth, properties.atlasHeight),
+      mRunLifetime(properties.runLifetimeFrames) {}
+
+  void TextRenderer::beginFrame() {
+    mFrame++;
+    mAtlas.beginFrame();
+
+    if(mFrame % sweep_interval == 0) {
+      std::erase_if(mRuns, [&](const auto& entry) { return entry.second.last_frame + mRunLifetime < mFrame; });
+      mStats.cached_runs = mRuns.size();
+    }
+  }
+
+  TextRenderer::Run& TextRenderer::getRun(std::string_view text, uint32_t pixel_size) {
+    const uint64_t key = hashCombine(hashString(text), pixel_size);
+    auto [it, inserted] = mRuns.try_emplace(key);
+    Run& run = it->second;
+
+    //a hash collision replaces the older string, both still draw correctly
+    if(inserted || run.pixel_size != pixel_size || run.text != text) {
+      run.text = text;
+      run.pixel_size = pixel_size;
+      layout(run);
+      buildQuads(run);
+      mStats.runs_built++;
+      mStats.cached_runs = mRuns.size();
+    } else if(run.atlas_evictions != mAtlas.getEvictionCount() || run.dropped_glyphs) {
+      buildQuads(run);
+      mStats.runs_refreshed++;
+    } else {
+      for(const auto shelf : run.shelves) {
+        mAtlas.touch(shelf);
+      }
+      mStats.run_hits++;
+    }
+    run.last_frame = mFrame;
+    return run;
+  }
+
+  void TextRenderer::layout(Run& run) {
+    const auto metrics = mSource->getFontMetrics(run.pixel_size);
+    run.glyphs.clear();
+    run.extent = {0.0f, metrics.ascent + metrics.descent};
+
+    float pen_x = 0.0f;
+    float pen_y = 0.0f;
+    size_t pos = 0;
+    while(pos < run.text.size()) {
+      const char32_t codepoint = decodeUtf8(run.text, pos);
+      if(codepoint == U'\n') {
+        pen_x = 0.0f;
+        pen_y += metrics.line_height;
+        run.extent.height += metrics.line_height;
+        continue;
+      }
+
+      run.glyphs.push_back({codepoint, pen_x, pen_y});
+      //advances come from the atlas entry, so a glyph is only rasterized once per size
+      const uint64_t key = getGlyphKey(codepoint, run.pixel_size);
+      const auto* glyph = mAtlas.find(key);
+      float advance = 0.0f;
+      if(glyph) {
+        advance = glyph->advance;
+        mAtlas.touch(glyph->shelf);
+      } else {
+        mSource->rasterize(codepoint, run.pixel_size, mScratch);
+        mStats.glyphs_rasterized++;
+        //a glyph that doesn't fit is retried and counted by buildQuads
+        mAtlas.insert(key, mScratch);
+        advance = mScratch.advance;
+      }
+      pen_x += advance;
+      run.extent.width = std::max(run.extent.width, pen_x);
+    }
+  }
+
+  void TextRenderer::buildQuads(Run& run) {
+    run.quads.clear();
+    run.shelves.clear();
+    run.dropped_glyphs = false;
+    const float inverse_width = 1.0f / static_cast<float>(mAtlas.getWidth());
+    const float inverse_height = 1.0f / static_cast<float>(mAtlas.getHeight());
+
+    for(const auto& placed : run.glyphs) {
+      const uint64_t key = getGlyphKey(placed.codepoint, run.pixel_size);
+      const auto* glyph = mAtlas.find(key);
+      if(!glyph) {
+        mSource->rasterize(placed.codepoint, run.pixel_size, mScratch);
+        mStats.glyphs_rasterized++;
+        glyph = mAtlas.insert(key, mScratch);
+        if(!glyph) {
+          mStats.glyphs_dropped++;
+          run.dropped_glyphs = true;
+          continue;
+        }
+      }
+      if(glyph->rect.width == 0) {
+        continue;
+      }
+
+      mAtlas.touch(glyph->shelf);
+      if(std::find(run.shelves.begin(), run.shelves.end(), glyph->shelf) == run.shelves.end()) {
+        run.shelves.push_back(glyph->shelf);
+      }
+
+      const auto& rect = glyph->rect;
+      const float x0 = placed.x + static_cast<float>(glyph->left);
+      const float y0 = placed.y + static_cast<float>(glyph->top);
+      run.quads.push_back({
+        x0, y0, x0 + static_cast<float>(rect.width), y0 + static_cast<float>(rect.height),
+        static_cast<float>(rect.x) * inverse_width, static_cast<float>(rect.y) * inverse_height,
+        static_cast<float>(rect.x + rect.width) * inverse_width, static_cast<float>(rect.y + rect.height) * inverse_height,
+        0});
+    }
+    run.atlas_evictions = mAtlas.getEvictionCount();
+  }
+
+  TextExtent TextRenderer::draw(TextBatch& batch, std::string_view text, float x, float y, uint32_t pixel_size, uint32_t color) {
+    const Run& run = getRun(text, pixel_size);
+
+    //whole pixel origins keep the glyphs on the atlas texel grid
+    const float origin_x = std::round(x);
+    const float origin_y = std::round(y);
+    const size_t first = batch.quads.size();
+    batch.quads.resize(first + run.quads.size());
+    for(size_t i = 0; i < run.quads.size(); i++) {
+      Quad quad = run.quads[i];
+      quad.x0 += origin_x;
+      quad.x1 += origin_x;
+      quad.y0 += origin_y;
+      quad.y1 += origin_y;
+      quad.color = color;
+      batch.quads[first + i] = quad;
+    }
+    return run.extent;
+  }
+
+  TextExtent TextRenderer::measure(std::string_view text, uint32_t pixel_size) {
+    return getRun(text, pixel_size).extent;
+  }
+}
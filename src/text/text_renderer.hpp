@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "text/glyph_atlas.hpp"
+#include "text/glyph_source.hpp"
+
+//Text rendering
+//
+//Strings are laid out into runs of glyph quads, cached by string hash and pixel size, so
+//drawing a string that hasn't changed since it was last drawn copies its quads and does no
+//decoding, layout or glyph lookups. Glyphs are rasterized by a GlyphSource the first time
+//they are needed and packed into a GlyphAtlas. The output is a TextBatch of textured quads in
+//pixels, y down, with normalized atlas coordinates, for any backend to draw along with the
+//atlas coverage. CpuCanvas is a software backend for headless runs and tests.
+namespace rp::text {
+  struct Quad {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+    uint32_t color;  //0xAABBGGRR
+  };
+
+  struct TextBatch {
+    std::vector<Quad> quads;
+
+    void clear() noexcept { quads.clear(); }
+  };
+
+  struct TextExtent {
+    float width = 0.0f;
+    float height = 0.0f;
+  };
+
+  struct TextStats {
+    uint64_t runs_built = 0;
+    uint64_t run_hits = 0;
+    uint64_t runs_refreshed = 0;     //cached runs rebuilt after an atlas eviction or to retry dropped glyphs
+    uint64_t glyphs_rasterized = 0;
+    uint64_t glyphs_dropped = 0;     //didn't fit in the atlas, every shelf was in use
+    size_t cached_runs = 0;
+  };
+
+  struct Properties {
+    uint32_t atlasWidth = 1024;
+    uint32_t atlasHeight = 1024;
+    uint32_t runLifetimeFrames = 120;  //cached runs not drawn for this long are dropped
+  };
+
+  class TextRenderer {
+  public:
+    //Uses the built-in font without a source
+    explicit TextRenderer(std::shared_ptr<const GlyphSource> source = nullptr, const Properties& properties = {});
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    //Starts a frame, quads from earlier frames may point at atlas space that has been reused since
+    void beginFrame();
+
+    //UTF-8 text with its first baseline at y, '\n' starts a new line. Returns the laid out size.
+    TextExtent draw(TextBatch& batch, std::string_view text, float x, float y, uint32_t pixel_size, uint32_t color = 0xFFFFFFFF);
+    [[nodiscard]] TextExtent measure(std::string_view text, uint32_t pixel_size);
+
+    [[nodiscard]] const GlyphAtlas& getAtlas() const noexcept { return mAtlas; }
+    [[nodiscard]] GlyphAtlas& getAtlas() noexcept { return mAtlas; }
+    [[nodiscard]] const TextStats& getStats() const noexcept { return mStats; }
+
+  private:
+    struct PlacedGlyph {
+      char32_t codepoint;
+      float x;  //pen position relative to the run origin
+      float y;
+    };
+
+    struct Run {
+      std::string text;
+      uint32_t pixel_size = 0;
+      TextExtent extent;
+      std::vector<PlacedGlyph> glyphs;
+      std::vector<Quad> quads;       //relative to the run origin, colored when drawn
+      std::vector<uint32_t> shelves; //atlas shelves the quads sample from
+      uint64_t atlas_evictions = 0;
+      bool dropped_glyphs = false;   //retried every draw until they fit
+      uint64_t last_frame = 0;
+    };
+
+    Run& getRun(std::string_view text, uint32_t pixel_size);
+    void layout(Run& run);
+    //Looks up or rasterizes every glyph of a laid out run and rebuilds its quads
+    void buildQuads(Run& run);
+
+    std::shared_ptr<const GlyphSource> mSource;
+    GlyphAtlas mAtlas;
+    uint32_t mRunLifetime;
+    std::unordered_map<uint64_t, Run> mRuns;
+    GlyphBitmap mScratch;
+    uint64_t mFrame = 0;
+    TextStats mStats;
+  };
+}
@@ -0,0 +1,258 @@
+#include "pch.hpp"
+#include "timers/timer_wheel.hpp"
+
+#include <bit>
+
+namespace rp::timers {
+  namespace {
+    constexpr uint64_t slot_mask = TimerWheel::slots_per_level - 1;
+    constexpr uint32_t words_per_level = TimerWheel::slots_per_level / 64;
+
+    //First set bit of a level's bitmap at or after from, wrapping around, slots_per_level if none
+    uint32_t findOccupied(const uint64_t* bits, uint32_t from) {
+      for(uint32_t i = 0; i <= words_per_level; i++) {
+        const uint32_t word = ((from >> 6) + i) % words_per_level;
+        uint64_t mask = bits[word];
+        if(i == 0) {
+          mask &= ~uint64_t(0) << (from & 63);
+        } else if(i == words_per_level) {
+          mask &= ~(~uint64_t(0) << (from & 63));
+        }
+        if(mask != 0) {
+          return word * 64 + static_cast<uint32_t>(std::countr_zero(mask));
+        }
+      }
+      return TimerWheel::slots_per_level;
+    }
+  }
+
+  TimerWheel::TimerWheel(uint64_t start_tick)
+    : mSlotHeads(level_count * slots_per_level, invalid_index),
+      mTick(start_tick) {}
+
+  void TimerWheel::reserve(size_t timer_count) {
+    while(mChunks.size() * chunk_size < timer_count) {
+      mChunks.push_back(std::make_unique<Node[]>(chunk_size));
+    }
+  }
+
+  uint32_t TimerWheel::allocateNode() {
+    if(mFreeHead != invalid_index) {
+      const uint32_t index = mFreeHead;
+      mFreeHead = getNode(index).next;
+      return index;
+    }
+
+    if(mNodeCount == mChunks.size() * chunk_size) {
+      mChunks.push_back(std::make_unique<Node[]>(chunk_size));
+    }
+    return mNodeCount++;
+  }
+
+  void TimerWheel::freeNode(uint32_t index) {
+    auto& node = getNode(index);
+    node.callback = nullptr;
+    node.generation = (node.generation == 0xFFFFFFFF) ? 1 : node.generation + 1;
+    node.slot = slot_free;
+    node.cancel_requested = false;
+    node.prev = invalid_index;
+    node.next = mFreeHead;
+    mFreeHead = index;
+  }
+
+  void TimerWheel::link(uint32_t index) {
+    auto& node = getNode(index);
+
+    //the level is picked by distance, the slot by the expiry's digit at that level
+    const uint64_t delay = std::min(node.expiry - mTick, max_slot_delay);
+    const uint32_t level = (delay <= slot_mask) ? 0 : std::min<uint32_t>((std::bit_width(delay) - 1) / level_bits, level_count - 1);
+    const uint64_t slot = ((mTick + delay) >> (level * level_bits)) & slot_mask;
+
+    node.slot = static_cast<uint16_t>(level * slots_per_level + slot);
+    node.prev = invalid_index;
+    node.next = mSlotHeads[node.slot];
+    if(node.next != invalid_index) {
+      getNode(node.next).prev = index;
+    }
+    mSlotHeads[node.slot] = index;
+    mOccupied[node.slot >> 6] |= uint64_t(1) << (node.slot & 63);
+    mPendingCount++;
+  }
+
+  void TimerWheel::unlink(uint32_t index) {
+    auto& node = getNode(index);
+    if(node.prev != invalid_index) {
+      getNode(node.prev).next = node.next;
+    } else {
+      mSlotHeads[node.slot] = node.next;
+      if(node.next == invalid_index) {
+        mOccupied[node.slot >> 6] &= ~(uint64_t(1) << (node.slot & 63));
+      }
+    }
+    if(node.next != invalid_index) {
+      getNode(node.next).prev = node.prev;
+    }
+    node.prev = invalid_index;
+    node.next = invalid_index;
+    mPendingCount--;
+  }
+
+  void TimerWheel::cascade(uint32_t level, uint32_t slot) {
+    const uint32_t head_index = level * slots_per_level + slot;
+    uint32_t index = mSlotHeads[head_index];
+    mSlotHeads[head_index] = invalid_index;
+    mOccupied[head_index >> 6] &= ~(uint64_t(1) << (head_index & 63));
+    while(index != invalid_index) {
+      const uint32_t next = getNode(index).next;
+      mPendingCount--;
+      link(index);
+      index = next;
+    }
+  }
+
+  uint64_t TimerWheel::findNextEvent() const noexcept {
+    uint64_t next = UINT64_MAX;
+    for(uint32_t level = 0; level < level_count; level++) {
+      const uint32_t shift = level * level_bits;
+      const auto digit = static_cast<uint32_t>((mTick >> shift) & slot_mask);
+      const uint32_t slot = findOccupied(&mOccupied[level * words_per_level], (digit + 1) & slot_mask);
+      if(slot == slots_per_level) {
+        continue;
+      }
+
+      //level 0 slots are collected when the tick reaches them, higher ones cascade when the
+      //digits below turn over to zero. Slots at or before the current digit belong to the next turn.
+      const uint64_t turn = uint64_t(1) << (shift + level_bits);
+      uint64_t tick = (mTick & ~(turn - 1)) + (uint64_t(slot) << shift);
+      if(slot <= digit) {
+        tick += turn;
+      }
+      next = std::min(next, tick);
+    }
+    return next;
+  }
+
+  void TimerWheel::retire(uint32_t index) {
+    auto& node = getNode(index);
+    if(node.period == 0 || node.cancel_requested) {
+      freeNode(index);
+      return;
+    }
+
+    node.expiry += node.period;
+    if(node.expiry <= mTick) {
+      node.expiry += ((mTick - node.expiry) / node.period + 1) * node.period;
+    }
+    link(index);
+  }
+
+  TimerId TimerWheel::schedule(uint64_t delay, Callback callback, uint64_t period) {
+    const uint32_t index = allocateNode();
+    auto& node = getNode(index);
+    node.callback = std::move(callback);
+    node.expiry = mTick + std::max<uint64_t>(delay, 1);
+    node.period = period;
+    link(index);
+    return {index, node.generation};
+  }
+
+  bool TimerWheel::isPending(TimerId id) const noexcept {
+    if(id.index >= mNodeCount) {
+      return false;
+    }
+    const auto& node = getNode(id.index);
+    return node.generation == id.generation && node.slot != slot_free && !node.cancel_requested;
+  }
+
+  bool TimerWheel::cancel(TimerId id) {
+    if(!isPending(id)) {
+      return false;
+    }
+
+    auto& node = getNode(id.index);
+    if(node.slot == slot_firing) {
+      //the running callback can't be destroyed under itself, it is freed once it returns
+      if(id.index == mFiring) {
+        node.cancel_requested = true;
+        return true;
+      }
+      //waiting later in the current batch, delivery skips it by generation
+      freeNode(id.index);
+      return true;
+    }
+
+    unlink(id.index);
+    freeNode(id.index);
+    return true;
+  }
+
+  size_t TimerWheel::advance(uint64_t tick) {
+    if(mAdvancing) {
+      throw std::logic_error("TimerWheel::advance called from a timer callback!");
+    }
+
+    while(mTick < tick) {
+      const uint64_t next = findNextEvent();
+      if(next > tick) {
+        mTick = tick;
+        break;
+      }
+
+      mTick = next;
+      if((mTick & slot_mask) == 0) {
+        for(uint32_t level = 1; level < level_count; level++) {
+          const auto slot = static_cast<uint32_t>((mTick >> (level * level_bits)) & slot_mask);
+          cascade(level, slot);
+          if(slot != 0) {
+            break;
+          }
+        }
+      }
+
+      auto& head = mSlotHeads[mTick & slot_mask];
+      while(head != invalid_index) {
+        const uint32_t index = head;
+        unlink(index);
+        auto& node = getNode(index);
+        node.slot = slot_firing;
+        mBatch.push_back({index, node.generation});
+      }
+    }
+
+    //callbacks run after the wheel is settled, so anything they schedule lands past the current tick
+    mAdvancing = true;
+    size_t delivered = 0;
+    for(size_t i = 0; i < mBatch.size(); i++) {
+      const auto id = mBatch[i];
+      auto& node = getNode(id.index);
+      if(node.generation != id.generation) {
+        continue;
+      }
+
+      mFiring = id.index;
+      try {
+        node.callback();
+      } catch(...) {
+        mFiring = invalid_index;
+        retire(id.index);
+        //the rest of the batch fires on the next advance
+        for(size_t j = i + 1; j < mBatch.size(); j++) {
+          auto& rest = getNode(mBatch[j].index);
+          if(rest.generation == mBatch[j].generation) {
+            rest.expiry = mTick + 1;
+            link(mBatch[j].index);
+          }
+        }
+        mBatch.clear();
+        mAdvancing = false;
+        throw;
+      }
+      mFiring = invalid_index;
+      retire(id.index);
+      delivered++;
+    }
+    mBatch.clear();
+    mAdvancing = false;
+    return delivered;
+  }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rp::timers {
+  using Callback = std::function<void()>;
+
+  struct TimerId {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool isValid() const noexcept { return generation != 0; }
+    bool operator==(const TimerId& rhs) const = default;
+  };
+
+  //Hierarchical timing wheel counting in abstract ticks. Four levels of 256 slots each cover 2^32
+  //ticks, longer delays wait in the top level and are re-placed as it turns. Scheduling and
+  //cancelling are O(1). Advancing jumps straight to the next occupied slot or cascade using a
+  //bitmap per level, so empty stretches are free no matter how far the wheel moves.
+  //Nodes live in fixed size chunks that are never moved, and freed nodes are reused.
+  class TimerWheel {
+  public:
+    static constexpr uint32_t level_bits = 8;
+    static constexpr uint32_t level_count = 4;
+    static constexpr uint32_t slots_per_level = 1 << level_bits;
+    static constexpr uint64_t max_slot_delay = (uint64_t(1) << (level_bits * level_count)) - 1;
+
+    explicit TimerWheel(uint64_t start_tick = 0);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    //Fires on the first advance reaching getTick() + delay, a delay of 0 fires on the next advance.
+    //A non zero period repeats the timer until it is cancelled.
+    TimerId schedule(uint64_t delay, Callback callback, uint64_t period = 0);
+
+    //Returns false for stale ids. Safe to call from a callback, including on the running timer.
+    bool cancel(TimerId id);
+    [[nodiscard]] bool isPending(TimerId id) const noexcept;
+
+    //Moves to tick, collecting every timer expiring on the way, then calls them in order of expiry tick.
+    //Callbacks may schedule and cancel freely. A repeating timer fires at most once per advance,
+    //missed periods are skipped. Returns the number of callbacks called.
+    size_t advance(uint64_t tick);
+
+    void reserve(size_t timer_count);
+
+    [[nodiscard]] uint64_t getTick() const noexcept { return mTick; }
+    //Timers waiting in the wheel
+    [[nodiscard]] size_t getPendingCount() const noexcept { return mPendingCount; }
+    [[nodiscard]] size_t getCapacity() const noexcept { return mNodeCount; }
+
+  private:
+    static constexpr uint32_t invalid_index = 0xFFFFFFFF;
+    static constexpr uint32_t chunk_bits = 12;
+    static constexpr uint32_t chunk_size = 1 << chunk_bits;
+    static constexpr uint16_t slot_free = 0xFFFF;
+    static constexpr uint16_t slot_firing = 0xFFFE;
+
+    struct Node {
+      Callback callback;
+      uint64_t expiry = 0;
+      uint64_t period = 0;
+      uint32_t next = invalid_index;   //list in a slot, or the free list
+      uint32_t prev = invalid_index;
+      uint32_t generation = 1;
+      uint16_t slot = slot_free;       //level * slots_per_level + slot, or slot_free/slot_firing
+      bool cancel_requested = false;   //cancelled from inside its own callback
+    };
+
+    [[nodiscard]] Node& getNode(uint32_t index) noexcept { return mChunks[index >> chunk_bits][index & (chunk_size - 1)]; }
+    [[nodiscard]] const Node& getNode(uint32_t index) const noexcept { return mChunks[index >> chunk_bits][index & (chunk_size - 1)]; }
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t index);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(uint32_t level, uint32_t slot);
+    //Next tick after getTick() that collects or cascades a slot, UINT64_MAX if the wheel is empty
+    [[nodiscard]] uint64_t findNextEvent() const noexcept;
+    //Frees a fired timer or links it again for its next period
+    void retire(uint32_t index);
+
+    std::vector<std::unique_ptr<Node[]>> mChunks;
+    uint32_t mNodeCount = 0;
+    uint32_t mFreeHead = invalid_index;
+
+    std::vector<uint32_t> mSlotHeads;  //level_count * slots_per_level
+    std::array<uint64_t, level_count * slots_per_level / 64> mOccupied = {};
+    uint64_t mTick;
+    size_t mPendingCount = 0;
+
+    std::vector<TimerId> mBatch;
+    uint32_t mFiring = invalid_index;
+    bool mAdvancing = false;
+  };
+}
@@ -0,0 +1,81 @@
+#include "pch.hpp"
+#include "timers/timers_internal.hpp"
+
+namespace rp::timers {
+  namespace {
+    struct Manager {
+      Clock::time_point origin;
+      Clock::time_point time;
+      Clock::duration resolution;
+      TimerWheel wheel;
+    };
+
+    std::unique_ptr<Manager> manager;
+
+    Manager& getManager() {
+      if(!manager) {
+        throw std::runtime_error("Timer system used before rp::run initialized it!");
+      }
+      return *manager;
+    }
+
+    uint64_t toTicks(const Manager& mgr, Clock::duration duration) {
+      const auto count = std::max<Clock::rep>(duration.count(), 0);
+      return static_cast<uint64_t>((count + mgr.resolution.count() - 1) / mgr.resolution.count());
+    }
+  }
+
+  void init(const Properties& properties) {
+    if(properties.resolution.count() <= 0) {
+      throw std::invalid_argument("Timer resolution must be positive!");
+    }
+
+    manager = std::make_unique<Manager>();
+    manager->origin = Clock::now();
+    manager->time = manager->origin;
+    manager->resolution = properties.resolution;
+    manager->wheel.reserve(properties.reserveTimers);
+  }
+
+  void update(Clock::time_point frame_start) {
+    auto& mgr = getManager();
+    mgr.time = std::max(mgr.time, frame_start);
+    mgr.wheel.advance(static_cast<uint64_t>((mgr.time - mgr.origin) / mgr.resolution));
+  }
+
+  void shutdown() {
+    if(manager && manager->wheel.getPendingCount() > 0) {
+      log::rp_trace("Dropping {} pending timers", manager->wheel.getPendingCount());
+    }
+    manager.reset();
+  }
+
+  TimerId schedule(Clock::duration delay, Callback callback) {
+    auto& mgr = getManager();
+    //the wheel sits on the tick the frame started in, so count the part of it already gone
+    const auto elapsed = (mgr.time - mgr.origin) % mgr.resolution;
+    return mgr.wheel.schedule(toTicks(mgr, elapsed + delay), std::move(callback));
+  }
+
+  TimerId scheduleRepeating(Clock::duration period, Callback callback) {
+    auto& mgr = getManager();
+    const auto elapsed = (mgr.time - mgr.origin) % mgr.resolution;
+    return mgr.wheel.schedule(toTicks(mgr, elapsed + period), std::move(callback), std::max<uint64_t>(toTicks(mgr, period), 1));
+  }
+
+  bool cancel(TimerId timer) {
+    return getManager().wheel.cancel(timer);
+  }
+
+  bool isPending(TimerId timer) {
+    return getManager().wheel.isPending(timer);
+  }
+
+  size_t getPendingCount() {
+    return getManager().wheel.getPendingCount();
+  }
+
+  Clock::time_point getTime() {
+    return getManager().time;
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "timers/timer_wheel.hpp"
+
+//Timers and delayed callbacks
+//
+//Timers live in a hierarchical timing wheel that rp::run advances with each frame's start time,
+//so scheduling and cancelling are O(1) and a pending timer costs nothing until its slot comes up.
+//Expired callbacks are delivered together on the main thread before App::update, in order of expiry.
+//Delays count from the start of the current frame and are rounded up to the tick resolution.
+//All functions here must be called from the main thread.
+namespace rp::timers {
+  using Clock = std::chrono::steady_clock;
+
+  struct Properties {
+    Clock::duration resolution = std::chrono::milliseconds(1);
+    uint32_t reserveTimers = 4096;
+  };
+
+  TimerId schedule(Clock::duration delay, Callback callback);
+  //First fires after one period. Fires at most once per frame, periods missed by a long frame are skipped.
+  TimerId scheduleRepeating(Clock::duration period, Callback callback);
+
+  //Returns false if the timer already fired or was cancelled
+  bool cancel(TimerId timer);
+  [[nodiscard]] bool isPending(TimerId timer);
+
+  [[nodiscard]] size_t getPendingCount();
+  //Start time of the current frame, which delays are measured from
+  [[nodiscard]] Clock::time_point getTime();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "timers/timers.hpp"
+
+namespace rp::timers {
+  void init(const Properties& properties);
+
+  //Advances the wheel to frame_start and delivers expired callbacks, called once per frame
+  void update(Clock::time_point frame_start);
+
+  void shutdown();
+}
@@ -0,0 +1,36 @@
+#include "pch.hpp"
+
+#include "util/file_watcher.hpp"
+#include "platform/win32_file_watcher.hpp"
+
+namespace rp {
+
+  FileWatcher::FileWatcher(const std::filesystem::path& directory, Clock::duration debounce)
+    : mDirectory(directory), mDebounce(debounce) {}
+
+  void FileWatcher::notifyChanged(const std::filesystem::path& path) {
+    std::lock_guard lock(mMutex);
+    mPending[path] = Clock::now();
+  }
+
+  std::vector<std::filesystem::path> FileWatcher::collectChanges() {
+    std::vector<std::filesystem::path> settled;
+    const auto now = Clock::now();
+
+    std::lock_guard lock(mMutex);
+    for(auto it = mPending.begin(); it != mPending.end();) {
+      if(now - it->second >= mDebounce) {
+        settled.push_back(it->first);
+        it = mPending.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return settled;
+  }
+
+  std::unique_ptr<FileWatcher> createFileWatcher(const std::filesystem::path& directory, FileWatcher::Clock::duration debounce) {
+    log::rp_info("Watching {} for changes", directory.string());
+    return std::make_unique<Win32FileWatcher>(directory, debounce);
+  }
+}
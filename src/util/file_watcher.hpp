@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rp {
+  //Watches a directory tree for modified files on a background thread.
+  //Bursts of notifications for the same file (editors often write in several steps)
+  //are debounced, a path is only reported once it has been quiet for the debounce interval.
+  class FileWatcher {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    FileWatcher(const std::filesystem::path& directory, Clock::duration debounce);
+    virtual ~FileWatcher() = default;
+
+    //Returns the paths whose changes have settled since the last call
+    [[nodiscard]] std::vector<std::filesystem::path> collectChanges();
+
+    [[nodiscard]] const std::filesystem::path& getDirectory() const noexcept { return mDirectory; }
+
+  protected:
+    //Called from the platform watcher thread
+    void notifyChanged(const std::filesystem::path& path);
+
+    std::filesystem::path mDirectory;
+
+  private:
+    Clock::duration mDebounce;
+    std::mutex mMutex;
+    std::map<std::filesystem::path, Clock::time_point> mPending;
+  };
+
+  std::unique_ptr<FileWatcher> createFileWatcher(const std::filesystem::path& directory, FileWatcher::Clock::duration debounce);
+}
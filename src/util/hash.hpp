@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace rp {
+  //64-bit FNV-1a, usable at compile time for string literals
+  constexpr uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+  constexpr uint64_t fnv1a_prime        = 0x00000100000001b3ull;
+
+  constexpr uint64_t hashString(std::string_view str, uint64_t seed = fnv1a_offset_basis) {
+    uint64_t hash = seed;
+    for(char c : str) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= fnv1a_prime;
+    }
+    return hash;
+  }
+
+  constexpr uint64_t hashCombine(uint64_t lhs, uint64_t rhs) {
+    return lhs ^ (rhs + 0x9e3779b97f4a7c15ull + (lhs << 6) + (lhs >> 2));
+  }
+}
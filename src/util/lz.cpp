@@ -0,0 +1,175 @@
+#include "pch.hpp"
+#include "util/lz.hpp"
+
+namespace rp::lz {
+  namespace {
+    constexpr size_t min_match = 4;
+    constexpr size_t last_literals = 5;    //the block always ends with at least this many literals
+    constexpr size_t match_safe_distance = 12; //no match may start this close to the end of the block
+    constexpr size_t max_offset = 65535;
+    constexpr size_t hash_bits = 14;
+
+    uint32_t read32(const std::byte* ptr) {
+      uint32_t value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    }
+
+    uint32_t hashSequence(uint32_t sequence) {
+      return (sequence * 2654435761u) >> (32 - hash_bits);
+    }
+
+    void writeLength(std::vector<std::byte>& out, size_t length) {
+      while(length >= 255) {
+        out.push_back(std::byte{255});
+        length -= 255;
+      }
+      out.push_back(static_cast<std::byte>(length));
+    }
+
+    void writeSequence(std::vector<std::byte>& out, const std::byte* literals, size_t literal_length,
+                       size_t offset, size_t match_length) {
+      const size_t match_code = match_length ? match_length - min_match : 0;
+      const auto token = static_cast<uint8_t>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15));
+      out.push_back(static_cast<std::byte>(token));
+
+      if(literal_length >= 15) {
+        writeLength(out, literal_length - 15);
+      }
+      out.insert(out.end(), literals, literals + literal_length);
+
+      if(match_length) {
+        out.push_back(static_cast<std::byte>(offset & 0xFF));
+        out.push_back(static_cast<std::byte>(offset >> 8));
+        if(match_code >= 15) {
+          writeLength(out, match_code - 15);
+        }
+      }
+    }
+  }
+
+  std::vector<std::byte> compress(std::span<const std::byte> src) {
+    std::vector<std::byte> out;
+    out.reserve(compressBound(src.size()));
+
+    const std::byte* const begin = src.data();
+    const std::byte* const end = begin + src.size();
+    const std::byte* anchor = begin;
+
+    if(src.size() > match_safe_distance) {
+      const std::byte* const match_limit = end - last_literals;
+      const std::byte* const search_limit = end - match_safe_distance;
+      std::vector<uint32_t> table(size_t{1} << hash_bits, 0);
+
+      const std::byte* ip = begin + 1;
+      while(ip < search_limit) {
+        const uint32_t sequence = read32(ip);
+        const uint32_t hash = hashSequence(sequence);
+        const std::byte* candidate = begin + table[hash];
+        table[hash] = static_cast<uint32_t>(ip - begin);
+
+        if(candidate >= ip || static_cast<size_t>(ip - candidate) > max_offset || read32(candidate) != sequence) {
+          ip++;
+          continue;
+        }
+
+        //extend the match backwards over pending literals, then forwards
+        while(ip > anchor && candidate > begin && ip[-1] == candidate[-1]) {
+          ip--;
+          candidate--;
+        }
+
+        const std::byte* match_end = ip + min_match;
+        const std::byte* candidate_end = candidate + min_match;
+        while(match_end < match_limit && *match_end == *candidate_end) {
+          match_end++;
+          candidate_end++;
+        }
+
+        writeSequence(out, anchor, static_cast<size_t>(ip - anchor),
+                      static_cast<size_t>(ip - candidate), static_cast<size_t>(match_end - ip));
+        ip = match_end;
+        anchor = ip;
+
+        if(ip < search_limit) {
+          table[hashSequence(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - begin);
+        }
+      }
+    }
+
+    writeSequence(out, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return out;
+  }
+
+  bool decompress(std::span<const std::byte> src, std::span<std::byte> dst) {
+    const std::byte* ip = src.data();
+    const std::byte* const ip_end = ip + src.size();
+    std::byte* op = dst.data();
+    std::byte* const op_end = op + dst.size();
+
+    auto readLength = [&](size_t length) -> std::optional<size_t> {
+      if(length != 15) {
+        return length;
+      }
+      uint8_t extra;
+      do {
+        if(ip >= ip_end) {
+          return std::nullopt;
+        }
+        extra = static_cast<uint8_t>(*ip++);
+        length += extra;
+      } while(extra == 255);
+      return length;
+    };
+
+    while(ip < ip_end) {
+      const auto token = static_cast<uint8_t>(*ip++);
+
+      const auto literal_length = readLength(token >> 4);
+      if(!literal_length ||
+         *literal_length > static_cast<size_t>(ip_end - ip) ||
+         *literal_length > static_cast<size_t>(op_end - op)) {
+        return false;
+      }
+      std::memcpy(op, ip, *literal_length);
+      ip += *literal_length;
+      op += *literal_length;
+
+      //the last sequence has no match
+      if(ip == ip_end) {
+        break;
+      }
+
+      if(ip_end - ip < 2) {
+        return false;
+      }
+      const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+      ip += 2;
+      if(offset == 0 || offset > static_cast<size_t>(op - dst.data())) {
+        return false;
+      }
+
+      auto match_length = readLength(token & 0x0F);
+      if(!match_length) {
+        return false;
+      }
+      *match_length += min_match;
+      if(*match_length > static_cast<size_t>(op_end - op)) {
+        return false;
+      }
+
+      //matches may overlap their own output, so copy forwards byte by byte when they do
+      const std::byte* match = op - offset;
+      if(offset >= *match_length) {
+        std::memcpy(op, match, *match_length);
+        op += *match_length;
+      } else {
+        for(size_t i = 0; i < *match_length; i++) {
+          *op++ = *match++;
+        }
+      }
+    }
+
+    return op == op_end;
+  }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+//Fast LZ77 block compression using the LZ4 block format.
+//Favours decompression speed over ratio, suitable for assets that are decoded at load time.
+namespace rp::lz {
+  //Worst case compressed size for an input of the given size
+  constexpr size_t compressBound(size_t size) {
+    return size + (size / 255) + 16;
+  }
+
+  [[nodiscard]] std::vector<std::byte> compress(std::span<const std::byte> src);
+
+  //Decompresses src into dst, which must be exactly the uncompressed size.
+  //Returns false if the compressed data is malformed or doesn't fill dst.
+  [[nodiscard]] bool decompress(std::span<const std::byte> src, std::span<std::byte> dst);
+}
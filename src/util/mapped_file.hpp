@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace rp {
+  //Read-only view of a whole file mapped into the address space.
+  //Pages are faulted in by the OS on first access, nothing is copied up front.
+  class MappedFile {
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return mFileHandle != nullptr; }
+    [[nodiscard]] size_t size() const noexcept { return mSize; }
+    [[nodiscard]] std::span<const std::byte> data() const noexcept {
+      return { static_cast<const std::byte*>(mData), mSize };
+    }
+
+  private:
+    void close() noexcept;
+
+    const void* mData = nullptr;
+    size_t mSize = 0;
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+  };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rp {
+  [[nodiscard]] uint32_t getProcessId();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace rp {
+  //Named memory shared between processes. The OS keeps it alive while any process has it mapped.
+  class SharedMemory {
+  public:
+    SharedMemory() = default;
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    SharedMemory(SharedMemory&& other) noexcept;
+    SharedMemory& operator=(SharedMemory&& other) noexcept;
+
+    //Creates a zero filled, writable segment. Throws std::runtime_error on failure.
+    [[nodiscard]] static SharedMemory Create(std::string_view name, size_t size);
+    //Maps an existing segment read only. Throws std::runtime_error if it doesn't exist.
+    [[nodiscard]] static SharedMemory Open(std::string_view name);
+
+    [[nodiscard]] bool isOpen() const noexcept { return mData != nullptr; }
+    [[nodiscard]] size_t size() const noexcept { return mSize; }
+    //Writing through a segment from Open faults
+    [[nodiscard]] std::span<std::byte> data() const noexcept {
+      return { static_cast<std::byte*>(mData), mSize };
+    }
+
+  private:
+    void close() noexcept;
+
+    void* mData = nullptr;
+    size_t mSize = 0;
+    void* mMappingHandle = nullptr;
+  };
+}
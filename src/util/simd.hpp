@@ -0,0 +1,9 @@
+#pragma once
+
+//SSE2 is baseline on x86-64, other targets use the scalar paths
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define RP_SSE2 1
+  #include <emmintrin.h>
+#else
+  #define RP_SSE2 0
+#endif
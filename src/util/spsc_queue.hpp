@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace rp {
+  //Bounded lock-free queue for exactly one producer thread and one consumer thread.
+  //Neither side ever blocks or allocates, so it is safe to use from real-time threads.
+  template<typename T>
+  class SpscQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>);
+
+  public:
+    //capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity)
+      : mCapacity(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        mSlots(std::make_unique<Slot[]>(mCapacity)) {}
+
+    ~SpscQueue() {
+      while(pop()) {}
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    //Producer side, returns false if the queue is full
+    bool push(T value) noexcept {
+      const size_t tail = mTail.load(std::memory_order_relaxed);
+      if(tail - mHeadCache == mCapacity) {
+        mHeadCache = mHead.load(std::memory_order_acquire);
+        if(tail - mHeadCache == mCapacity) {
+          return false;
+        }
+      }
+      new(&mSlots[tail & (mCapacity - 1)].storage) T(std::move(value));
+      mTail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    //Consumer side
+    std::optional<T> pop() noexcept {
+      const size_t head = mHead.load(std::memory_order_relaxed);
+      if(head == mTailCache) {
+        mTailCache = mTail.load(std::memory_order_acquire);
+        if(head == mTailCache) {
+          return std::nullopt;
+        }
+      }
+      T* slot = std::launder(reinterpret_cast<T*>(&mSlots[head & (mCapacity - 1)].storage));
+      std::optional<T> value(std::move(*slot));
+      slot->~T();
+      mHead.store(head + 1, std::memory_order_release);
+      return value;
+    }
+
+    [[nodiscard]] size_t getCapacity() const noexcept { return mCapacity; }
+
+    //Approximate when called while the other side is active
+    [[nodiscard]] size_t size() const noexcept {
+      return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Slot {
+      alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    //producer and consumer state on separate cache lines
+    static constexpr size_t cache_line = 64;
+
+    const size_t mCapacity;
+    std::unique_ptr<Slot[]> mSlots;
+    alignas(cache_line) std::atomic<size_t> mHead = 0;
+    size_t mTailCache = 0;  //consumer's last view of mTail
+    alignas(cache_line) std::atomic<size_t> mTail = 0;
+    size_t mHeadCache = 0;  //producer's last view of mHead
+  };
+}
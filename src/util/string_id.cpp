@@ -0,0 +1,56 @@
+#include "pch.hpp"
+
+#include <shared_mutex>
+
+#include "util/string_id.hpp"
+
+namespace rp {
+#if RP_STRING_ID_NAMES
+  namespace {
+    struct InternTable {
+      std::shared_mutex mutex;
+      //node based, so views of the names stay valid as the table grows
+      std::unordered_map<uint64_t, std::string> names;
+    };
+
+    InternTable& getInternTable() {
+      static InternTable table;
+      return table;
+    }
+  }
+
+  StringId StringId::Intern(std::string_view name) {
+    const StringId id(name);
+    auto& table = getInternTable();
+    {
+      std::shared_lock lock(table.mutex);
+      auto it = table.names.find(id.mHash);
+      if(it != table.names.end()) {
+        if(it->second != name) {
+          log::rp_error("StringId collision: \"{}\" and \"{}\" both hash to {:016x}", it->second, name, id.mHash);
+        }
+        return id;
+      }
+    }
+
+    std::unique_lock lock(table.mutex);
+    table.names.try_emplace(id.mHash, name);
+    return id;
+  }
+
+  std::string_view StringId::getName() const {
+    auto& table = getInternTable();
+    std::shared_lock lock(table.mutex);
+    auto it = table.names.find(mHash);
+    return (it != table.names.end()) ? std::string_view(it->second) : std::string_view();
+  }
+#else
+  StringId StringId::Intern(std::string_view name) {
+    return StringId(name);
+  }
+
+  std::string_view StringId::getName() const {
+    return {};
+  }
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <fmt/format.h>
+
+#include "util/hash.hpp"
+
+//Builds that keep interned names for reverse lookup, on by default in debug builds
+#if !defined(RP_STRING_ID_NAMES)
+  #if defined(NDEBUG)
+    #define RP_STRING_ID_NAMES 0
+  #else
+    #define RP_STRING_ID_NAMES 1
+  #endif
+#endif
+
+namespace rp {
+  //64-bit hashed name. Comparing and hashing ids is a single integer operation.
+  //
+  //Ids of literals are computed at compile time: constexpr StringId jump("Jump"), or "Jump"_sid.
+  //Names built at runtime should go through Intern(), which in builds with RP_STRING_ID_NAMES
+  //records the name for getName() and reports names whose hashes collide.
+  class StringId {
+  public:
+    constexpr StringId() = default;
+    constexpr StringId(const char* name) : mHash(hashString(name)) {}
+    constexpr StringId(std::string_view name) : mHash(hashString(name)) {}
+    StringId(const std::string& name) : mHash(hashString(name)) {}
+
+    [[nodiscard]] static StringId Intern(std::string_view name);
+    [[nodiscard]] static constexpr StringId FromHash(uint64_t hash) {
+      StringId id;
+      id.mHash = hash;
+      return id;
+    }
+
+    [[nodiscard]] constexpr uint64_t getHash() const noexcept { return mHash; }
+    [[nodiscard]] constexpr bool isValid() const noexcept { return mHash != 0; }
+
+    //The interned name, or an empty view if it wasn't interned or names are compiled out
+    [[nodiscard]] std::string_view getName() const;
+
+    constexpr bool operator==(const StringId& rhs) const = default;
+    constexpr auto operator<=>(const StringId& rhs) const = default;
+
+  private:
+    uint64_t mHash = 0;
+  };
+
+  namespace literals {
+    consteval StringId operator""_sid(const char* str, size_t length) {
+      return StringId(std::string_view(str, length));
+    }
+  }
+}
+
+template<>
+struct std::hash<rp::StringId> {
+  size_t operator()(const rp::StringId& id) const noexcept {
+    return static_cast<size_t>(id.getHash());
+  }
+};
+
+//Formats as the interned name when known, otherwise as #<hash>
+template<>
+struct fmt::formatter<rp::StringId> {
+  constexpr auto parse(fmt::format_parse_context& ctx) {
+    auto it = ctx.begin(), end = ctx.end();
+    if(it != end && *it != '}')
+      throw format_error("invalid format parsing rp::StringId");
+    return it;
+  }
+
+  template<typename FormatContext>
+  auto format(const rp::StringId& id, FormatContext& ctx) {
+    const auto name = id.getName();
+    if(name.empty())
+      return format_to(ctx.out(), "#{:016x}", id.getHash());
+    return format_to(ctx.out(), "{}", name);
+  }
+};
@@ -0,0 +1,122 @@
+#include "pch.hpp"
+#include "util/thread_pool.hpp"
+
+namespace rp {
+  size_t ThreadPool::GetDefaultWorkerCount() {
+    const size_t hardware_threads = std::thread::hardware_concurrency();
+    return (hardware_threads > 1) ? hardware_threads - 1 : 0;
+  }
+
+  ThreadPool::ThreadPool(size_t worker_count) {
+    mWorkers.reserve(worker_count);
+    for(size_t i = 0; i < worker_count; i++) {
+      mWorkers.emplace_back(&ThreadPool::workerMain, this);
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard lock(mMutex);
+      mStopping = true;
+    }
+    mTaskAvailable.notify_all();
+    for(auto& worker : mWorkers) {
+      worker.join();
+    }
+  }
+
+  void ThreadPool::workerMain() {
+    while(true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mMutex);
+        mTaskAvailable.wait(lock, [&]() { return mStopping || !mTasks.empty(); });
+        if(mTasks.empty()) {
+          return;
+        }
+        task = std::move(mTasks.front());
+        mTasks.pop_front();
+      }
+
+      task();
+
+      std::lock_guard lock(mMutex);
+      if(--mPendingTasks == 0) {
+        mTasksDone.notify_all();
+      }
+    }
+  }
+
+  void ThreadPool::submit(std::function<void()> task) {
+    if(mWorkers.empty()) {
+      task();
+      return;
+    }
+
+    {
+      std::lock_guard lock(mMutex);
+      mTasks.push_back(std::move(task));
+      mPendingTasks++;
+    }
+    mTaskAvailable.notify_one();
+  }
+
+  void ThreadPool::wait() {
+    std::unique_lock lock(mMutex);
+    mTasksDone.wait(lock, [&]() { return mPendingTasks == 0; });
+  }
+
+  void ThreadPool::parallelFor(size_t count, size_t min_chunk, const std::function<void(size_t begin, size_t end)>& fn) {
+    if(count == 0) {
+      return;
+    }
+
+    //a few chunks per thread so uneven chunks balance out
+    const size_t concurrency = getConcurrency();
+    const size_t chunk = std::max<size_t>(std::max<size_t>(min_chunk, 1), (count + concurrency * 4 - 1) / (concurrency * 4));
+    const size_t chunk_count = (count + chunk - 1) / chunk;
+    if(chunk_count == 1 || mWorkers.empty()) {
+      fn(0, count);
+      return;
+    }
+
+    struct Job {
+      std::atomic<size_t> next_chunk = 0;
+      size_t finished_helpers = 0;
+      std::mutex mutex;
+      std::condition_variable done;
+    } job;
+
+    auto runChunks = [&]() {
+      for(size_t index = job.next_chunk++; index < chunk_count; index = job.next_chunk++) {
+        const size_t begin = index * chunk;
+        fn(begin, std::min(begin + chunk, count));
+      }
+    };
+
+    //helpers touch the job on this stack frame, so return only once every helper is done with it
+    const size_t helpers = std::min(mWorkers.size(), chunk_count - 1);
+    {
+      std::lock_guard lock(mMutex);
+      for(size_t i = 0; i < helpers; i++) {
+        mTasks.emplace_back([&]() {
+          runChunks();
+          std::lock_guard job_lock(job.mutex);
+          job.finished_helpers++;
+          job.done.notify_all();
+        });
+        mPendingTasks++;
+      }
+    }
+    if(helpers == 1) {
+      mTaskAvailable.notify_one();
+    } else {
+      mTaskAvailable.notify_all();
+    }
+
+    runChunks();
+
+    std::unique_lock lock(job.mutex);
+    job.done.wait(lock, [&]() { return job.finished_helpers == helpers; });
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rp {
+  //Fixed set of worker threads for data parallel loops and independent tasks
+  class ThreadPool {
+  public:
+    //With no workers every task runs on the calling thread
+    explicit ThreadPool(size_t worker_count = GetDefaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //Workers plus the calling thread, which takes part in parallelFor
+    [[nodiscard]] size_t getConcurrency() const noexcept { return mWorkers.size() + 1; }
+
+    //Calls fn(begin, end) over chunks of [0, count) of at least min_chunk items and returns once all are done
+    void parallelFor(size_t count, size_t min_chunk, const std::function<void(size_t begin, size_t end)>& fn);
+
+    void submit(std::function<void()> task);
+
+    //Blocks until every submitted task has finished
+    void wait();
+
+    //One less than the hardware thread count, leaving a thread for the caller
+    [[nodiscard]] static size_t GetDefaultWorkerCount();
+
+  private:
+    void workerMain();
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mTaskAvailable;
+    std::condition_variable mTasksDone;
+    std::deque<std::function<void()>> mTasks;
+    size_t mPendingTasks = 0;
+    bool mStopping = false;
+  };
+}
@@ -1,5 +1,6 @@
 #include "pch.hpp"
 #include "util/uuid.hpp"
+#include "util/hash.hpp"
 
 namespace rp {
   constexpr std::array<uint8_t, 16> nil_uuid_data = {
@@ -40,4 +41,55 @@ namespace rp {
     
     return UUID(std::move(data));
   }
+
+  UUID UUID::FromName(std::string_view name) {
+    //version 8 is reserved for custom, implementation defined UUIDs
+    static constexpr uint8_t version_8_code = 0x80;
+    static constexpr uint8_t variant_1_code = 0x80;
+
+    const uint64_t hashes[2] = { hashString(name), hashString(name, hashString("rapier")) };
+
+    std::array<uint8_t, 16> data;
+    for (size_t i = 0; i < 16; i++) {
+      data[i] = static_cast<uint8_t>(hashes[i / 8] >> ((i % 8) * 8));
+    }
+
+    data[6] = (data[6] & 0x0F) | version_8_code;
+    data[8] = (data[8] & 0x3F) | variant_1_code;
+
+    return UUID(std::move(data));
+  }
+
+  std::optional<UUID> UUID::FromString(std::string_view str) {
+    static constexpr size_t uuid_string_length = 36;
+    if (str.length() != uuid_string_length) {
+      return std::nullopt;
+    }
+
+    auto hexValue = [](char c) -> int {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return -1;
+    };
+
+    std::array<uint8_t, 16> data;
+    size_t pos = 0;
+    for (size_t i = 0; i < 16; i++) {
+      if (i == 4 || i == 6 || i == 8 || i == 10) {
+        if (str[pos++] != '-') {
+          return std::nullopt;
+        }
+      }
+
+      int high = hexValue(str[pos++]);
+      int low = hexValue(str[pos++]);
+      if (high < 0 || low < 0) {
+        return std::nullopt;
+      }
+      data[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+
+    return UUID(std::move(data));
+  }
 }
\ No newline at end of file
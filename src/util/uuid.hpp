@@ -2,7 +2,9 @@
 
 #include <cstdint>
 #include <array>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace rp {
   //Universally Unique Identifier (UUID)
@@ -19,14 +21,27 @@ namespace rp {
     bool operator!=(const UUID& rhs) const {
       return !(*this == rhs);
     }
+    bool operator<(const UUID& rhs) const {
+      return mData < rhs.mData;
+    }
 
     [[nodiscard]] static UUID Generate();
 
+    //Deterministic UUID derived from a name, so the same name always maps to the same id
+    [[nodiscard]] static UUID FromName(std::string_view name);
+
+    //Parses the string format produced by to_string()
+    [[nodiscard]] static std::optional<UUID> FromString(std::string_view str);
+
     //UUID string format: xxxxxxxx-xxxx-Mxxx-Nxxx-xxxxxxxxxxxx
     [[nodiscard]] std::string to_string() const noexcept;
 
+    [[nodiscard]] const std::array<uint8_t, 16>& data() const noexcept {
+      return mData;
+    }
+
     static const UUID nil_uuid;
   private:
     std::array<uint8_t, 16> mData;
   };
-}
\ No newline at end of file
+}
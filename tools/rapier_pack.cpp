@@ -0,0 +1,153 @@
+// rapier_pack.cpp - Packs loose files into an asset archive (.rpak)
+//
+// usage: rapier_pack [options] <output.rpak> <inputs...>
+//   -c, --compress        LZ compress entries that shrink when compressed
+//   -a, --align <bytes>   payload alignment, a power of two (default 64)
+//   -r, --root <dir>      entry names are paths relative to this directory (default .)
+//   -m, --manifest <file> read inputs from a manifest, one "<path> [name] [uuid]" per line
+//
+// Directories are packed recursively. Entries without an explicit uuid get one
+// derived from their name, so repacking keeps ids stable.
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <rapier.hpp>
+#include <asset/archive_writer.hpp>
+
+namespace fs = std::filesystem;
+
+struct Input {
+  fs::path path;
+  std::string name;
+  std::optional<rp::UUID> id;
+};
+
+static void printUsage() {
+  rp::log::info("usage: rapier_pack [-c] [-a <bytes>] [-r <dir>] [-m <manifest>] <output.rpak> <inputs...>");
+}
+
+static std::vector<std::byte> readFile(const fs::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if(!file) {
+    throw std::runtime_error(fmt::format("Failed to open {}", path.string()));
+  }
+  std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  std::vector<std::byte> data(bytes.size());
+  std::transform(bytes.begin(), bytes.end(), data.begin(), [](char c) { return static_cast<std::byte>(c); });
+  return data;
+}
+
+static void addInput(std::vector<Input>& inputs, const fs::path& path, const fs::path& root) {
+  if(fs::is_directory(path)) {
+    for(const auto& dir_entry : fs::recursive_directory_iterator(path)) {
+      if(dir_entry.is_regular_file()) {
+        inputs.push_back({dir_entry.path(), fs::relative(dir_entry.path(), root).generic_string(), std::nullopt});
+      }
+    }
+  } else {
+    inputs.push_back({path, fs::relative(path, root).generic_string(), std::nullopt});
+  }
+}
+
+static void readManifest(std::vector<Input>& inputs, const fs::path& manifest_path, const fs::path& root) {
+  std::ifstream manifest(manifest_path);
+  if(!manifest) {
+    throw std::runtime_error(fmt::format("Failed to open manifest {}", manifest_path.string()));
+  }
+
+  std::string line;
+  size_t line_number = 0;
+  while(std::getline(manifest, line)) {
+    line_number++;
+    std::istringstream fields(line);
+    std::string path, name, uuid;
+    if(!(fields >> path) || path.front() == '#') {
+      continue;
+    }
+    fields >> name >> uuid;
+
+    Input input{root / path, name.empty() ? fs::path(path).generic_string() : name, std::nullopt};
+    if(!uuid.empty()) {
+      input.id = rp::UUID::FromString(uuid);
+      if(!input.id) {
+        throw std::runtime_error(fmt::format("{}:{}: invalid uuid {}", manifest_path.string(), line_number, uuid));
+      }
+    }
+    inputs.push_back(std::move(input));
+  }
+}
+
+int main(int argc, char** argv) {
+  rp::log::setClientPrefix("rapier_pack");
+
+  try {
+    auto compression = rp::asset::Compression::None;
+    uint32_t alignment = rp::asset::default_archive_alignment;
+    fs::path root = ".";
+    std::vector<fs::path> manifests;
+    std::vector<fs::path> positional;
+
+    for(int i = 1; i < argc; i++) {
+      std::string_view arg = argv[i];
+      auto nextValue = [&]() -> std::string_view {
+        if(i + 1 >= argc) {
+          throw std::runtime_error(fmt::format("{} expects a value", arg));
+        }
+        return argv[++i];
+      };
+
+      if(arg == "-c" || arg == "--compress") {
+        compression = rp::asset::Compression::LZ;
+      } else if(arg == "-a" || arg == "--align") {
+        alignment = static_cast<uint32_t>(std::stoul(std::string(nextValue())));
+      } else if(arg == "-r" || arg == "--root") {
+        root = nextValue();
+      } else if(arg == "-m" || arg == "--manifest") {
+        manifests.emplace_back(nextValue());
+      } else if(arg == "-h" || arg == "--help") {
+        printUsage();
+        return 0;
+      } else {
+        positional.emplace_back(arg);
+      }
+    }
+
+    if(positional.empty()) {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+
+    const fs::path output = positional.front();
+    std::vector<Input> inputs;
+    for(auto it = positional.begin() + 1; it != positional.end(); ++it) {
+      addInput(inputs, *it, root);
+    }
+    for(const auto& manifest : manifests) {
+      readManifest(inputs, manifest, root);
+    }
+
+    rp::asset::ArchiveWriter writer(alignment);
+    uint64_t total_size = 0;
+    for(const auto& input : inputs) {
+      auto data = readFile(input.path);
+      total_size += data.size();
+      writer.add(input.id.value_or(rp::UUID::FromName(input.name)), input.name, data, compression);
+    }
+
+    writer.write(output);
+    rp::log::info("Packed {} entries ({} bytes) into {} ({} bytes)",
+      writer.getEntryCount(), total_size, output.string(), fs::file_size(output));
+  } catch(std::exception& e) {
+    rp::log::error("{}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+// rapier_top.cpp - Shows the live metrics of a running rapier process
+//
+// usage: rapier_top [options] <pid>
+//   -i, --interval <ms>   refresh interval (default 1000)
+//   -n, --once            print one snapshot and exit
+//
+// Attaches read only to the process's shared metrics segment, so watching a game
+// costs it nothing. Counters are shown with their rate over the last interval,
+// histograms with their count, mean and approximate percentiles.
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rapier.hpp>
+#include <metrics/metrics_layout.hpp>
+#include <util/shared_memory.hpp>
+
+using namespace rp::metrics;
+
+struct Snapshot {
+  std::vector<MetricDescriptor> descriptors;
+  std::vector<uint64_t> values;
+  uint64_t heartbeat = 0;
+  std::chrono::steady_clock::time_point time;
+};
+
+static void printUsage() {
+  rp::log::info("usage: rapier_top [-i <ms>] [-n] <pid>");
+}
+
+static const SegmentHeader& validate(const rp::SharedMemory& segment) {
+  if(segment.size() < sizeof(SegmentHeader)) {
+    throw std::runtime_error("Metrics segment is too small!");
+  }
+  const auto& header = *reinterpret_cast<const SegmentHeader*>(segment.data().data());
+  //acquire pairs with the engine's release store, the rest of the header is valid once the magic is seen
+  if(header.magic.load(std::memory_order_acquire) != segment_magic) {
+    throw std::runtime_error("Metrics segment isn't initialized yet!");
+  }
+  if(header.layout_version != layout_version) {
+    throw std::runtime_error(fmt::format("Metrics layout version {} isn't supported, this rapier_top reads version {}", header.layout_version, layout_version));
+  }
+  if(header.segment_size > segment.size() || header.max_metrics != max_metrics || header.value_slots != value_slots ||
+     header.histogram_buckets != histogram_buckets) {
+    throw std::runtime_error("Metrics segment header doesn't match its layout version!");
+  }
+  return header;
+}
+
+static Snapshot takeSnapshot(const rp::SharedMemory& segment, const SegmentHeader& header) {
+  const auto* base = segment.data().data();
+  const auto* descriptors = reinterpret_cast<const MetricDescriptor*>(base + header.descriptors_offset);
+  const auto* values = reinterpret_cast<const std::atomic<uint64_t>*>(base + header.values_offset);
+
+  Snapshot snapshot;
+  snapshot.time = std::chrono::steady_clock::now();
+  snapshot.heartbeat = header.heartbeat.load(std::memory_order_relaxed);
+  const uint32_t count = std::min(header.metric_count.load(std::memory_order_acquire), max_metrics);
+  snapshot.descriptors.assign(descriptors, descriptors + count);
+  snapshot.values.resize(value_slots);
+  for(uint32_t i = 0; i < value_slots; i++) {
+    snapshot.values[i] = values[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+//Upper bound of the bucket holding the q-th quantile
+static uint64_t getPercentile(const uint64_t* buckets, uint64_t count, double q) {
+  const auto target = static_cast<uint64_t>(q * static_cast<double>(count));
+  uint64_t seen = 0;
+  for(uint32_t bucket = 0; bucket < histogram_buckets; bucket++) {
+    seen += buckets[bucket];
+    if(seen > target) {
+      return (bucket + 1 < histogram_buckets) ? getBucketFloor(bucket + 1) : getBucketFloor(bucket);
+    }
+  }
+  return 0;
+}
+
+static void printSnapshot(uint32_t pid, const Snapshot& current, const Snapshot* previous) {
+  const double seconds = previous ? std::chrono::duration<double>(current.time - previous->time).count() : 0.0;
+  const bool stalled = previous && current.heartbeat == previous->heartbeat;
+
+  fmt::print("rapier_top - pid {} - frame {}{}\n\n", pid, current.heartbeat, stalled ? " (stalled)" : "");
+  fmt::print("{:<40} {:>16} {:>14}\n", "metric", "value", "rate/s");
+  for(const auto& descriptor : current.descriptors) {
+    const std::string_view name(descriptor.name.data());
+    const uint64_t* value = &current.values[descriptor.value_index];
+    const uint64_t* last = previous ? &previous->values[descriptor.value_index] : nullptr;
+
+    switch(descriptor.kind) {
+      case Kind::Counter: {
+        const double rate = (last && seconds > 0.0) ? static_cast<double>(value[0] - last[0]) / seconds : 0.0;
+        fmt::print("{:<40} {:>16} {:>14.1f}\n", name, value[0], rate);
+        break;
+      }
+      case Kind::Gauge:
+        fmt::print("{:<40} {:>16.3f}\n", name, std::bit_cast<double>(value[0]));
+        break;
+      case Kind::Histogram: {
+        const uint64_t count = value[0];
+        const double mean = count ? static_cast<double>(value[1]) / static_cast<double>(count) : 0.0;
+        fmt::print("{:<40} {:>16} {:>14}   mean {:.1f}  p50 <{}  p99 <{}\n", name, count, "", mean,
+                   getPercentile(value + 2, count, 0.5), getPercentile(value + 2, count, 0.99));
+        break;
+      }
+    }
+  }
+  std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  try {
+    auto interval = std::chrono::milliseconds(1000);
+    bool once = false;
+    uint32_t pid = 0;
+
+    for(int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if(arg == "-n" || arg == "--once") {
+        once = true;
+      } else if((arg == "-i" || arg == "--interval") && i + 1 < argc) {
+        interval = std::chrono::milliseconds(std::max(std::atoi(argv[++i]), 10));
+      } else if(!arg.empty() && arg[0] != '-' && pid == 0) {
+        pid = static_cast<uint32_t>(std::strtoul(arg.c_str(), nullptr, 10));
+      } else {
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    }
+    if(pid == 0) {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+
+    const auto segment = rp::SharedMemory::Open(getSegmentName(pid));
+    const auto& header = validate(segment);
+
+    Snapshot previous = takeSnapshot(segment, header);
+    if(once) {
+      printSnapshot(pid, previous, nullptr);
+      return EXIT_SUCCESS;
+    }
+    while(true) {
+      std::this_thread::sleep_for(interval);
+      Snapshot current = takeSnapshot(segment, header);
+      //clears the console and homes the cursor
+      fmt::print("\x1b[2J\x1b[H");
+      printSnapshot(pid, current, &previous);
+      previous = std::move(current);
+    }
+  } catch(const std::exception& e) {
+    rp::log::error("{}", e.what());
+    return EXIT_FAILURE;
+  }
+}